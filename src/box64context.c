@@ -146,23 +146,6 @@ static void atfork_child_box64context(void)
     init_mutexes(my_context);
 }
 
-void freeCycleLog(box64context_t* ctx)
-{
-    if(BOX64ENV(rolling_log)) {
-        box_free(ctx->log_call);
-        box_free(ctx->log_ret);
-        ctx->log_call = NULL;
-        ctx->log_ret = NULL;
-    }
-}
-void initCycleLog(box64context_t* context)
-{
-    if(context && BOX64ENV(rolling_log)) {
-        context->log_call = (char*)box_calloc(BOX64ENV(rolling_log), 256*sizeof(char));
-        context->log_ret = (char*)box_calloc(BOX64ENV(rolling_log), 128*sizeof(char));
-    }
-}
-
 EXPORTDYN
 box64context_t *NewBox64Context(int argc)
 {
@@ -175,8 +158,6 @@ box64context_t *NewBox64Context(int argc)
     // init and put default values
     box64context_t *context = my_context = (box64context_t*)box_calloc(1, sizeof(box64context_t));
 
-    initCycleLog(context);
-
     context->deferredInit = 1;
     context->sel_serial = 1;
 
@@ -365,8 +346,6 @@ void FreeBox64Context(box64context_t** context)
     pthread_mutex_destroy(&ctx->mutex_bridge);
 #endif
 
-    freeCycleLog(ctx);
-
     box_free(ctx);
 }
 
@@ -49,6 +49,7 @@
 #include "cleanup.h"
 #include "freq.h"
 #include "hostext.h"
+#include "stats.h"
 
 box64context_t *my_context = NULL;
 extern box64env_t box64env;
@@ -246,6 +247,19 @@ static void displayMiscInfo()
         printf_log(LOG_INFO, "Minimum CPU requirements not met, disabling DynaRec\n");
         SET_BOX64ENV(dynarec, 0);
     }
+    // SHA_NI is only worth exposing if the DynaRec can translate it inline (native crypto instructions, or LSX on LA64)
+    // otherwise, let the guest use its SSE/AVX implementation
+#if defined(ARM64)
+    int native_sha = cpuext.sha1 && cpuext.sha2;
+#elif defined(LA64)
+    int native_sha = 1; // inline LSX translation, LSX is always there
+#else
+    int native_sha = 0;
+#endif
+    if (BOX64ENV(dynarec) && !box64env.is_shaext_overridden && !native_sha) {
+        printf_log(LOG_INFO, "No native SHA support, not exposing SHAEXT\n");
+        SET_BOX64ENV(shaext, 0);
+    }
 #endif
 
     // grab ncpu and cpu name
@@ -686,6 +700,8 @@ void endBox64()
     endMallocHook();
     #endif
     SerializeAllMapping();   // to be safe
+    if(BOX64ENV(stats))
+        DumpStats(0);
     FreeBox64Context(&my_context);
     #ifdef DYNAREC
     // disable dynarec now
@@ -1053,6 +1069,7 @@ int initialize(int argc, const char **argv, char** env, x64emu_t** emulator, elf
     openFTrace(0);
     setupZydis(my_context);
     PrintEnvVariables(&box64env, LOG_INFO);
+    InitStats();
 
     for(int i=1; i<my_context->argc; ++i) {
         my_context->argv[i] = box_strdup(argv[i+nextarg]);
@@ -91,6 +91,11 @@ typedef struct blocklist_s {
     uint32_t            lowest;
     uint8_t             type;       // could use 7bits for type and 1bit fot is32bits,
     uint8_t             is32bits;   // but that wont really change the size of structure anyway
+    uint8_t             hot;        // dynarec chunks only: reserved to blocks with a loop
+    // dynarec chunks only: sorted offsets (from block) of the allocated blockmarks
+    uint32_t*           index;
+    uint32_t            index_size;
+    uint32_t            index_cap;
 } blocklist_t;
 
 #define MMAPSIZE (512*1024)     // allocate 512kb sized blocks
@@ -1209,6 +1214,62 @@ typedef struct mmaplist_s {
     int             dirty;
 } mmaplist_t;
 
+// The index is only modified with the dynarec allocation, but read without lock (from signal handlers)
+// so the pointer is published before the size, and the result is always checked against the blockmarks.
+// The arrays come from customMalloc, so a stale one is still readable.
+static void DynIndexAdd(blocklist_t* bl, void* sub)
+{
+    uint32_t off = (uintptr_t)sub - (uintptr_t)bl->block;
+    uint32_t n = bl->index_size;
+    if(n==bl->index_cap) {
+        uint32_t cap = n?(n*2):64;
+        uint32_t* idx = customMalloc(cap*sizeof(uint32_t));
+        if(!idx)
+            return;
+        if(n)
+            memcpy(idx, bl->index, n*sizeof(uint32_t));
+        uint32_t* old = bl->index;
+        __atomic_store_n(&bl->index, idx, __ATOMIC_RELEASE);
+        bl->index_cap = cap;
+        if(old)
+            customFree(old);
+    }
+    uint32_t i = n;
+    while(i && bl->index[i-1]>off) {
+        bl->index[i] = bl->index[i-1];
+        --i;
+    }
+    bl->index[i] = off;
+    __atomic_store_n(&bl->index_size, n+1, __ATOMIC_RELEASE);
+}
+
+static void DynIndexDel(blocklist_t* bl, void* sub)
+{
+    uint32_t off = (uintptr_t)sub - (uintptr_t)bl->block;
+    uint32_t n = bl->index_size;
+    uint32_t lo = 0, hi = n;
+    while(lo<hi) {
+        uint32_t mid = (lo+hi)/2;
+        if(bl->index[mid]<off)
+            lo = mid+1;
+        else
+            hi = mid;
+    }
+    uint32_t i = lo;
+    if(i==n || bl->index[i]!=off)
+        return;
+    __atomic_store_n(&bl->index_size, n-1, __ATOMIC_RELEASE);
+    memmove(bl->index+i, bl->index+i+1, (n-i-1)*sizeof(uint32_t));
+}
+
+static void DynIndexFree(blocklist_t* bl)
+{
+    if(bl->index)
+        customFree(bl->index);
+    bl->index = NULL;
+    bl->index_size = bl->index_cap = 0;
+}
+
 mmaplist_t* NewMmaplist()
 {
     return (mmaplist_t*)box_calloc(1, sizeof(mmaplist_t));
@@ -1302,11 +1363,15 @@ int MmaplistAddBlock(mmaplist_t* list, int fd, off_t offset, void* orig, size_t
         list->chunks[i]->block = ((void*)list->chunks[i]->block) + delta;
         list->chunks[i]->first += delta;
     }
+    // the index is rebuilt with the blocks
+    list->chunks[i]->index = NULL;
+    list->chunks[i]->index_size = list->chunks[i]->index_cap = 0;
     // relocate all allocated dynablocks
     void* p = list->chunks[i]->block;
     void* end = map + size - sizeof(blockmark_t);
     while(p<end) {
         if(((blockmark_t*)p)->next.fill) {
+            DynIndexAdd(list->chunks[i], p);
             void** b = (void**)((blockmark_t*)p)->mark;
             // first is the address of the dynablock itself, that needs to be adjusted
             b[0] += delta;
@@ -1316,6 +1381,7 @@ int MmaplistAddBlock(mmaplist_t* list, int fd, off_t offset, void* orig, size_t
             GO(block);
             GO(actual_block);
             GO(instsize);
+            GO(instcheck);
             GO(arch);
             GO(callrets);
             GO(jmpnext);
@@ -1334,18 +1400,21 @@ int MmaplistAddBlock(mmaplist_t* list, int fd, off_t offset, void* orig, size_t
             if(bl->relocs && bl->relocsize)
                 ApplyRelocs(bl, delta, delta_map, mapping_start);
             ClearCache(bl->actual_block+sizeof(void*), bl->native_size);
+            markCodeChunks((uintptr_t)bl->x64_addr, bl->hash_size);
+            if(bl->weakmem)
+                DynablockSetWeakmem();
             //add block, as dirty for now
             if(!addJumpTableIfDefault64(bl->x64_addr, bl->jmpnext)) {
                 // cannot add blocks?
                 printf_log(LOG_INFO, "Warning, cannot add DynaCache Block %d to JmpTable\n", i);
             } else {
-                if(bl->x64_size) {
+                if(bl->hash_size) {
                     dynarec_log(LOG_DEBUG, "Added DynCache bl %p for %p - %p\n", bl, bl->x64_addr, bl->x64_addr+bl->x64_size);
-                    if(bl->x64_size>my_context->max_db_size) {
-                        my_context->max_db_size = bl->x64_size;
+                    if(bl->hash_size>my_context->max_db_size) {
+                        my_context->max_db_size = bl->hash_size;
                         dynarec_log(LOG_INFO, "BOX64 Dynarec: higher max_db=%d\n", my_context->max_db_size);
                     }
-                    rb_inc(my_context->db_sizes, bl->x64_size, bl->x64_size+1);
+                    rb_inc(my_context->db_sizes, bl->hash_size, bl->hash_size+1);
                 }
             }
 
@@ -1373,6 +1442,7 @@ void DelMmaplist(mmaplist_t* list)
     if(!list) return;
     for(int i=0; i<list->size; ++i)
         if(list->chunks[i]->size) {
+            DynIndexFree(list->chunks[i]);  // no need to maintain it while the blocks are freed
             cleanDBFromAddressRange((uintptr_t)list->chunks[i]->block, list->chunks[i]->size, 1);
             rb_unset(rbt_dynmem, (uintptr_t)list->chunks[i]->block, (uintptr_t)list->chunks[i]->block+list->chunks[i]->size);
             // the blocklist_t "chunk" structure is port of the memory map, so grab info before freing the memory
@@ -1401,6 +1471,22 @@ dynablock_t* FindDynablockFromNativeAddress(void* p)
 
     blocklist_t* bl = (blocklist_t*)rb_get_64(rbt_dynmem, addr);
     if(bl) {
+        // binary search of the last block starting before addr
+        uint32_t n = __atomic_load_n(&bl->index_size, __ATOMIC_ACQUIRE);
+        uint32_t* idx = __atomic_load_n(&bl->index, __ATOMIC_ACQUIRE);
+        if(n && idx && (uintptr_t)bl->block+idx[0]<addr) {
+            uint32_t lo = 0, hi = n;
+            while(hi-lo>1) {
+                uint32_t mid = (lo+hi)/2;
+                if((uintptr_t)bl->block+idx[mid]<addr)
+                    lo = mid;
+                else
+                    hi = mid;
+            }
+            blockmark_t* sub = (blockmark_t*)((uintptr_t)bl->block+idx[lo]);
+            if(((uintptr_t)sub<addr) && ((uintptr_t)sub<(uintptr_t)bl->block+bl->size) && sub->next.fill && ((uintptr_t)NEXT_BLOCK(sub)>addr))
+                return *(dynablock_t**)((uintptr_t)sub+sizeof(blockmark_t));
+        }
         // browse the map allocation as a fallback
         blockmark_t* sub = (blockmark_t*)bl->block;
         while((uintptr_t)sub<addr) {
@@ -1421,7 +1507,7 @@ dynablock_t* FindDynablockFromNativeAddress(void* p)
 #ifdef TRACE_MEMSTAT
 static uint64_t dynarec_allocated = 0;
 #endif
-uintptr_t AllocDynarecMap(uintptr_t x64_addr, size_t size, int is_new)
+uintptr_t AllocDynarecMap(uintptr_t x64_addr, size_t size, int is_new, int hot)
 {
     if(!size)
         return 0;
@@ -1438,7 +1524,12 @@ uintptr_t AllocDynarecMap(uintptr_t x64_addr, size_t size, int is_new)
     // check if there is space in current open ones
     int idx = 0;
     uintptr_t sz = size + 2*sizeof(blockmark_t);
-    for(int i=0; i<list->size; ++i)
+    // hot blocks get their own chunks, so they are not interleaved with code that runs only once
+    int first = 1;
+    for(int i=0; i<list->size; ++i) {
+        if(list->chunks[i]->hot!=hot)
+            continue;
+        first = 0;
         if(list->chunks[i]->maxfree>=size) {
             // looks free, try to alloc!
             size_t rsize = 0;
@@ -1447,10 +1538,11 @@ uintptr_t AllocDynarecMap(uintptr_t x64_addr, size_t size, int is_new)
                 void* ret = allocBlock(list->chunks[i]->block, sub, size, &list->chunks[i]->first);
                 if(rsize==list->chunks[i]->maxfree)
                     list->chunks[i]->maxfree = getMaxFreeBlock(list->chunks[i]->block, list->chunks[i]->size, list->chunks[i]->first);
-                //rb_set_64(list->chunks[i].tree, (uintptr_t)ret, (uintptr_t)ret+size, (uintptr_t)ret);
+                DynIndexAdd(list->chunks[i], sub);
                 return (uintptr_t)ret;
             }
         }
+    }
     // need to add a new
     if(list->size == list->cap) {
         list->cap+=4;
@@ -1459,7 +1551,7 @@ uintptr_t AllocDynarecMap(uintptr_t x64_addr, size_t size, int is_new)
     int i = list->size++;
     size_t need_sz = sz + sizeof(blocklist_t);
     // alloc a new block, aversized or not, we are at the end of the list
-    size_t allocsize = (need_sz>(i?DYNMMAPSZ:DYNMMAPSZ0))?need_sz:(i?DYNMMAPSZ:DYNMMAPSZ0);
+    size_t allocsize = (need_sz>(first?DYNMMAPSZ0:DYNMMAPSZ))?need_sz:(first?DYNMMAPSZ0:DYNMMAPSZ);
     // allign sz with pagesize
     allocsize = (allocsize+(box64_pagesize-1))&~(box64_pagesize-1);
     void* p=MAP_FAILED;
@@ -1498,6 +1590,9 @@ uintptr_t AllocDynarecMap(uintptr_t x64_addr, size_t size, int is_new)
     list->chunks[i]->block = p;
     list->chunks[i]->first = p;
     list->chunks[i]->size = allocsize;
+    list->chunks[i]->hot = hot;
+    list->chunks[i]->index = NULL;
+    list->chunks[i]->index_size = list->chunks[i]->index_cap = 0;
     // setup marks
     blockmark_t* m = (blockmark_t*)p;
     m->prev.x32 = 0;
@@ -1511,7 +1606,7 @@ uintptr_t AllocDynarecMap(uintptr_t x64_addr, size_t size, int is_new)
     list->chunks[i]->maxfree = getMaxFreeBlock(list->chunks[i]->block, list->chunks[i]->size, list->chunks[i]->first);
     if(list->chunks[i]->maxfree)
         list->chunks[i]->first = getNextFreeBlock(m);
-    //rb_set_64(list->chunks[i].tree, (uintptr_t)ret, (uintptr_t)ret+size, (uintptr_t)ret);
+    DynIndexAdd(list->chunks[i], m);
     return (uintptr_t)ret;
 }
 
@@ -1525,6 +1620,7 @@ void FreeDynarecMap(uintptr_t addr)
 
     if(bl) {
         void* sub = (void*)(addr-sizeof(blockmark_t));
+        DynIndexDel(bl, sub);
         size_t newfree = freeBlock(bl->block, bl->size, sub, &bl->first);
         if(bl->maxfree < newfree)
             bl->maxfree = newfree;
@@ -1577,6 +1673,20 @@ static uintptr_t getDBSize(uintptr_t addr, size_t maxsize, dynablock_t** db)
     return (addr&~JMPTABLE_MASK0)+idx0+1;
 }
 
+void markWeakmemDB(void)
+{
+    // mark all the blocks built without strongmem barriers as dirty, they will be rebuilt on next run
+    dynarec_log(LOG_DEBUG, "markWeakmemDB\n");
+    uintptr_t addr = 0, prev;
+    dynablock_t* db = NULL;
+    do {
+        prev = addr;
+        addr = getDBSize(addr, ~(uintptr_t)0-addr, &db);
+        if(db && db->weakmem)
+            MarkDynablock(db);
+    } while(addr>prev);
+}
+
 // each dynmap is 64k of size
 
 void addDBFromAddressRange(uintptr_t addr, size_t size)
@@ -1915,6 +2025,51 @@ uintptr_t getJumpAddress64(uintptr_t addr)
     #endif
 }
 
+// Write tracking of PROT_DYNAREC pages: mprotect (and SIGSEGV) or userfaultfd write-protect (and a tracker thread)
+static int uffd_tracking = 0;
+// write-protect a range, return PROT_UFFD if userfaultfd was used
+static uint32_t writeProtectDB(uintptr_t addr, size_t size, uint32_t prot)
+{
+    if(uffd_tracking && !UffdWriteProtect(addr, size, 1))
+        return PROT_UFFD;
+    mprotect((void*)addr, size, prot&~(PROT_WRITE|PROT_CUSTOM));
+    return 0;
+}
+// lift write-protection of a range, with the method used to protect it
+static void writeUnprotectDB(uintptr_t addr, size_t size, uint32_t oprot, uint32_t prot)
+{
+    if(oprot&PROT_UFFD)
+        UffdWriteProtect(addr, size, 0);
+    else
+        mprotect((void*)addr, size, prot&~PROT_CUSTOM);
+}
+// write fault reported by the userfaultfd tracker thread
+#define UFFD_WRITE_MAX  32
+static void uffdWriteFault(uintptr_t addr)
+{
+    uintptr_t page = addr&~(box64_pagesize-1);
+    LOCK_PROT();
+    uint32_t prot = rb_get(memprot, page);
+    if((prot&(PROT_DYNAREC|PROT_UFFD))!=(PROT_DYNAREC|PROT_UFFD)) {
+        // left over write-protection, nothing to track anymore
+        UffdWriteProtect(page, box64_pagesize, 0);
+        prot = 0;
+    } else if(hasCodeChunks(addr, UFFD_WRITE_MAX)) {
+        // translated code is written: switch the page to mprotect, so the writer goes through
+        // the SIGSEGV handler that can get out of a running block if needed
+        mprotect((void*)page, box64_pagesize, prot&~(PROT_WRITE|PROT_CUSTOM));
+        rb_set(memprot, page, page+box64_pagesize, prot&~PROT_UFFD);
+        UffdWriteProtect(page, box64_pagesize, 0);
+        prot = 0;
+    }
+    UNLOCK_PROT();
+    if(prot) {
+        // only data is written, unprotect like the SIGSEGV handler would
+        unprotectDB(addr, 1, 1);
+        CheckHotPage(addr, prot);
+    }
+}
+
 // Remove the Write flag from an adress range, so DB can be executed safely
 void protectDBJumpTable(uintptr_t addr, size_t size, void* jump, void* ref)
 {
@@ -1935,11 +2090,12 @@ void protectDBJumpTable(uintptr_t addr, size_t size, void* jump, void* ref)
         if(!prot)
             prot = PROT_READ | PROT_WRITE | PROT_EXEC;
         if(!(dyn&PROT_NEVERPROT)) {
+            uint32_t uffd = dyn&PROT_UFFD;
             prot&=~PROT_CUSTOM;
             if(prot&PROT_WRITE) {
                 if(!dyn) 
-                    mprotect((void*)cur, bend-cur, prot&~PROT_WRITE);
-                prot |= PROT_DYNAREC;
+                    uffd = writeProtectDB(cur, bend-cur, prot);
+                prot |= PROT_DYNAREC|uffd;
             } else 
                 prot |= PROT_DYNAREC_R;
         }
@@ -1972,11 +2128,12 @@ void protectDB(uintptr_t addr, uintptr_t size)
         if(!prot)
             prot = PROT_READ | PROT_WRITE | PROT_EXEC;
         if(!(dyn&PROT_NEVERPROT)) {
+            uint32_t uffd = dyn&PROT_UFFD;
             prot&=~PROT_CUSTOM;
             if(prot&PROT_WRITE) {
                 if(!dyn) 
-                    mprotect((void*)cur, bend-cur, prot&~PROT_WRITE);
-                prot |= PROT_DYNAREC;
+                    uffd = writeProtectDB(cur, bend-cur, prot);
+                prot |= PROT_DYNAREC|uffd;
             } else 
                 prot |= PROT_DYNAREC_R;
         }
@@ -2014,7 +2171,7 @@ void unprotectDB(uintptr_t addr, size_t size, int mark)
                 prot&=~PROT_DYN;
                 if(mark)
                     cleanDBFromAddressRange(cur, bend-cur, 0);
-                mprotect((void*)cur, bend-cur, prot);
+                writeUnprotectDB(cur, bend-cur, oprot, prot);
             } else if(prot&PROT_DYNAREC_R) {
                 if(mark)
                     cleanDBFromAddressRange(cur, bend-cur, 0);
@@ -2054,7 +2211,7 @@ void neverprotectDB(uintptr_t addr, size_t size, int mark)
                 prot&=~PROT_DYN;
                 if(mark)
                     cleanDBFromAddressRange(cur, bend-cur, 0);
-                mprotect((void*)cur, bend-cur, prot);
+                writeUnprotectDB(cur, bend-cur, oprot, prot);
             } else if(prot&PROT_DYNAREC_R) {
                 if(mark)
                     cleanDBFromAddressRange(cur, bend-cur, 0);
@@ -2121,63 +2278,213 @@ int isprotectedDB(uintptr_t addr, size_t size)
     return 1;
 }
 
+// Sub-page tracking of code: 1 bit per 64 bytes chunk of a 4K page that has (or had) some dynablock code in it
+// 3 levels of 12bits indexed by the page number, the last level is one 64bits bitmap per page
+#define CODECHUNK_L     12
+#define CODECHUNK_MASK  ((1<<CODECHUNK_L)-1)
+static uint64_t** codechunks[1<<CODECHUNK_L] = {0};
+static uint64_t* getCodeChunks(uintptr_t page, int create)
+{
+    uint64_t*** l2 = &codechunks[(page>>(2*CODECHUNK_L))&CODECHUNK_MASK];
+    if(!*l2) {
+        if(!create)
+            return NULL;
+        uint64_t** tbl = (uint64_t**)customCalloc(1<<CODECHUNK_L, sizeof(uint64_t*));
+        if(native_lock_storeifnull(l2, tbl))
+            customFree(tbl);
+    }
+    uint64_t** l1 = &(*l2)[(page>>CODECHUNK_L)&CODECHUNK_MASK];
+    if(!*l1) {
+        if(!create)
+            return NULL;
+        uint64_t* tbl = (uint64_t*)customCalloc(1<<CODECHUNK_L, sizeof(uint64_t));
+        if(native_lock_storeifnull(l1, tbl))
+            customFree(tbl);
+    }
+    return &(*l1)[page&CODECHUNK_MASK];
+}
+static uint64_t codeChunksMask(uintptr_t addr, uintptr_t end)
+{
+    // addr and end are inside the same 4K page (end is exclusive, can be the start of next page)
+    int first = (addr&0xfff)>>CODECHUNK_SHIFT;
+    int last = ((end-1)&0xfff)>>CODECHUNK_SHIFT;
+    return ((last==63)?~0ULL:((1ULL<<(last+1))-1)) & ~((1ULL<<first)-1);
+}
+void markCodeChunks(uintptr_t addr, size_t size)
+{
+    if(!size || addr+size>0x1000000000000LL)
+        return;
+    uintptr_t end = addr+size;
+    while(addr<end) {
+        uintptr_t pend = (addr&~0xfffLL)+0x1000;
+        if(pend>end) pend = end;
+        uint64_t mask = codeChunksMask(addr, pend);
+        uint64_t* bitmap = getCodeChunks(addr>>12, 1);
+        uint64_t old;
+        do {
+            old = *bitmap;
+            if((old&mask)==mask)
+                break;
+        } while(native_lock_storeifref(bitmap, (void*)(old|mask), (void*)old)!=(void*)(old|mask));
+        addr = pend;
+    }
+}
+int hasCodeChunks(uintptr_t addr, size_t size)
+{
+    if(!size)
+        return 0;
+    if(addr+size>0x1000000000000LL)
+        return 1;
+    uintptr_t end = addr+size;
+    while(addr<end) {
+        uintptr_t pend = (addr&~0xfffLL)+0x1000;
+        if(pend>end) pend = end;
+        uint64_t* bitmap = getCodeChunks(addr>>12, 0);
+        if(bitmap && (*bitmap&codeChunksMask(addr, pend)))
+            return 1;
+        addr = pend;
+    }
+    return 0;
+}
+
+// Do a store on a protected dynarec page, with the page temporarily writable. The prot lock is held for the whole window,
+// so protection cannot change meanwhile, and the chunks with code are compared before / after the store to also catch
+// writes from other threads during the window. Return 0 if the store was not done (page not protected anymore...)
+static uint8_t storeprot_snap[65536];   // protected by mutex_prot
+int storeProtectedDB(uintptr_t addr, int(*store)(void*), void* data)
+{
+    if(box64_pagesize>sizeof(storeprot_snap))
+        return 0;
+    uintptr_t page = addr&~(box64_pagesize-1);
+    int ret = 0;
+    LOCK_PROT();
+    uint32_t prot = 0;
+    uintptr_t bend = 0;
+    rb_get_end(memprot, page, &prot, &bend);
+    if(!(prot&PROT_DYNAREC) || (prot&(PROT_NEVERPROT|PROT_UFFD))) {
+        UNLOCK_PROT();
+        return 0;
+    }
+    uint64_t masks[sizeof(storeprot_snap)>>12];
+    for(uintptr_t p=page; p<page+box64_pagesize; p+=0x1000) {
+        uint64_t* bitmap = getCodeChunks(p>>12, 0);
+        masks[(p-page)>>12] = bitmap?*bitmap:0;
+        if(masks[(p-page)>>12])
+            memcpy(storeprot_snap+(p-page), (void*)p, 0x1000);
+    }
+    if(!mprotect((void*)page, box64_pagesize, (prot&~PROT_CUSTOM)|PROT_WRITE)) {
+        ret = store(data);
+        mprotect((void*)page, box64_pagesize, prot&~PROT_CUSTOM);
+        for(uintptr_t p=page; p<page+box64_pagesize; p+=0x1000) {
+            uint64_t mask = masks[(p-page)>>12];
+            for(int i=0; mask; ++i, mask>>=1)
+                if((mask&1) && memcmp(storeprot_snap+(p-page)+(i<<CODECHUNK_SHIFT), (void*)(p+(i<<CODECHUNK_SHIFT)), 1<<CODECHUNK_SHIFT))
+                    cleanDBFromAddressRange(p+(i<<CODECHUNK_SHIFT), 1<<CODECHUNK_SHIFT, 0);
+        }
+    }
+    UNLOCK_PROT();
+    return ret;
+}
+
+// HotPages are pages that hold code but are also written often.
+// Each page gets a slot in a small hashed table, with a write counter that decays over time
+//  - a page that is written a few times in a short period is "hot": block from that page are not run for a while
+//  - a page that stays hot is promoted to NEVERCLEAN: no more write protection, but blocks are always tested
+//  - a promoted page that cools off (no more code changes detected) is demoted back to normal protection
+// All updates of a slot are done with a CAS on the whole 64bits entry.
 typedef union hotpage_s {
     struct {
-        uint64_t    addr:36;
-        uint64_t    cnt:28;
+        uint64_t    addr:36;    // page number
+        uint64_t    cnt:16;     // hot countdown (or quiet countdown for promoted page)
+        uint64_t    writes:7;   // decaying write counter
+        uint64_t    epoch:4;    // epoch of last decay of writes
+        uint64_t    never:1;    // page has been promoted to NEVERCLEAN
     };
     uint64_t    x;
 } hotpage_t;
-#define HOTPAGE_MAX ((1<<28)-1)
-#define N_HOTPAGE   16
-#define HOTPAGE_MARK 64
-#define HOTPAGE_DIRTY 1024
+#define HOTPAGE_BITS        10
+#define N_HOTPAGE           (1<<HOTPAGE_BITS)
+#define HOTPAGE_PROBE       8       // max number of slots probed for a page
+#define HOTPAGE_MARK        64
+#define HOTPAGE_DIRTY       1024
+#define HOTPAGE_QUIET       4096    // lookups without code change before a promoted page can be demoted
+#define HOTPAGE_WRITES_MAX  127
+#define HOTPAGE_HOT         2       // writes needed to consider a page as hot
+#define HOTPAGE_PROMOTE     16      // writes needed to promote a page to NEVERCLEAN (when BOX64_DYNAREC_DIRTY<2)
+#define HOTPAGE_EPOCH_SHIFT 8       // 1 epoch every 256 hotpage events
 static hotpage_t hotpage[N_HOTPAGE] = {0};
-void SetHotPage(int idx, uintptr_t page)
+static uint32_t hotpage_ticks = 0;  // not atomic, a lost tick only delays the decay
+
+static inline uint32_t HotPageHash(uintptr_t page)
 {
-    hotpage_t tmp = hotpage[idx];
-    tmp.addr = page;
-    tmp.cnt = BOX64ENV(dynarec_dirty)?HOTPAGE_DIRTY:HOTPAGE_MARK;
-    //TODO: use Atomics to update hotpage?
-    native_lock_store_dd(hotpage+idx, tmp.x);
+    return (uint32_t)((page*0x9E3779B97F4A7C15ULL)>>(64-HOTPAGE_BITS));
 }
-int IdxHotPage(uintptr_t page)
+static inline uint32_t HotPageTick()
 {
-    for(int i=0; i<N_HOTPAGE; ++i)
-        if(hotpage[i].addr == page)
-            return i;
-    return -1;
+    return ((++hotpage_ticks)>>HOTPAGE_EPOCH_SHIFT)&15;
 }
-void CancelHotPage(uintptr_t page)
+static inline hotpage_t HotPageDecay(hotpage_t hp, uint32_t epoch)
 {
-    unneverprotectDB(page<<12, box64_pagesize);
+    uint32_t delta = (epoch-hp.epoch)&15;
+    if(delta) {
+        hp.writes = (delta>=7)?0:(hp.writes>>delta);
+        hp.epoch = epoch;
+    }
+    return hp;
 }
-int IdxOldestHotPage(uintptr_t page)
+// return 1 if the slot has been updated from old to new
+static inline int HotPageCAS(int idx, hotpage_t old, hotpage_t new)
 {
+    return (native_lock_storeifref(&hotpage[idx].x, (void*)new.x, (void*)old.x)==(void*)new.x)?1:0;
+}
+static int IdxHotPage(uintptr_t page)
+{
+    uint32_t h = HotPageHash(page);
+    for(int i=0; i<HOTPAGE_PROBE; ++i) {
+        int idx = (h+i)&(N_HOTPAGE-1);
+        hotpage_t hp = hotpage[idx];
+        if(hp.x && hp.addr==page)
+            return idx;
+    }
+    return -1;
+}
+// find a free or cold slot for a new page, and record a 1st write. Promoted pages are never evicted
+static void AddHotPage(uintptr_t page, uint32_t epoch)
+{
+    uint32_t h = HotPageHash(page);
     int best_idx = -1;
-    uint32_t best_cnt = HOTPAGE_MAX+1;
-    // to reset hotpage with new value...
-    hotpage_t tmp;
-    tmp.addr = page;
-    tmp.cnt = HOTPAGE_MAX;
-    for(int i=0; i<N_HOTPAGE; ++i) {
-        if(!hotpage[i].cnt) {
-            native_lock_store_dd(hotpage+i, tmp.x);
-            return i;
+    hotpage_t best = {0};
+    uint32_t best_writes = HOTPAGE_WRITES_MAX+1;
+    for(int i=0; i<HOTPAGE_PROBE; ++i) {
+        int idx = (h+i)&(N_HOTPAGE-1);
+        hotpage_t hp = hotpage[idx];
+        if(!hp.x) {
+            best_idx = idx;
+            best = hp;
+            break;
         }
-        uint32_t cnt = hotpage[i].cnt;
-        if(cnt==HOTPAGE_MAX) cnt = 0;
-        if(cnt < best_cnt) {
-            best_idx = i;
-            best_cnt = cnt;
+        if(hp.never || hp.cnt)
+            continue;
+        uint32_t writes = HotPageDecay(hp, epoch).writes;
+        if(writes<best_writes) {
+            best_idx = idx;
+            best = hp;
+            best_writes = writes;
         }
     }
-    hotpage_t old = hotpage[best_idx];
-    native_lock_store_dd(hotpage+best_idx, tmp.x);
-    if(old.cnt && old.cnt!=HOTPAGE_MAX && BOX64ENV(dynarec_dirty)==1)
-        CancelHotPage(old.addr);
-    return best_idx;
+    if(best_idx==-1)
+        return; // all slots are busy with hot pages, will try again on next write
+    hotpage_t hp = {0};
+    hp.addr = page;
+    hp.writes = 1;
+    hp.epoch = epoch;
+    HotPageCAS(best_idx, best, hp); // if it fails, another thread took the slot, not a problem
+}
+static void CancelHotPage(uintptr_t page)
+{
+    unneverprotectDB(page<<12, box64_pagesize);
 }
+// a write fault happened on a protected page
 void CheckHotPage(uintptr_t addr, uint32_t prot)
 {
     if(addr>=0x1000000000000LL) // more than 48bits
@@ -2185,43 +2492,104 @@ void CheckHotPage(uintptr_t addr, uint32_t prot)
     if(prot&PROT_NEVERCLEAN && BOX64ENV(dynarec_dirty)==2)
         return;
     uintptr_t page = addr>>12;
-    // look for idx
-    int idx = IdxHotPage(page);
-    if(idx==-1) { IdxOldestHotPage(page); return; }
-    hotpage_t hp = hotpage[idx];
-    /*if(hp.cnt==HOTPAGE_MAX)*/ {
-        if(BOX64ENV(dynarec_dirty)>1) {
-            dynarec_log(LOG_INFO, "Detecting a Hotpage at %p (idx=%d), marking page as NEVERCLEAN\n", (void*)(page<<12), idx);
-            neverprotectDB(page<<12, box64_pagesize, 1);
-            hp.cnt = 0;
-            native_lock_store_dd(hotpage+idx, hp.x);  // free slot
-        } else {
-            dynarec_log(LOG_INFO, "Detecting a Hotpage at %p (idx=%d)\n", (void*)(page<<12), idx);
-            SetHotPage(idx, page);
+    uint32_t epoch = HotPageTick();
+    uint32_t promote_level = (BOX64ENV(dynarec_dirty)>1)?HOTPAGE_HOT:HOTPAGE_PROMOTE;
+    int idx, promote;
+    hotpage_t old, hp;
+    while(1) {
+        idx = IdxHotPage(page);
+        if(idx==-1) {
+            AddHotPage(page, epoch);
+            return;
         }
-    }
+        old = hotpage[idx];
+        if(old.addr!=page)
+            continue;   // slot has been recycled in the meantime
+        hp = HotPageDecay(old, epoch);
+        if(hp.writes<HOTPAGE_WRITES_MAX)
+            ++hp.writes;
+        promote = (!hp.never && hp.writes>=promote_level);
+        if(promote) {
+            hp.never = 1;
+            hp.cnt = HOTPAGE_QUIET;
+        } else if(!hp.never && hp.writes>=HOTPAGE_HOT)
+            hp.cnt = BOX64ENV(dynarec_dirty)?HOTPAGE_DIRTY:HOTPAGE_MARK;
+        if(HotPageCAS(idx, old, hp))
+            break;
+    }
+    if(promote) {
+        dynarec_log(LOG_INFO, "Detecting a Hotpage at %p (idx=%d, writes=%d), marking page as NEVERCLEAN\n", (void*)(page<<12), idx, hp.writes);
+        neverprotectDB(page<<12, box64_pagesize, 1);
+    } else if(hp.cnt && !hp.never && !old.cnt)
+        dynarec_log(LOG_INFO, "Detecting a Hotpage at %p (idx=%d, writes=%d)\n", (void*)(page<<12), idx, hp.writes);
+}
+// code on a promoted page has been found modified
+void NoteHotPageWrite(uintptr_t addr)
+{
+    if(addr>=0x1000000000000LL)
+        return;
+    uintptr_t page = addr>>12;
+    int idx = IdxHotPage(page);
+    if(idx==-1)
+        return;
+    uint32_t epoch = HotPageTick();
+    hotpage_t old, hp;
+    do {
+        old = hotpage[idx];
+        if(old.addr!=page || !old.never)
+            return;
+        hp = HotPageDecay(old, epoch);
+        if(hp.writes<HOTPAGE_WRITES_MAX)
+            ++hp.writes;
+        hp.cnt = HOTPAGE_QUIET;
+    } while(!HotPageCAS(idx, old, hp));
 }
+// return 1 if addr is in a page that is currently hot, and count one more lookup on that page
 int isInHotPage(uintptr_t addr)
 {
     if(addr>0x1000000000000LL) return 0;
     uintptr_t page = addr>>12;
     int idx = IdxHotPage(page);
-    if(idx==-1 || !hotpage[idx].cnt || (hotpage[idx].cnt==HOTPAGE_MAX))
+    if(idx==-1)
         return 0;
-    //TODO: do Atomic stuffs instead
-    hotpage_t hp = hotpage[idx];
-    --hp.cnt;
-    native_lock_store_dd(hotpage+idx, hp.x);
-    if(!hp.cnt && BOX64ENV(dynarec_dirty)==1)
-        CancelHotPage(hp.addr);
-    return 1;
+    uint32_t epoch = HotPageTick();
+    int demote;
+    hotpage_t old, hp;
+    do {
+        old = hotpage[idx];
+        if(old.addr!=page)
+            return 0;
+        hp = HotPageDecay(old, epoch);
+        demote = 0;
+        if(hp.cnt)
+            --hp.cnt;
+        if(hp.never) {
+            if(!hp.cnt && !hp.writes) {
+                demote = 1;
+                hp.x = 0;   // free the slot
+            }
+        } else if(!hp.cnt && !hp.writes)
+            hp.x = 0;   // page cooled off, free the slot
+        if(hp.x==old.x)
+            break;
+    } while(!HotPageCAS(idx, old, hp));
+    if(demote) {
+        dynarec_log(LOG_INFO, "Hotpage at %p cooled off, removing NEVERCLEAN\n", (void*)(page<<12));
+        CancelHotPage(page);
+        return 0;
+    }
+    return (!old.never && old.cnt)?1:0;
 }
+// same as isInHotPage, but without counting a lookup
 int checkInHotPage(uintptr_t addr)
 {
     if(addr>0x1000000000000LL) return 0;
     uintptr_t page = addr>>12;
     int idx = IdxHotPage(page);
-    return (idx==-1 || !hotpage[idx].cnt || (hotpage[idx].cnt==HOTPAGE_MAX))?0:1;
+    if(idx==-1)
+        return 0;
+    hotpage_t hp = hotpage[idx];
+    return (hp.addr==page && !hp.never && hp.cnt)?1:0;
 }
 
 
@@ -2243,9 +2611,14 @@ void updateProtection(uintptr_t addr, size_t size, uint32_t prot)
         uint32_t never = dyn&PROT_NEVERPROT;
         if(!(never)) {
             if(dyn && (prot&PROT_WRITE)) {   // need to remove the write protection from this block
+                #ifdef DYNAREC
+                dyn = PROT_DYNAREC|writeProtectDB(cur, bend-cur, prot);
+                dynarec_log(LOG_DEBUG, " write protect %p:%p 0x%hhx (%s)\n", (void*)cur, (void*)(bend-1), prot&~PROT_WRITE, (dyn&PROT_UFFD)?"userfaultfd":"mprotect");
+                #else
                 dyn = PROT_DYNAREC;
                 int ret = mprotect((void*)cur, bend-cur, prot&~PROT_WRITE);
                 dynarec_log(LOG_DEBUG, " mprotect %p:%p 0x%hhx => %d\n", (void*)cur, (void*)(bend-1), prot&~PROT_WRITE, ret);
+                #endif
             } else if(dyn && !(prot&PROT_WRITE)) {
                 dyn = PROT_DYNAREC_R;
             }
@@ -2573,6 +2946,22 @@ static void atfork_child_custommem(void)
 {
     // (re)init mutex if it was lock before the fork
     init_mutexes();
+#ifdef DYNAREC
+    if(uffd_tracking) {
+        // the child has neither the tracker thread nor the write-protection, go back to mprotect
+        uffd_tracking = 0;
+        CloseUffdWriteTracker();
+        uintptr_t cur = 0, bend = 0;
+        uint32_t prot;
+        while(bend!=UINTPTR_MAX) {
+            if(rb_get_end(memprot, cur, &prot, &bend) && (prot&PROT_UFFD)) {
+                mprotect((void*)cur, bend-cur, prot&~(PROT_WRITE|PROT_CUSTOM));
+                rb_set(memprot, cur, bend, prot&~PROT_UFFD);
+            }
+            cur = bend;
+        }
+    }
+#endif
 }
 #ifdef BOX32
 void reverveHigMem32(void)
@@ -2695,6 +3084,10 @@ void init_custommem_helper(box64context_t* ctx)
     }
     lockaddress = kh_init(lockaddress);
     rbt_dynmem = rbtree_init("rbt_dynmem");
+    if(BOX64ENV(dynarec) && BOX64ENV(dynarec_writetrack)==1) {
+        uffd_tracking = InitUffdWriteTracker(uffdWriteFault)?0:1;
+        printf_log(LOG_INFO, "Dynarec write tracking uses %s\n", uffd_tracking?"userfaultfd":"mprotect");
+    }
 #endif
     pthread_atfork(NULL, NULL, atfork_child_custommem);
     // init mapallmem list
@@ -101,6 +101,9 @@ p0-p3 are used to pass scalable predicate arguments to a subroutine and to retur
 #define w87pc   x87pc
 // emu is r0
 #define xEmu    0
+// direct syscall: number in x8, 1st arg and return value in x0 (so in place of xEmu)
+#define xSysNum     8
+#define xSysArg0    0
 // ARM64 LR
 #define xLR     30
 // ARM64 SP is r31 but is a special register
@@ -541,6 +544,9 @@ int convert_bitmask(uint64_t bitmask);
 // Break
 #define BRK_gen(imm16)                  (0b11010100<<24 | 0b001<<21 | (((imm16)&0xffff)<<5))
 #define BRK(imm16)                      EMIT(BRK_gen(imm16))
+// Supervisor call
+#define SVC_gen(imm16)                  (0b11010100<<24 | 0b000<<21 | (((imm16)&0xffff)<<5) | 0b01)
+#define SVC(imm16)                      EMIT(SVC_gen(imm16))
 
 // BR and Branches
 #define BR_gen(Z, op, A, M, Rn, Rm)       (0b1101011<<25 | (Z)<<24 | (op)<<21 | 0b11111<<16 | (A)<<11 | (M)<<10 | (Rn)<<5 | (Rm))
@@ -2498,4 +2504,44 @@ int convert_bitmask(uint64_t bitmask);
 #define LDAPRH(Rt, Rn)      EMIT(LDAPR_gen(0b01, Rn, Rt))
 #define LDAPRB(Rt, Rn)      EMIT(LDAPR_gen(0b00, Rn, Rt))
 
+// LRCPC2 extension
+#define LDAPUR_gen(sz, opc, imm9, Rn, Rt)   ((sz)<<30 | 0b011001<<24 | (opc)<<22 | ((imm9)&0x1ff)<<12 | (Rn)<<5 | (Rt))
+#define LDAPURxw(Rt, Rn, imm9)  EMIT(LDAPUR_gen(0b10+rex.w, 0b01, imm9, Rn, Rt))
+#define STLURxw(Rt, Rn, imm9)   EMIT(LDAPUR_gen(0b10+rex.w, 0b00, imm9, Rn, Rt))
+
+// LOAD Acquire / STORE Release (ARMv8.0)
+#define MEMAR_gen(size, L, Rn, Rt)      ((size)<<30 | 0b001000<<24 | 1<<23 | (L)<<22 | 0b11111<<16 | 1<<15 | 0b11111<<10 | (Rn)<<5 | (Rt))
+#define LDARx(Rt, Rn)       EMIT(MEMAR_gen(0b11, 1, Rn, Rt))
+#define LDARw(Rt, Rn)       EMIT(MEMAR_gen(0b10, 1, Rn, Rt))
+#define LDARxw(Rt, Rn)      EMIT(MEMAR_gen(0b10+rex.w, 1, Rn, Rt))
+#define STLRx(Rt, Rn)       EMIT(MEMAR_gen(0b11, 0, Rn, Rt))
+#define STLRw(Rt, Rn)       EMIT(MEMAR_gen(0b10, 0, Rn, Rt))
+#define STLRxw(Rt, Rn)      EMIT(MEMAR_gen(0b10+rex.w, 0, Rn, Rt))
+#define STLRH(Rt, Rn)       EMIT(MEMAR_gen(0b01, 0, Rn, Rt))
+#define STLRB(Rt, Rn)       EMIT(MEMAR_gen(0b00, 0, Rn, Rt))
+
+// SVE extension
+// Z registers alias the V registers (Vn is the low 128bits of Zn), P0-P15 are the predicates
+#define SVE_PATTERN_VL2     0b00010
+#define SVE_PATTERN_VL4     0b00100
+// set predicate Pd active for elements of size (0:B, 1:H, 2:S, 3:D) in the pattern
+#define PTRUE_gen(size, pattern, Pd)            (0b00100101<<24 | (size)<<22 | 0b011000111000<<10 | (pattern)<<5 | (Pd))
+#define PTRUE_S(Pd, pattern)                    EMIT(PTRUE_gen(0b10, pattern, Pd))
+#define PTRUE_D(Pd, pattern)                    EMIT(PTRUE_gen(0b11, pattern, Pd))
+// Pd = active elements of Zn (in Pg) that are < signed imm5, other are 0
+#define CMPLT_imm_gen(size, imm5, Pg, Zn, Pd)   (0b00100101<<24 | (size)<<22 | ((imm5)&0x1f)<<16 | 0b001<<13 | (Pg)<<10 | (Zn)<<5 | (Pd))
+#define CMPLT_S_0(Pd, Pg, Zn)                   EMIT(CMPLT_imm_gen(0b10, 0, Pg, Zn, Pd))
+#define CMPLT_D_0(Pd, Pg, Zn)                   EMIT(CMPLT_imm_gen(0b11, 0, Pg, Zn, Pd))
+// Gather load, inactive elements are 0. 32bits elements use 32bits signed offsets, 64bits elements 64bits offsets, scaled or not by the element size
+#define LD1W_SXTW_gen(scaled, Zm, Pg, Rn, Zt)   (0b100001010<<23 | 1<<22 | (scaled)<<21 | (Zm)<<16 | 0b010<<13 | (Pg)<<10 | (Rn)<<5 | (Zt))
+#define LD1W_S_SXTW(Zt, Pg, Rn, Zm)             EMIT(LD1W_SXTW_gen(0, Zm, Pg, Rn, Zt))
+#define LD1W_S_SXTW_2(Zt, Pg, Rn, Zm)           EMIT(LD1W_SXTW_gen(1, Zm, Pg, Rn, Zt))
+#define LD1D_gen(scaled, Zm, Pg, Rn, Zt)        (0b1100010111<<22 | (scaled)<<21 | (Zm)<<16 | 0b110<<13 | (Pg)<<10 | (Rn)<<5 | (Zt))
+#define LD1D_D(Zt, Pg, Rn, Zm)                  EMIT(LD1D_gen(0, Zm, Pg, Rn, Zt))
+#define LD1D_D_3(Zt, Pg, Rn, Zm)                EMIT(LD1D_gen(1, Zm, Pg, Rn, Zt))
+// Zd = Pg?Zn:Zm
+#define SEL_gen(size, Zm, Pg, Zn, Zd)           (0b00000101<<24 | (size)<<22 | 1<<21 | (Zm)<<16 | 0b11<<14 | (Pg)<<10 | (Zn)<<5 | (Zd))
+#define SEL_S(Zd, Pg, Zn, Zm)                   EMIT(SEL_gen(0b10, Zm, Pg, Zn, Zd))
+#define SEL_D(Zd, Pg, Zn, Zm)                   EMIT(SEL_gen(0b11, Zm, Pg, Zn, Zd))
+
 #endif  //__ARM64_EMITTER_H__
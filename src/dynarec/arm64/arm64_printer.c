@@ -388,6 +388,22 @@ const char* arm64_print(uint32_t opcode, uintptr_t addr)
         return buff;
     }
 
+    if(isMask(opcode, "ff0010001L011111111111nnnnnttttt", &a)) {
+        if(a.L)
+            snprintf(buff, sizeof(buff), "LDAR%s %s, [%s]", (a.f==0)?"B":((a.f==1)?"H":""), (a.f==3)?Xt[Rt]:Wt[Rt], XtSp[Rn]);
+        else
+            snprintf(buff, sizeof(buff), "STLR%s %s, [%s]", (a.f==0)?"B":((a.f==1)?"H":""), (a.f==3)?Xt[Rt]:Wt[Rt], XtSp[Rn]);
+        return buff;
+    }
+    if(isMask(opcode, "ff11100010111111110000nnnnnttttt", &a)) {
+        snprintf(buff, sizeof(buff), "LDAPR%s %s, [%s]", (a.f==0)?"B":((a.f==1)?"H":""), (a.f==3)?Xt[Rt]:Wt[Rt], XtSp[Rn]);
+        return buff;
+    }
+    if(isMask(opcode, "ff011001oo0iiiiiiiii00nnnnnttttt", &a) && a.o<2) {
+        snprintf(buff, sizeof(buff), "%s%s %s, [%s, %d]", a.o?"LDAPUR":"STLUR", (a.f==0)?"B":((a.f==1)?"H":""), (a.f==3)?Xt[Rt]:Wt[Rt], XtSp[Rn], signExtend(imm, 9));
+        return buff;
+    }
+
     if(isMask(opcode, "ff0010000L0sssss011111nnnnnttttt", &a)) {
         if(a.L)
             snprintf(buff, sizeof(buff), "LDXR%s %s, [%s]", (sf==0)?"B":((sf==1)?"H":""), (sf==2)?Wt[Rt]:Xt[Rt], XtSp[Rn]);
@@ -1956,7 +1972,40 @@ const char* arm64_print(uint32_t opcode, uintptr_t addr)
         snprintf(buff, sizeof(buff), "SHA256H2 Q%d, Q%d, V%d.4S", Rd, Rn, Rm);
         return buff;
     }
+    // SVC
+    if(isMask(opcode, "11010100000iiiiiiiiiiiiiiii00001", &a)) {
+        snprintf(buff, sizeof(buff), "SVC 0x%x", a.i);
+        return buff;
+    }
     // UDF
+    // SVE
+    if(isMask(opcode, "00100101ff011000111000iiiii0tttt", &a)) {
+        const char* Y[] = {"B", "H", "S", "D"};
+        if(imm>0 && imm<14)
+            snprintf(buff, sizeof(buff), "PTRUE P%d.%s, VL%d", Rt, Y[sf], (imm<9)?imm:(16<<(imm-9)));
+        else
+            snprintf(buff, sizeof(buff), "PTRUE P%d.%s, #%d", Rt, Y[sf], imm);
+        return buff;
+    }
+    if(isMask(opcode, "00100101ff0iiiii001pppnnnnn0tttt", &a)) {
+        const char* Y[] = {"B", "H", "S", "D"};
+        snprintf(buff, sizeof(buff), "CMPLT P%d.%s, P%d/Z, Z%d.%s, #%d", Rt, Y[sf], a.p, Rn, Y[sf], (int)signExtend(imm, 5));
+        return buff;
+    }
+    if(isMask(opcode, "1000010101Smmmmm010pppnnnnnttttt", &a)) {
+        snprintf(buff, sizeof(buff), "LD1W {Z%d.S}, P%d/Z, [%s, Z%d.S, SXTW%s]", Rt, a.p, XtSp[Rn], Rm, a.S?" #2":"");
+        return buff;
+    }
+    if(isMask(opcode, "1100010111Smmmmm110pppnnnnnttttt", &a)) {
+        snprintf(buff, sizeof(buff), "LD1D {Z%d.D}, P%d/Z, [%s, Z%d.D%s]", Rt, a.p, XtSp[Rn], Rm, a.S?", LSL #3":"");
+        return buff;
+    }
+    if(isMask(opcode, "00000101ff1mmmmm11ppppnnnnnddddd", &a)) {
+        const char* Y[] = {"B", "H", "S", "D"};
+        snprintf(buff, sizeof(buff), "SEL Z%d.%s, P%d, Z%d.%s, Z%d.%s", Rd, Y[sf], a.p, Rn, Y[sf], Rm, Y[sf]);
+        return buff;
+    }
+
     if(isMask(opcode, "0000000000000000iiiiiiiiiiiiiiii", &a)) {
         snprintf(buff, sizeof(buff), "UDF 0x%x", a.i);
         return buff;
@@ -18,6 +18,7 @@
 #include "../dynablock_private.h"
 #include "custommem.h"
 #include "alternate.h"
+#include "elfloader.h"
 #include "mysignal.h"
 #include "arm64_printer.h"
 #include "dynarec_arm64_private.h"
@@ -56,6 +57,7 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
     int unscaled;
     int lock;
     int cacheupd = 0;
+    int v0, v1, q0, q1;
 
     opcode = F8;
     MAYUSE(eb1);
@@ -1493,11 +1495,21 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                         RORxw(gd, gd, 8);
                     }
                     // gd restored after that
+                    SMWRITELOCK(lock);
+                } else if(STRONGMEM_RCPC()) {
+                    // store-release keeps the store ordered after previous accesses, so it's not part of the strongmem SEQ
+                    addr = geted(dyn, addr, ninst, nextop, &ed, x2, &fixedaddress, cpuext.lrcpc2?&unscaled:NULL, 0, 0, rex, &lock, 0, 0);
+                    if(fixedaddress) {
+                        STLURxw(gd, ed, fixedaddress);
+                    } else {
+                        STLRxw(gd, ed);
+                    }
+                    if(lock) {DMB_ISH();}
                 } else {
                     addr = geted(dyn, addr, ninst, nextop, &ed, x2, &fixedaddress, &unscaled, 0xfff << (2 + rex.w), (1 << (2 + rex.w)) - 1, rex, &lock, 0, 0);
                     STxw(gd, ed, fixedaddress);
+                    SMWRITELOCK(lock);
                 }
-                SMWRITELOCK(lock);
             }
             break;
         case 0x8A:
@@ -1541,6 +1553,19 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
             if(MODREG) {
                 MOVxw_REG(gd, TO_NAT((nextop & 7) + (rex.b << 3)));
             } else {
+                IF_ALIGNED(ip) {
+                    if(STRONGMEM_RCPC()) {
+                        // load-acquire (RCpc) keeps the following accesses ordered after the load
+                        addr = geted(dyn, addr, ninst, nextop, &ed, x2, &fixedaddress, cpuext.lrcpc2?&unscaled:NULL, 0, 0, rex, &lock, 0, 0);
+                        SMREADLOCK(lock);
+                        if(fixedaddress) {
+                            LDAPURxw(gd, ed, fixedaddress);
+                        } else {
+                            LDAPRxw(gd, ed);
+                        }
+                        break;
+                    }
+                }
                 addr = geted(dyn, addr, ninst, nextop, &ed, x2, &fixedaddress, &unscaled, 0xfff<<(2+rex.w), (1<<(2+rex.w))-1, rex, &lock, 0, 0);
                 SMREADLOCK(lock);
                 LDxw(gd, ed, fixedaddress);
@@ -1765,6 +1790,27 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                         CMPSx_U12(x2, 8);
                         B_MARK(cCC);
                     }
+                    // wide path, 64 bytes per loop, only if a chunk cannot overlap itself
+                    SUBx_REG(x2, xRDI, xRSI);
+                    CMPSx_U12(x2, 64);
+                    B_MARK3(cCC);
+                    v0 = fpu_get_scratch(dyn, ninst);
+                    v1 = fpu_get_scratch(dyn, ninst);
+                    q0 = fpu_get_scratch(dyn, ninst);
+                    q1 = fpu_get_scratch(dyn, ninst);
+                    MARKF;
+                    CMPSx_U12(xRCX, 64);
+                    B_MARK3(cCC);   // xRCX<64
+                    // registers are updated once the chunk is written, so a fault restarts the chunk
+                    VLDP128_I7(v0, v1, xRSI, 0);
+                    VLDP128_I7(q0, q1, xRSI, 32);
+                    VSTP128_I7(v0, v1, xRDI, 0);
+                    VSTP128_I7(q0, q1, xRDI, 32);
+                    ADDx_U12(xRSI, xRSI, 64);
+                    ADDx_U12(xRDI, xRDI, 64);
+                    SUBx_U12(xRCX, xRCX, 64);
+                    CBZx_MARKLOCK(xRCX);
+                    B_MARKF_nocond;
                     // special optim for large RCX value on forward case only
                     MARK3;
                     ANDx_mask(x1, xRCX, 1, 0b111101, 0b111100); // mask=0xfffffffffffffff8, so ~7LL
@@ -1839,14 +1885,35 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                 SMREAD();
                 CBZx_NEXT(xRCX);
                 TBNZ_MARK2(xFlags, F_DF);
+                v0 = fpu_get_scratch(dyn, ninst);
+                v1 = fpu_get_scratch(dyn, ninst);
+                MARKF;  // wide path, 16 bytes at a time, if more than 16 bytes left and no page is crossed
+                CMPSx_U12(xRCX, 16);
+                B_MARK(cLS);
+                ANDx_mask(x3, xRSI, 1, 0, 0b001011);    // mask=0xfff
+                CMPSx_U12(x3, 0xff0);
+                B_MARK(cHI);
+                ANDx_mask(x3, xRDI, 1, 0, 0b001011);    // mask=0xfff
+                CMPSx_U12(x3, 0xff0);
+                B_MARK(cHI);
+                VLDR128_U12(v0, xRSI, 0);
+                VLDR128_U12(v1, xRDI, 0);
+                VCMEQQ_8(v0, v0, v1);
+                if(rep==1) {UMAXVQ_8(v0, v0);} else {UMINVQ_8(v0, v0);}
+                VMOVBto(x3, v0, 0);
+                if(rep==1) {CBNZw_MARK(x3);} else {CBZw_MARK(x3);}  // the end is in this chunk, finish byte per byte
+                ADDx_U12(xRSI, xRSI, 16);
+                ADDx_U12(xRDI, xRDI, 16);
+                SUBx_U12(xRCX, xRCX, 16);
+                B_MARKF_nocond;
                 MARK;   // Part with DF==0
                 LDRB_S9_postindex(x1, xRSI, 1);
                 LDRB_S9_postindex(x2, xRDI, 1);
                 SUBx_U12(xRCX, xRCX, 1);
                 CMPSw_REG(x1, x2);
                 B_MARK3((rep==1)?cEQ:cNE);
-                CBNZx_MARK(xRCX);
-                B_MARK3_nocond;
+                CBZx_MARK3(xRCX);
+                B_MARKF_nocond;
                 MARK2;  // Part with DF==1
                 LDRB_S9_postindex(x1, xRSI, -1);
                 LDRB_S9_postindex(x2, xRDI, -1);
@@ -1955,6 +2022,18 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                     ORRw_REG_LSL(x3, x3, x3, 8);
                     ORRw_REG_LSL(x3, x3, x3, 16);
                     ORRx_REG_LSL(x3, x3, x3, 32);   // 8 bytes...
+                    // wide path, 64 bytes per loop
+                    v0 = fpu_get_scratch(dyn, ninst);
+                    VDUPQD(v0, x3);
+                    MARKF;
+                    CMPSx_U12(xRCX, 64);
+                    B_MARK3(cCC);   // xRCX<64
+                    VSTP128_I7(v0, v0, xRDI, 0);
+                    VSTP128_I7(v0, v0, xRDI, 32);
+                    ADDx_U12(xRDI, xRDI, 64);
+                    SUBx_U12(xRCX, xRCX, 64);
+                    CBZx_MARKLOCK(xRCX);
+                    B_MARKF_nocond;
                     MARK3;
                     ANDx_mask(x1, xRCX, 1, 0b111101, 0b111100); // mask=0xfffffffffffffff8, so ~7LL
                     CBZx_MARK(x1);  // xRCX<8
@@ -2058,13 +2137,30 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                 CBZx_NEXT(xRCX);
                 UBFXw(x1, xRAX, 0, 8);
                 TBNZ_MARK2(xFlags, F_DF);
+                v0 = fpu_get_scratch(dyn, ninst);
+                v1 = fpu_get_scratch(dyn, ninst);
+                VDUPQB(v1, x1);
+                MARKF;  // wide path, 16 bytes at a time, if more than 16 bytes left and no page is crossed
+                CMPSx_U12(xRCX, 16);
+                B_MARK(cLS);
+                ANDx_mask(x3, xRDI, 1, 0, 0b001011);    // mask=0xfff
+                CMPSx_U12(x3, 0xff0);
+                B_MARK(cHI);
+                VLDR128_U12(v0, xRDI, 0);
+                VCMEQQ_8(v0, v0, v1);
+                if(rep==1) {UMAXVQ_8(v0, v0);} else {UMINVQ_8(v0, v0);}
+                VMOVBto(x3, v0, 0);
+                if(rep==1) {CBNZw_MARK(x3);} else {CBZw_MARK(x3);}  // the end is in this chunk, finish byte per byte
+                ADDx_U12(xRDI, xRDI, 16);
+                SUBx_U12(xRCX, xRCX, 16);
+                B_MARKF_nocond;
                 MARK;   // Part with DF==0
                 LDRB_S9_postindex(x2, xRDI, 1);
                 SUBx_U12(xRCX, xRCX, 1);
                 CMPSw_REG(x1, x2);
                 B_MARK3((rep==1)?cEQ:cNE);
-                CBNZx_MARK(xRCX);
-                B_MARK3_nocond;
+                CBZx_MARK3(xRCX);
+                B_MARKF_nocond;
                 MARK2;  // Part with DF==1
                 LDRB_S9_postindex(x2, xRDI, -1);
                 SUBx_U12(xRCX, xRCX, 1);
@@ -2164,7 +2260,18 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
         case 0xBF:
             INST_NAME("MOV Reg, Id");
             gd = TO_NAT((opcode & 7) + (rex.b << 3));
-            if(rex.w) {
+            if(dyn->insts[ninst].x64.const_reg) {
+                // value known from constant propagation
+                addr += rex.w?8:4;
+                v0 = TO_NAT(dyn->insts[ninst].x64.const_reg-1);
+                if(dyn->insts[ninst].x64.const_delta>0) {
+                    ADDx_U12(gd, v0, dyn->insts[ninst].x64.const_delta);
+                } else if(dyn->insts[ninst].x64.const_delta<0) {
+                    SUBx_U12(gd, v0, -dyn->insts[ninst].x64.const_delta);
+                } else if(gd!=v0) {
+                    MOVx_REG(gd, v0);
+                }
+            } else if(rex.w) {
                 u64 = F64;
                 MOV64x(gd, u64);
             } else {
@@ -2640,7 +2747,7 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                     if(isRetX87Wrapper(*(wrapper_t*)(addr)))
                         // return value will be on the stack, so the stack depth needs to be updated
                         x87_purgecache(dyn, ninst, 0, x3, x1, x4);
-                    if ((BOX64ENV(log)<2 && !BOX64ENV(rolling_log) && !BOX64ENV(dynarec_test)) && tmp) {
+                    if ((BOX64ENV(log)<2 && !BOX64ENV(rolling_log) && !BOX64ENV(stats) && !BOX64ENV(dynarec_test)) && tmp) {
                         //GETIP(ip+3+8+8); // read the 0xCC
                         call_n(dyn, ninst, (void*)(addr+8), tmp);
                         addr+=8+8;
@@ -3404,7 +3511,12 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                 #endif
             }
             #if STEP < 2
-            if (!rex.is32bits  && !dyn->need_reloc && IsNativeCall(addr + i32, rex.is32bits, &dyn->insts[ninst].natcall, &dyn->insts[ninst].retn))
+            // a call to a PLT stub is done directly to the GOT target, with a check that the GOT didn't change
+            dyn->insts[ninst].pltgot = (!rex.is32bits && !dyn->need_reloc && i32)?GetPltStubGot(addr + i32):0;
+            dyn->insts[ninst].pltval = dyn->insts[ninst].pltgot?*(uintptr_t*)dyn->insts[ninst].pltgot:0;
+            if(!dyn->insts[ninst].pltval)
+                dyn->insts[ninst].pltgot = 0;
+            if (!rex.is32bits  && !dyn->need_reloc && IsNativeCall(dyn->insts[ninst].pltgot?(uintptr_t)getAlternate((void*)dyn->insts[ninst].pltval):(addr + i32), rex.is32bits, &dyn->insts[ninst].natcall, &dyn->insts[ninst].retn))
                 tmp = dyn->insts[ninst].pass2choice = 3;
             else
                 tmp = dyn->insts[ninst].pass2choice = i32?0:1;
@@ -3431,13 +3543,24 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                     // calling a native function
                     SMEND();
                     sse_purge07cache(dyn, ninst, x3);
-                    if ((BOX64ENV(log) < 2 && !BOX64ENV(rolling_log) && !BOX64ENV(dynarec_test)) && dyn->insts[ninst].natcall) {
+                    if ((BOX64ENV(log) < 2 && !BOX64ENV(rolling_log) && !BOX64ENV(stats) && !BOX64ENV(dynarec_test)) && dyn->insts[ninst].natcall) {
                         tmp=isSimpleWrapper(*(wrapper_t*)(dyn->insts[ninst].natcall+2));
                     } else
                         tmp=0;
                     if(dyn->insts[ninst].natcall && isRetX87Wrapper(*(wrapper_t*)(dyn->insts[ninst].natcall+2)))
                     // return value will be on the stack, so the stack depth needs to be updated
                         x87_purgecache(dyn, ninst, 0, x3, x1, x4);
+                    if(dyn->insts[ninst].pltgot) {
+                        // the GOT slot changed since the block was built: jump to its new target
+                        MOV64x(x4, dyn->insts[ninst].pltgot);
+                        LDRx_U12(x3, x4, 0);
+                        MOV64x(x4, dyn->insts[ninst].pltval);
+                        CMPSx_REG(x3, x4);
+                        B_MARK3(cEQ);
+                        fpu_purgecache(dyn, ninst, 1, x1, x2, x4);
+                        jump_to_next(dyn, 0, x3, ninst, rex.is32bits);
+                        MARK3;
+                    }
                     if ((BOX64ENV(log)<2 && !BOX64ENV(rolling_log)) && dyn->insts[ninst].natcall && tmp) {
                         //GETIP(ip+3+8+8); // read the 0xCC
                         call_n(dyn, ninst, (void*)(dyn->insts[ninst].natcall+2+8), tmp);
@@ -3520,6 +3643,18 @@ uintptr_t dynarec64_00(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
                         j64 = (uint32_t)(addr+i32);
                     else
                         j64 = addr+i32;
+                    if(dyn->insts[ninst].pltgot) {
+                        // skip the PLT stub: direct jump to the GOT target if the slot didn't change, indirect one else
+                        MESSAGE(LOG_DUMP, "PLT stub %p folded (GOT %p)\n", (void*)j64, (void*)dyn->insts[ninst].pltgot);
+                        MOV64x(x4, dyn->insts[ninst].pltgot);
+                        LDRx_U12(x1, x4, 0);
+                        MOV64x(x4, dyn->insts[ninst].pltval);
+                        CMPSx_REG(x1, x4);
+                        B_MARK3(cEQ);
+                        jump_to_next(dyn, 0, x1, ninst, rex.is32bits);
+                        MARK3;
+                        j64 = dyn->insts[ninst].pltval;
+                    }
                     jump_to_next(dyn, j64, 0, ninst, rex.is32bits);
                     if(BOX64DRENV(dynarec_callret)>1) CALLRET_RET();
                     if (BOX64DRENV(dynarec_callret) && addr >= (dyn->start + dyn->isize)) {
@@ -11,6 +11,7 @@
 #include "box64stack.h"
 #include "callback.h"
 #include "emu/x64run_private.h"
+#include "emu/x64int_private.h"
 #include "x64trace.h"
 #include "dynarec_native.h"
 #include "my_cpuid.h"
@@ -143,6 +144,28 @@ uintptr_t dynarec64_0F(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int nin
             INST_NAME("SYSCALL");
             NOTEST(x1);
             SMEND();
+            // a pass-through syscall with a constant number (MOV EAX, Id just before) is done with the host SVC directly
+            i32 = 0;
+            if(!rex.is32bits && ninst && dyn->insts[ninst].pred_sz==1 && dyn->insts[ninst].pred[0]==ninst-1
+              && dyn->insts[ninst-1].x64.size==5 && *(uint8_t*)dyn->insts[ninst-1].x64.addr==0xB8)
+                i32 = x64SyscallDirect(*(uint32_t*)(dyn->insts[ninst-1].x64.addr+1), &s0);
+            if(i32) {
+                MESSAGE(LOG_DUMP, "Direct syscall %d (%d args)\n", i32, s0);
+                MOVx_REG(x6, xEmu);
+                // x86_64 args are rdi, rsi, rdx, r10, r8, r9. ARM64 ones are x0..x5, with number in x8
+                // x0 is xEmu: it's only overwritten just before the SVC, so the signal handler can find xEmu in x6 from there
+                if(s0>1) MOVx_REG(x1, xRSI);
+                if(s0>2) MOVx_REG(x2, xRDX);
+                if(s0>3) MOVx_REG(x3, xR10);
+                if(s0>4) MOVx_REG(x4, xR8);
+                if(s0>5) MOVx_REG(x5, xR9);
+                MOV32w(xSysNum, i32);
+                if(s0>0) MOVx_REG(xSysArg0, xRDI);
+                SVC(0);
+                MOVx_REG(xRAX, xSysArg0);
+                MOVx_REG(xEmu, x6);
+                break;
+            }
             GETIP(addr);
             STORE_XEMU_CALL(xRIP);
             CALL_S(const_x64syscall, -1);
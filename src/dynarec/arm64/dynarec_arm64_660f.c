@@ -1277,198 +1277,39 @@ uintptr_t dynarec64_660F(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int n
                     break;
 
                 case 0x60:
-                    INST_NAME("PCMPESTRM Gx, Ex, Ib");
-                    SETFLAGS(X_ALL, SF_SET_DF);
-                    nextop = F8;
-                    GETG;
-                    sse_forget_reg(dyn, ninst, gd);
-                    ADDx_U12(x3, xEmu, offsetof(x64emu_t, xmm[gd]));
-                    if(MODREG) {
-                        ed = (nextop&7)+(rex.b<<3);
-                        if(ed>7)
-                            sse_reflect_reg(dyn, ninst, ed);
-                        ADDx_U12(x1, xEmu, offsetof(x64emu_t, xmm[ed]));
+                case 0x62:
+                    if(opcode==0x60) {
+                        INST_NAME("PCMPESTRM Gx, Ex, Ib");
                     } else {
-                        addr = geted(dyn, addr, ninst, nextop, &ed, x1, &fixedaddress, NULL, 0, 0, rex, NULL, 0, 1);
-                        if(ed!=x1) {
-                            MOVx_REG(x1, ed);
-                        }
+                        INST_NAME("PCMPISTRM Gx, Ex, Ib");
                     }
-                    MOVx_REG(x2, xRDX);
-                    MOVx_REG(x4, xRAX);
+                    SETFLAGS(X_ALL, SF_SET);
+                    nextop = F8;
+                    GETGX(v0, 0);
+                    GETEX(v1, 0, 1);
                     u8 = F8;
-                    MOV32w(x5, u8);
-                    CALL(const_sse42_compare_string_explicit_len, x1);
+                    q1 = emit_pcmpstr(dyn, ninst, rex, v0, v1, u8, opcode==0x60, x1, x2, x3, x4, x5);
                     q0 = sse_get_reg_empty(dyn, ninst, x2, 0);
                     if(u8&0b1000000) {
-                        q1 = fpu_get_scratch(dyn, ninst);
-                        switch(u8&1) {
-                            case 0b00:
-                                VDUPQB(q0, x1); // load the low 8bits of the mask
-                                LSRw_IMM(x1, x1, 8);
-                                VDUPQB(q1, x1); // load the high 8bits of the mask
-                                VEXTQ_8(q0, q0, q1, 8); // low and hig bits mask
-                                TABLE64C(x2, const_8b_7_6_5_4_3_2_1_0);
-                                VLDR64_U12(q1, x2, 0);     // load shift
-                                VDUPQ_64(q1, q1, 0);
-                                USHLQ_8(q0, q0, q1); // extract 1 bit
-                                MOVIQ_8(q1, 0x80);   // load mask
-                                VANDQ(q0, q0, q1);
-                                VSSHRQ_8(q0, q0, 7);    // saturate the mask
-                                break;
-                            case 0b01:
-                                VDUPQH(q0, x1); // load the 8bits of the mask
-                                TABLE64C(x2, const_8b_15_14_13_12_11_10_9_8);
-                                VLDR64_U12(q1, x2, 0);     // load shift
-                                UXTL_8(q1, q1);     // extend mask to 16bits
-                                USHLQ_16(q0, q0, q1); // extract 1 bit
-                                MOVIQ_16(q1, 0x80, 1);   // load mask
-                                VANDQ(q0, q0, q1);
-                                VSSHRQ_16(q0, q0, 15);    // saturate the mask
-                        }
+                        VMOVQ(q0, q1);  // byte/word mask
                     } else {
                         VEORQ(q0, q0, q0);
                         VMOVQHfrom(q0, 0, x1);
                     }
                     break;
                 case 0x61:
-                    INST_NAME("PCMPESTRI Gx, Ex, Ib");
-                    nextop = F8;
-                    GETG;
-                    u8 = geted_ib(dyn, addr, ninst, nextop);
-                    if((u8&0b1100)==0b1000) {
-                        SETFLAGS(X_ALL, SF_SET);
-                        // this case is (un)signed word, equal each
-                        GETGX(v0, 0);
-                        GETEX(v1, 0, 1);
-                        u8 = F8;
-                        q0 = fpu_get_scratch(dyn, ninst);
-                        if(u8&1) {
-                            //16bits
-                            VCMEQQ_16(q0, v0, v1);   // equal => mask regs
-                            XTN_8(q0, q0);          // 8 bits mask, in lower 64bits
-                            // transform that a mask in x1
-                            q1 = fpu_get_scratch(dyn, ninst);
-                            VSHL_8(q0, q0, 7);  // keep only bit 0x80
-                            TABLE64C(x1, const_8b_m7_m6_m5_m4_m3_m2_m1_0);
-                            VLDR64_U12(q1, x1, 0);     // load shift
-                            USHL_8(q0, q0, q1); // shift
-                            UADDLV_8(q0, q0);   // accumulate
-                            VMOVBto(x1, q0, 0);
-                        } else {
-                            //8 bits
-                            VCMEQQ_8(q0, v0, v1);   // equal => mask regs
-                            // transform that a mask in x1
-                            q1 = fpu_get_scratch(dyn, ninst);
-                            d0 = fpu_get_scratch(dyn, ninst);
-                            VSHL_8(d0, q0, 7);  // keep only bit 0x80
-                            TABLE64C(x1, const_8b_m7_m6_m5_m4_m3_m2_m1_0);
-                            VLDR64_U12(q1, x1, 0);     // load shift
-                            USHL_8(d0, d0, q1); // shift
-                            UADDLV_8(d0, d0);   // accumulate
-                            VMOVBto(x1, d0, 0);
-                            // high part
-                            VMOVeD(d0, 0, q0, 1);
-                            VSHL_8(d0, d0, 7);  // keep only bit 0x80
-                            USHL_8(d0, d0, q1); // shift
-                            UADDLV_8(d0, d0);   // accumulate
-                            VMOVBto(x2, d0, 0);
-                            BFIw(x1, x2, 8, 8); // insert
-                        }
-                        // get abs of eax / edx and find min
-                        ADDSxw_U12(x2, xRAX, 0);
-                        Bcond(cPL, 4+4);
-                        NEGxw_REG(x2, x2);
-                        ADDSxw_U12(x3, xRDX, 0);
-                        Bcond(cPL, 4+4);
-                        NEGxw_REG(x3, x3);
-                        MOV32w(x4, (u8&1)?8:16);
-                        CMPSw_REG(x3, x4);
-                        CSELw(x3, x3, x4, cLT); // x3 is lmem
-                        CMPSw_REG(x2, x4);
-                        CSELw(x2, x2, x4, cLT); // x2 is lreg
-                        CMPSw_REG(x2, x3);
-                        CSELw(x5, x3, x2, cLT); // x5 is max(lmem, lreg)
-                        CSELw(x2, x2, x3, cLT); // x2 is min(lmem, lreg)
-                        // x2 is min length 0-n_packed
-                        MVNw_REG(x4, xZR);
-                        LSLw_REG(x87pc, x4, x2);
-                        BICw_REG(x1, x1, x87pc);
-                        LSLw_REG(x4, x4, x5);
-                        ORRw_REG(x1, x1, x4);
-                        ANDw_mask(x1, x1, 0, (u8&1)?7:15);
-                        // x1 is intres1, transform to intres2
-                        switch((u8>>4)&3) {
-                            case 0b01:
-                                MOV32w(x4, (1<<((u8&1)?8:16))-1);
-                                EORw_REG(x1, x1, x4);
-                                break;
-                            case 0b11:
-                                MOV32w(x4, 1);
-                                LSLw_REG(x4, x4, x3);
-                                SUBw_U12(x4, x4, 1);
-                                EORw_REG(x1, x1, x4);
-                        }
-                        // flags
-                        IFX(X_ALL) {
-                            SET_DFNONE();
-                            IFX(X_CF) {
-                                CMPSw_REG(x1, xZR);
-                                CSETw(x4, cNE);
-                                BFIw(xFlags, x4, F_CF, 1);
-                            }
-                            IFX(X_ZF|X_SF) {
-                                MOV32w(x4, (u8&1)?8:16);
-                                IFX(X_ZF) {
-                                    CMPSw_REG(x3, x4);
-                                    CSETw(x5, cLT);
-                                    BFIw(xFlags, x5, F_ZF, 1);
-                                }
-                                IFX(X_SF) {
-                                    CMPSw_REG(x2, x4);
-                                    CSETw(x5, cLT);
-                                    BFIw(xFlags, x5, F_SF, 1);
-                                }
-                            }
-                            IFX(X_OF) {
-                                BFIw(xFlags, x1, F_OF, 1);
-                            }
-                            IFX(X_AF) {
-                                BFCw(wFlags, F_AF, 1);
-                                /*CMPSw_U12(x1, 0);
-                                CSETw(x4, cEQ);
-                                CMPSw_U12(x3, (u8&1)?8:16);
-                                CSETw(x5, cEQ);
-                                ANDw_REG(x4, x4, x5);
-                                BFIw(xFlags, x4, F_AF, 1);*/
-                            }
-                            IFX(X_PF) {
-                                BFCw(xFlags, F_PF, 1);
-                            }
-                        }
-                        NATIVE_RESTORE_X87PC();
+                case 0x63:
+                    if(opcode==0x61) {
+                        INST_NAME("PCMPESTRI Gx, Ex, Ib");
                     } else {
-                        SETFLAGS(X_ALL, SF_SET_DF);
-                        if(gd>7)    // no need to reflect cache as xmm0-xmm7 will be saved before the function call anyway
-                            sse_reflect_reg(dyn, ninst, gd);
-                        ADDx_U12(x3, xEmu, offsetof(x64emu_t, xmm[gd]));
-                        if(MODREG) {
-                            ed = (nextop&7)+(rex.b<<3);
-                            if(ed>7)
-                                sse_reflect_reg(dyn, ninst, ed);
-                            ADDx_U12(x1, xEmu, offsetof(x64emu_t, xmm[ed]));
-                        } else {
-                            addr = geted(dyn, addr, ninst, nextop, &ed, x1, &fixedaddress, NULL, 0, 0, rex, NULL, 0, 1);
-                            if(ed!=x1) {
-                                MOVx_REG(x1, ed);
-                            }
-                        }
-                        MOVw_REG(x2, xRDX);
-                        MOVw_REG(x4, xRAX);
-                        u8 = F8;
-                        MOV32w(x5, u8);
-                        CALL(const_sse42_compare_string_explicit_len, x1);
+                        INST_NAME("PCMPISTRI Gx, Ex, Ib");
                     }
+                    SETFLAGS(X_ALL, SF_SET);
+                    nextop = F8;
+                    GETGX(v0, 0);
+                    GETEX(v1, 0, 1);
+                    u8 = F8;
+                    emit_pcmpstr(dyn, ninst, rex, v0, v1, u8, opcode==0x61, x1, x2, x3, x4, x5);
                     if(u8&0b1000000) {
                         CBNZw_MARK(x1);
                         MOV32w(xRCX, (u8&1)?8:16);
@@ -1483,94 +1324,6 @@ uintptr_t dynarec64_660F(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip, int n
                         CLZw(xRCX, xRCX);
                     }
                     break;
-                case 0x62:
-                    INST_NAME("PCMPISTRM Gx, Ex, Ib");
-                    SETFLAGS(X_ALL, SF_SET_DF);
-                    nextop = F8;
-                    GETG;
-                    sse_forget_reg(dyn, ninst, gd);
-                    ADDx_U12(x2, xEmu, offsetof(x64emu_t, xmm[gd]));
-                    if(MODREG) {
-                        ed = (nextop&7)+(rex.b<<3);
-                        if(ed>7)
-                            sse_reflect_reg(dyn, ninst, ed);
-                        ADDx_U12(x1, xEmu, offsetof(x64emu_t, xmm[ed]));
-                    } else {
-                        addr = geted(dyn, addr, ninst, nextop, &ed, x1, &fixedaddress, NULL, 0, 0, rex, NULL, 0, 1);
-                        if(ed!=x1) {
-                            MOVx_REG(x1, ed);
-                        }
-                    }
-                    u8 = F8;
-                    MOV32w(x3, u8);
-                    CALL(const_sse42_compare_string_implicit_len, x1);
-                    q0 = sse_get_reg_empty(dyn, ninst, x2, 0);
-                    if(u8&0b1000000) {
-                        q1 = fpu_get_scratch(dyn, ninst);
-                        switch(u8&1) {
-                            case 0b00:
-                                VDUPQB(q0, x1); // load the low 8bits of the mask
-                                LSRw_IMM(x1, x1, 8);
-                                VDUPQB(q1, x1); // load the high 8bits of the mask
-                                VEXTQ_8(q0, q0, q1, 8); // low and hig bits mask
-                                TABLE64C(x2, const_8b_7_6_5_4_3_2_1_0);
-                                VLDR64_U12(q1, x2, 0);     // load shift
-                                VDUPQ_64(q1, q1, 0);
-                                USHLQ_8(q0, q0, q1); // extract 1 bit
-                                MOVIQ_8(q1, 0x80);   // load mask
-                                VANDQ(q0, q0, q1);
-                                VSSHRQ_8(q0, q0, 7);    // saturate the mask
-                                break;
-                            case 0b01:
-                                VDUPQH(q0, x1); // load the 8bits of the mask
-                                TABLE64C(x2, const_8b_15_14_13_12_11_10_9_8);
-                                VLDR64_U12(q1, x2, 0);     // load shift
-                                UXTL_8(q1, q1);     // extend mask to 16bits
-                                USHLQ_16(q0, q0, q1); // extract 1 bit
-                                MOVIQ_16(q1, 0x80, 1);   // load mask
-                                VANDQ(q0, q0, q1);
-                                VSSHRQ_16(q0, q0, 15);    // saturate the mask
-                        }
-                    } else {
-                        VEORQ(q0, q0, q0);
-                        VMOVQHfrom(q0, 0, x1);
-                    }
-                    break;
-                case 0x63:
-                    INST_NAME("PCMPISTRI Gx, Ex, Ib");
-                    SETFLAGS(X_ALL, SF_SET_DF);
-                    nextop = F8;
-                    GETG;
-                    if(gd>7)
-                        sse_reflect_reg(dyn, ninst, gd);
-                    ADDx_U12(x2, xEmu, offsetof(x64emu_t, xmm[gd]));
-                    if(MODREG) {
-                        ed = (nextop&7)+(rex.b<<3);
-                        if(ed>7)
-                            sse_reflect_reg(dyn, ninst, ed);
-                        ADDx_U12(x1, xEmu, offsetof(x64emu_t, xmm[ed]));
-                    } else {
-                        addr = geted(dyn, addr, ninst, nextop, &ed, x1, &fixedaddress, NULL, 0, 0, rex, NULL, 0, 1);
-                        if(ed!=x1) {
-                            MOVx_REG(x1, ed);
-                        }
-                    }
-                    u8 = F8;
-                    MOV32w(x3, u8);
-                    CALL(const_sse42_compare_string_implicit_len, x1);
-                    CBNZw_MARK(x1);
-                    MOV32w(xRCX, (u8&1)?8:16);
-                    B_NEXT_nocond;
-                    MARK;
-                    if(u8&0b1000000) {
-                        CLZw(xRCX, x1);
-                        MOV32w(x2, 31);
-                        SUBw_REG(xRCX, x2, xRCX);
-                    } else {
-                        RBITxw(xRCX, x1);
-                        CLZw(xRCX, xRCX);
-                    }
-                    break;
 
                 case 0xDF:
                     INST_NAME("AESKEYGENASSIST Gx, Ex, Ib");  // AES-NI
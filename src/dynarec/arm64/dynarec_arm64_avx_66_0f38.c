@@ -1368,6 +1368,7 @@ uintptr_t dynarec64_AVX_66_0F38(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip
             }
             // ed is base
             wb1 = u8>>6;    // scale
+            if(USE_SVE()) d0 = fpu_get_scratch(dyn, ninst);   // before any ymm
             for(int l=0; l<1+vex.l; ++l) {
                 if(!l) {
                     v0 = sse_get_reg(dyn, ninst, x1, gd, 1);
@@ -1378,6 +1379,23 @@ uintptr_t dynarec64_AVX_66_0F38(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip
                     v2 = ymm_get_reg(dyn, ninst, x1, vex.v, 1, gd, (!rex.w)?eb2:-1, -1);
                     if(!rex.w) v1 = ymm_get_reg(dyn, ninst, x1, eb2, 0, gd, vex.v, -1);
                 }
+                if(USE_SVE() && (!wb1 || wb1==(rex.w?3:2))) {
+                    // SVE gather on the 128bits half: predicate is the sign of the mask, inactive elements are kept
+                    if(rex.w) {
+                        if(l) SXTL2_32(d0, v1); else SXTL_32(d0, v1);
+                        PTRUE_D(0, SVE_PATTERN_VL2);
+                        CMPLT_D_0(1, 0, v2);
+                        if(wb1) LD1D_D_3(d0, 1, ed, d0); else LD1D_D(d0, 1, ed, d0);
+                        SEL_D(v0, 1, d0, v0);
+                    } else {
+                        PTRUE_S(0, SVE_PATTERN_VL4);
+                        CMPLT_S_0(1, 0, v2);
+                        if(wb1) LD1W_S_SXTW_2(d0, 1, ed, v1); else LD1W_S_SXTW(d0, 1, ed, v1);
+                        SEL_S(v0, 1, d0, v0);
+                    }
+                    VEORQ(v2, v2, v2);
+                    continue;
+                }
                 // prepare mask
                 if(rex.w) VSSHRQ_64(v2, v2, 63); else VSSHRQ_32(v2, v2, 31);
                 // slow gather, not much choice here...
@@ -1428,6 +1446,7 @@ uintptr_t dynarec64_AVX_66_0F38(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip
             }
             // ed is base
             wb1 = u8>>6;    // scale
+            if(USE_SVE() && rex.w) d0 = fpu_get_scratch(dyn, ninst);   // before any ymm
             if(!rex.w) {
                 v0 = sse_get_reg(dyn, ninst, x1, gd, 1);
                 v2 = sse_get_reg(dyn, ninst, x1, vex.v, 1);
@@ -1458,6 +1477,15 @@ uintptr_t dynarec64_AVX_66_0F38(dynarec_arm_t* dyn, uintptr_t addr, uintptr_t ip
                         v2 = ymm_get_reg(dyn, ninst, x1, vex.v, 1, gd, (!rex.w)?eb2:-1, -1);
                         v1 = ymm_get_reg(dyn, ninst, x1, eb2, 0, gd, vex.v, -1);
                     }
+                    if(USE_SVE() && (!wb1 || wb1==3)) {
+                        // SVE gather on the 128bits half, same as above with 64bits indexes
+                        PTRUE_D(0, SVE_PATTERN_VL2);
+                        CMPLT_D_0(1, 0, v2);
+                        if(wb1) LD1D_D_3(d0, 1, ed, v1); else LD1D_D(d0, 1, ed, v1);
+                        SEL_D(v0, 1, d0, v0);
+                        VEORQ(v2, v2, v2);
+                        continue;
+                    }
                     // prepare mask
                     VSSHRQ_64(v2, v2, 63);
                     // slow gather, not much choice here...
@@ -26,6 +26,8 @@
 static const int8_t mask_shift8[] = { -7, -6, -5, -4, -3, -2, -1, 0 };
 static const int8_t mask_string8[] = { 7, 6, 5, 4, 3, 2, 1, 0 };
 static const int8_t mask_string16[] = { 15, 14, 13, 12, 11, 10, 9, 8 };
+static const uint8_t lane_index8[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+static const uint8_t lane_bits8[] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
 static const float addsubps[4] = {-1.f, 1.f, -1.f, 1.f};
 static const double addsubpd[2] = {-1., 1.};
 static const float subaddps[4] = {1.f, -1.f, 1.f, -1.f};
@@ -129,6 +131,8 @@ uintptr_t getConst(arm64_consts_t which)
         case const_8b_m7_m6_m5_m4_m3_m2_m1_0: return (uintptr_t)&mask_shift8;
         case const_8b_7_6_5_4_3_2_1_0: return (uintptr_t)&mask_string8;
         case const_8b_15_14_13_12_11_10_9_8: return (uintptr_t)&mask_string16;
+        case const_16b_index: return (uintptr_t)&lane_index8;
+        case const_16b_bits: return (uintptr_t)&lane_bits8;
         case const_4f_m1_1_m1_1: return (uintptr_t)&addsubps;
         case const_4f_1_m1_1_m1: return (uintptr_t)&subaddps;
         case const_2d_m1_1: return (uintptr_t)&addsubpd;
@@ -93,6 +93,8 @@ typedef enum arm64_consts_s {
     const_8b_m7_m6_m5_m4_m3_m2_m1_0,
     const_8b_7_6_5_4_3_2_1_0,
     const_8b_15_14_13_12_11_10_9_8,
+    const_16b_index,
+    const_16b_bits,
     const_4f_m1_1_m1_1,
     const_2d_m1_1,
     const_4f_1_m1_1_m1,
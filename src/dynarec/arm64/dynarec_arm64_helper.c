@@ -2666,6 +2666,211 @@ void emit_pf(dynarec_arm_t* dyn, int ninst, int s1, int s4)
     BFIw(xFlags, s4, F_PF, 1);
 }
 
+// convert a vector of byte/word lane masks in v to a bitmask in s1 (v is destroyed, vbits is the const_16b_bits vector)
+static void pcmpstr_tobits(dynarec_arm_t* dyn, int ninst, int v, int vbits, int word, int s1)
+{
+    if(word)
+        XTN_8(v, v);
+    VANDQ(v, v, vbits);
+    VADDPQ_8(v, v, v);
+    VADDPQ_8(v, v, v);
+    VADDPQ_8(v, v, v);
+    VMOVHto(s1, v, 0);
+}
+
+// Inline PCMPxSTRx, specialized on imm8: vreg is Gx, vmem is Ex.
+// Explicit length are taken from RAX/RDX, implicit from the 1st null element.
+// Return intres2 in s1, lreg in s2 and lmem in s3 and set the flags. s4 & s5 are scratch
+// Also return the scratch register containing intres2 as a byte/word mask
+int emit_pcmpstr(dynarec_arm_t* dyn, int ninst, rex_t rex, int vreg, int vmem, uint8_t imm8, int explicit_len, int s1, int s2, int s3, int s4, int s5)
+{
+    int word = imm8&1;
+    int n = word?8:16;
+    int es = word?2:1;
+    int nvr = fpu_get_scratch(dyn, ninst);
+    int nvm = fpu_get_scratch(dyn, ninst);
+    int acc = fpu_get_scratch(dyn, ninst);
+    int t1 = fpu_get_scratch(dyn, ninst);
+    int t2 = fpu_get_scratch(dyn, ninst);
+    // lengths
+    if(explicit_len) {
+        // abs(eax) / abs(edx), saturated to n
+        ADDSxw_U12(s2, xRAX, 0);
+        Bcond(cPL, 4+4);
+        NEGxw_REG(s2, s2);
+        ADDSxw_U12(s3, xRDX, 0);
+        Bcond(cPL, 4+4);
+        NEGxw_REG(s3, s3);
+        MOV32w(s4, n);
+        CMPSxw_REG(s2, s4);
+        CSELxw(s2, s2, s4, cLT);
+        CMPSxw_REG(s3, s4);
+        CSELxw(s3, s3, s4, cLT);
+    } else {
+        TABLE64C(s4, const_16b_bits);
+        VLDR128_U12(t2, s4, 0);
+        if(word) CMEQQ_0_16(t1, vreg); else CMEQQ_0_8(t1, vreg);
+        pcmpstr_tobits(dyn, ninst, t1, t2, word, s2);
+        ORRw_mask(s2, s2, word?24:16, 0);   // set bit n
+        RBITw(s2, s2);
+        CLZw(s2, s2);
+        if(word) CMEQQ_0_16(t1, vmem); else CMEQQ_0_8(t1, vmem);
+        pcmpstr_tobits(dyn, ninst, t1, t2, word, s3);
+        ORRw_mask(s3, s3, word?24:16, 0);
+        RBITw(s3, s3);
+        CLZw(s3, s3);
+    }
+    // invalid element masks
+    TABLE64C(s4, const_16b_index);
+    VLDR128_U12(t1, s4, 0);
+    if(word) {
+        UXTL_8(t1, t1);
+        VDUPQH(nvr, s2);
+        VCMHSQ_16(nvr, t1, nvr);
+        VDUPQH(nvm, s3);
+        VCMHSQ_16(nvm, t1, nvm);
+    } else {
+        VDUPQB(nvr, s2);
+        VCMHSQ_8(nvr, t1, nvr);
+        VDUPQB(nvm, s3);
+        VCMHSQ_8(nvm, t1, nvm);
+    }
+    // aggregation, acc lanes are the mem elements
+    switch((imm8>>2)&3) {
+        case 0b00:  // equal any
+            VEORQ(acc, acc, acc);
+            for(int i=0; i<n; ++i) {
+                if(word) {
+                    VDUPQ_16(t1, vreg, i);
+                    VCMEQQ_16(t1, t1, vmem);
+                    VDUPQ_16(t2, nvr, i);
+                } else {
+                    VDUPQ_8(t1, vreg, i);
+                    VCMEQQ_8(t1, t1, vmem);
+                    VDUPQ_8(t2, nvr, i);
+                }
+                VBICQ(t1, t1, t2);
+                VORRQ(acc, acc, t1);
+            }
+            VBICQ(acc, acc, nvm);
+            break;
+        case 0b01:  // ranges
+            VEORQ(acc, acc, acc);
+            for(int i=0; i<n; i+=2) {
+                if(word) {
+                    VDUPQ_16(t1, vreg, i);
+                    VDUPQ_16(t2, vreg, i+1);
+                    if(imm8&2) {
+                        VCMGEQ_16(t1, vmem, t1);
+                        VCMGEQ_16(t2, t2, vmem);
+                    } else {
+                        VCMHSQ_16(t1, vmem, t1);
+                        VCMHSQ_16(t2, t2, vmem);
+                    }
+                    VANDQ(t1, t1, t2);
+                    VDUPQ_16(t2, nvr, i+1);
+                } else {
+                    VDUPQ_8(t1, vreg, i);
+                    VDUPQ_8(t2, vreg, i+1);
+                    if(imm8&2) {
+                        VCMGEQ_8(t1, vmem, t1);
+                        VCMGEQ_8(t2, t2, vmem);
+                    } else {
+                        VCMHSQ_8(t1, vmem, t1);
+                        VCMHSQ_8(t2, t2, vmem);
+                    }
+                    VANDQ(t1, t1, t2);
+                    VDUPQ_8(t2, nvr, i+1);
+                }
+                VBICQ(t1, t1, t2);
+                VORRQ(acc, acc, t1);
+            }
+            VBICQ(acc, acc, nvm);
+            break;
+        case 0b10:  // equal each
+            if(word) VCMEQQ_16(acc, vreg, vmem); else VCMEQQ_8(acc, vreg, vmem);
+            VBICQ(acc, acc, nvr);
+            VBICQ(acc, acc, nvm);
+            VANDQ(t1, nvr, nvm);    // both invalid is true
+            VORRQ(acc, acc, t1);
+            break;
+        case 0b11:  // equal ordered
+            // acc[j] = AND(i<n-j) of (reg[i] invalid || (mem[i+j] valid && reg[i]==mem[i+j]))
+            {
+                int vz = fpu_get_scratch(dyn, ninst);
+                int vo = fpu_get_scratch(dyn, ninst);
+                MOVIQ_8(acc, 0xff);
+                MOVIQ_8(vo, 0xff);
+                VEORQ(vz, vz, vz);
+                for(int i=0; i<n; ++i) {
+                    if(word) VDUPQ_16(t1, vreg, i); else VDUPQ_8(t1, vreg, i);
+                    if(i) {
+                        // elements beyond n-i are wrapped, but forced to true just after
+                        VEXTQ_8(t2, vmem, vmem, i*es);
+                        if(word) VCMEQQ_16(t1, t1, t2); else VCMEQQ_8(t1, t1, t2);
+                        VEXTQ_8(t2, nvm, nvm, i*es);
+                        VBICQ(t1, t1, t2);
+                        VEXTQ_8(t2, vz, vo, i*es);
+                        VORRQ(t1, t1, t2);
+                    } else {
+                        if(word) VCMEQQ_16(t1, t1, vmem); else VCMEQQ_8(t1, t1, vmem);
+                        VBICQ(t1, t1, nvm);
+                    }
+                    if(word) VDUPQ_16(t2, nvr, i); else VDUPQ_8(t2, nvr, i);
+                    VORRQ(t1, t1, t2);
+                    VANDQ(acc, acc, t1);
+                }
+            }
+            break;
+    }
+    // intres2
+    switch((imm8>>4)&3) {
+        case 0b01:  // negate all
+            VMVNQ(acc, acc);
+            break;
+        case 0b11:  // negate valid mem elements only
+            VEORQ(acc, acc, nvm);
+            VMVNQ(acc, acc);
+            break;
+    }
+    TABLE64C(s4, const_16b_bits);
+    VLDR128_U12(t2, s4, 0);
+    VMOVQ(t1, acc);
+    pcmpstr_tobits(dyn, ninst, t1, t2, word, s1);
+    // flags
+    IFX(X_ALL) {
+        SET_DFNONE();
+        IFX(X_CF) {
+            CMPSw_REG(s1, xZR);
+            CSETw(s4, cNE);
+            BFIw(xFlags, s4, F_CF, 1);
+        }
+        IFX(X_ZF|X_SF) {
+            MOV32w(s4, n);
+            IFX(X_ZF) {
+                CMPSw_REG(s3, s4);
+                CSETw(s5, cLT);
+                BFIw(xFlags, s5, F_ZF, 1);
+            }
+            IFX(X_SF) {
+                CMPSw_REG(s2, s4);
+                CSETw(s5, cLT);
+                BFIw(xFlags, s5, F_SF, 1);
+            }
+        }
+        IFX(X_OF) {
+            BFIw(xFlags, s1, F_OF, 1);
+        }
+        IFX(X_AF) {
+            BFCw(xFlags, F_AF, 1);
+        }
+        IFX(X_PF) {
+            BFCw(xFlags, F_PF, 1);
+        }
+    }
+    return acc;
+}
+
 void arm64_move32(dynarec_arm_t* dyn, int ninst, int reg, uint32_t val)
 {
     // simple cases with only 1 operations
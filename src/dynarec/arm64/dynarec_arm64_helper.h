@@ -919,6 +919,14 @@
 #define CBZx_MARKLOCK(reg)             \
     j64 = GETMARKLOCK-(dyn->native_size);  \
     CBZx(reg, j64)
+// Branch to MARKF if cond (use j64)
+#define B_MARKF(cond)                   \
+    j64 = GETMARKF-(dyn->native_size);  \
+    Bcond(cond, j64)
+// Branch to MARKF unconditionnal (use j64)
+#define B_MARKF_nocond                  \
+    j64 = GETMARKF-(dyn->native_size);  \
+    B(j64)
 
 #ifndef IFNATIVE
 #define IFNATIVE(A)     if(dyn->insts[ninst].need_nat_flags&(A))
@@ -993,6 +1001,12 @@
 #define IF_ALIGNED(A) if (!dyn->insts[ninst].unaligned)
 #endif
 
+// use LDAPR/STLR (RCpc) for the plain MOV, instead of the strongmem barriers
+#define STRONGMEM_RCPC() (STRONGMEM_LEVEL() && cpuext.lrcpc)
+
+// SVE paths are opt-in (BOX64_DYNAREC_SVE) until they have seen more testing
+#define USE_SVE()       (cpuext.sve && BOX64DRENV(dynarec_sve))
+
 #ifndef CALLRET_RET
 #define CALLRET_RET()   NOP
 #endif
@@ -1440,6 +1454,7 @@
 #define emit_shld16     STEPNAME(emit_shld16)
 
 #define emit_pf         STEPNAME(emit_pf)
+#define emit_pcmpstr    STEPNAME(emit_pcmpstr)
 
 #define x87_do_push         STEPNAME(x87_do_push)
 #define x87_do_push_empty   STEPNAME(x87_do_push_empty)
@@ -1611,6 +1626,7 @@ void emit_shld16c(dynarec_arm_t* dyn, int ninst, int s1, int s2, uint32_t c, int
 void emit_shld16(dynarec_arm_t* dyn, int ninst, int s1, int s2, int s5, int s3, int s4);
 
 void emit_pf(dynarec_arm_t* dyn, int ninst, int s1, int s4);
+int emit_pcmpstr(dynarec_arm_t* dyn, int ninst, rex_t rex, int vreg, int vmem, uint8_t imm8, int explicit_len, int s1, int s2, int s3, int s4, int s5);
 
 // x87 helper
 // cache of the local stack counter, to avoid update at every call, return old internal stack counter
@@ -24,6 +24,7 @@
 #include "custommem.h"
 #include "khash.h"
 #include "rbtree.h"
+#include "stats.h"
 
 uint32_t X31_hash_code(void* addr, int len)
 {
@@ -43,13 +44,14 @@ dynablock_t* InvalidDynablock(dynablock_t* db, int need_lock)
         if(db->gone)
             return NULL; // already in the process of deletion!
         dynarec_log(LOG_DEBUG, "InvalidDynablock(%p), db->block=%p x64=%p:%p already gone=%d\n", db, db->block, db->x64_addr, db->x64_addr+db->x64_size-1, db->gone);
+        STAT_INC(STAT_BLOCK_INVALIDATED);
         // remove jumptable without waiting
         setJumpTableDefault64(db->x64_addr);
         if(need_lock)
             mutex_lock(&my_context->mutex_dyndump);
         db->done = 0;
         db->gone = 1;
-        uintptr_t db_size = db->x64_size;
+        uintptr_t db_size = db->hash_size;
         #ifdef ARCH_NOP
         if(db->callret_size) {
             // mark all callrets to UDF
@@ -80,6 +82,7 @@ dynablock_t* SwitchDynablock(dynablock_t* db, int need_lock)
         // remove jumptable without waiting
         dynablock_t* db_new = db->previous;
         db->previous = NULL;
+        STAT_INC(STAT_BLOCK_SWITCHED);
         if(need_lock)
             mutex_lock(&my_context->mutex_dyndump);
         InvalidDynablock(db, 0);
@@ -107,7 +110,8 @@ void FreeInvalidDynablock(dynablock_t* db, int need_lock)
         if(!db->gone)
             return; // already in the process of deletion!
         dynarec_log(LOG_DEBUG, "FreeInvalidDynablock(%p), db->block=%p x64=%p:%p already gone=%d\n", db, db->block, db->x64_addr, db->x64_addr+db->x64_size-1, db->gone);
-        uintptr_t db_size = db->x64_size;
+        STAT_INC(STAT_BLOCK_FREED);
+        uintptr_t db_size = db->hash_size;
         if(need_lock)
             mutex_lock(&my_context->mutex_dyndump);
         if(db_size && my_context && BOX64ENV(dynarec_dirty)) {
@@ -129,6 +133,7 @@ void FreeDynablock(dynablock_t* db, int need_lock, int need_remove)
         if(db->gone)
             return; // already in the process of deletion!
         dynarec_log(LOG_DEBUG, "FreeDynablock(%p), db->block=%p x64=%p:%p already gone=%d\n", db, db->block, db->x64_addr, db->x64_addr+db->x64_size-1, db->gone);
+        STAT_INC(STAT_BLOCK_FREED);
         // remove jumptable without waiting
         if(need_remove)
             setJumpTableDefault64(db->x64_addr);
@@ -137,7 +142,7 @@ void FreeDynablock(dynablock_t* db, int need_lock, int need_remove)
         dynarec_log(LOG_DEBUG, " -- FreeDyrecMap(%p, %d)\n", db->actual_block, db->size);
         db->done = 0;
         db->gone = 1;
-        uintptr_t db_size = db->x64_size;
+        uintptr_t db_size = db->hash_size;
         if(db_size && my_context) {
             uint32_t n = rb_dec(my_context->db_sizes, db_size, db_size+1);
             if(!n && (db_size >= my_context->max_db_size)) {
@@ -195,8 +200,8 @@ void MarkRangeDynablock(dynablock_t* db, uintptr_t addr, uintptr_t size)
     // Mark will try to find *any* blocks that intersect the range to mark
     if(!db)
         return;
-    dynarec_log(LOG_DEBUG, "MarkRangeDynablock %p-%p .. startdb=%p, sizedb=%p\n", (void*)addr, (void*)addr+size-1, (void*)db->x64_addr, (void*)db->x64_size);
-    if(IntervalIntersects((uintptr_t)db->x64_addr, (uintptr_t)db->x64_addr+db->x64_size-1, addr, addr+size+1))
+    dynarec_log(LOG_DEBUG, "MarkRangeDynablock %p-%p .. startdb=%p, sizedb=%p\n", (void*)addr, (void*)addr+size-1, (void*)db->x64_addr, (void*)db->hash_size);
+    if(IntervalIntersects((uintptr_t)db->x64_addr, (uintptr_t)db->x64_addr+db->hash_size-1, addr, addr+size+1))
         MarkDynablock(db);
 }
 
@@ -206,13 +211,43 @@ int FreeRangeDynablock(dynablock_t* db, uintptr_t addr, uintptr_t size)
         return 1;
 
     int need_lock = my_context?1:0;
-    if(IntervalIntersects((uintptr_t)db->x64_addr, (uintptr_t)db->x64_addr+db->x64_size-1, addr, addr+size+1)) {
+    if(IntervalIntersects((uintptr_t)db->x64_addr, (uintptr_t)db->x64_addr+db->hash_size-1, addr, addr+size+1)) {
         FreeDynablock(db, need_lock, 1);
         return 0;
     }
     return 1;
 }
 
+static int dynablock_mt = 0;       // process has (or had) more than 1 thread
+static int dynablock_weakmem = 0;  // at least 1 block has been built without strongmem barriers
+
+int DynablockIsStale(dynablock_t* db)
+{
+    return db->weakmem && native_lock_get_d(&dynablock_mt);
+}
+
+void DynablockSetWeakmem(void)
+{
+    dynablock_weakmem = 1;
+}
+
+int DynablockWeakmem(void)
+{
+    return !native_lock_get_d(&dynablock_mt);
+}
+
+void DynablockGoMultithread(void)
+{
+    if(native_lock_get_d(&dynablock_mt))
+        return;
+    if(native_lock_xchg_d(&dynablock_mt, 1) || !dynablock_weakmem)
+        return;
+    dynarec_log(LOG_INFO, "BOX64 Dynarec: process is now multithreaded, rebuilding blocks with strongmem barriers\n");
+    mutex_lock(&my_context->mutex_dyndump);
+    markWeakmemDB();
+    mutex_unlock(&my_context->mutex_dyndump);
+}
+
 NEW_JUMPBUFF(dynarec_jmpbuf);
 
 void cancelFillBlock()
@@ -264,27 +299,35 @@ static dynablock_t* internalDBGetBlock(x64emu_t* emu, uintptr_t addr, uintptr_t
             mutex_unlock(&my_context->mutex_dyndump);
         return NULL;
     }
+    uint64_t fill_start = BOX64ENV(stats)?StatsTicks():0;
     block = FillBlock64(filladdr, (addr==filladdr)?0:1, is32bits, MAX_INSTS, is_new);
+    if(BOX64ENV(stats)) {
+        STAT_ADD(STAT_FILLBLOCK_TICKS, StatsTicks()-fill_start);
+        if(block)
+            STAT_INC(STAT_BLOCK_CREATED);
+    }
     if(!block) {
         dynarec_log(LOG_DEBUG, "Fillblock of block %p for %p returned an error\n", block, (void*)addr);
     }
     // check size
     if(block) {
+        if(block->weakmem)
+            dynablock_weakmem = 1;
         // fill-in jumptable
-        if(!addJumpTableIfDefault64(block->x64_addr, (block->dirty || block->always_test)?block->jmpnext:block->block)) {
+        if(!addJumpTableIfDefault64(block->x64_addr, (block->dirty || block->always_test || (block->weakmem && dynablock_mt))?block->jmpnext:block->block)) {
             FreeDynablock(block, 0, 0);
             block = getDB(addr);
             MarkDynablock(block);   // just in case...
         } else {
             if(block->dirty)
                 block->dirty = 0;
-            if(block->x64_size) {
-                if(block->x64_size>my_context->max_db_size) {
-                    my_context->max_db_size = block->x64_size;
+            if(block->hash_size) {
+                if(block->hash_size>my_context->max_db_size) {
+                    my_context->max_db_size = block->hash_size;
                     dynarec_log(LOG_INFO, "BOX64 Dynarec: higher max_db=%d\n", my_context->max_db_size);
                 }
                 block->done = 1;    // don't validate the block if the size is null, but keep the block
-                rb_inc(my_context->db_sizes, block->x64_size, block->x64_size+1);
+                rb_inc(my_context->db_sizes, block->hash_size, block->hash_size+1);
             }
         }
     }
@@ -299,17 +342,22 @@ static dynablock_t* internalDBGetBlock(x64emu_t* emu, uintptr_t addr, uintptr_t
 dynablock_t* DBGetBlock(x64emu_t* emu, uintptr_t addr, int create, int is32bits)
 {
     int is_inhotpage = isInHotPage(addr);
-    if(is_inhotpage && !BOX64ENV(dynarec_dirty))
+    if(is_inhotpage && !BOX64ENV(dynarec_dirty)) {
+        STAT_INC(STAT_HOTPAGE_HIT);
         return NULL;
+    }
     dynablock_t *db = internalDBGetBlock(emu, addr, addr, create, 1, is32bits, 1);
     if(db && db->done && db->block && getNeedTest(addr)) {
         //if (db->always_test) SchedYield(); // just calm down...
-        uint32_t hash = X31_hash_code(db->x64_addr, db->x64_size);
+        uint32_t hash = X31_hash_code(db->x64_addr, db->hash_size);
         int need_lock = mutex_trylock(&my_context->mutex_dyndump);
-        if(hash!=db->hash) {
-            if(is_inhotpage && db->previous) {
+        int stale = db->weakmem && dynablock_mt;    // built without strongmem barriers, but process is now multithreaded
+        if(hash!=db->hash || stale) {
+            if(db->always_test && hash!=db->hash)
+                NoteHotPageWrite((uintptr_t)db->x64_addr);
+            if(is_inhotpage && db->previous && !stale) {
                 // check alternate
-                if(db->previous && !db->dirty && X31_hash_code(db->previous->x64_addr, db->previous->x64_size)==db->previous->hash) {
+                if(db->previous && !db->dirty && X31_hash_code(db->previous->x64_addr, db->previous->hash_size)==db->previous->hash) {
                     db = SwitchDynablock(db, need_lock);
                     if(!addJumpTableIfDefault64(db->x64_addr, (db->always_test)?db->jmpnext:db->block)) {
                         FreeDynablock(db, 0, 0);
@@ -337,6 +385,8 @@ dynablock_t* DBGetBlock(x64emu_t* emu, uintptr_t addr, int create, int is32bits)
             } else
                 FreeInvalidDynablock(old, need_lock);
         } else {
+            if(db->weakmem)
+                dynablock_weakmem = 1;
             if(is_inhotpage) {
                 db->always_test = 2;
                 // log?
@@ -345,7 +395,7 @@ dynablock_t* DBGetBlock(x64emu_t* emu, uintptr_t addr, int create, int is32bits)
                 if(db->always_test) {
                     if(db->always_test==2)
                         db->always_test = 0;
-                    protectDB((uintptr_t)db->x64_addr, db->x64_size);
+                    protectDB((uintptr_t)db->x64_addr, db->hash_size);
                 } else {
                     #ifdef ARCH_NOP
                     if(db->callret_size) {
@@ -355,7 +405,7 @@ dynablock_t* DBGetBlock(x64emu_t* emu, uintptr_t addr, int create, int is32bits)
                         ClearCache(db->block, db->size);
                     }
                     #endif
-                    protectDBJumpTable((uintptr_t)db->x64_addr, db->x64_size, db->block, db->jmpnext);
+                    protectDBJumpTable((uintptr_t)db->x64_addr, db->hash_size, db->block, db->jmpnext);
                 }
             }
         }
@@ -375,8 +425,8 @@ dynablock_t* DBAlternateBlock(x64emu_t* emu, uintptr_t addr, uintptr_t filladdr,
     if(db && db->done && db->block && (db->dirty || getNeedTest(filladdr))) {
         if (db->always_test) SchedYield(); // just calm down...
         int need_lock = mutex_trylock(&my_context->mutex_dyndump);
-        uint32_t hash = X31_hash_code(db->x64_addr, db->x64_size);
-        if(hash!=db->hash) {
+        uint32_t hash = X31_hash_code(db->x64_addr, db->hash_size);
+        if(hash!=db->hash || (db->weakmem && dynablock_mt)) {
             db->done = 0;   // invalidating the block
             dynarec_log(LOG_DEBUG, "Invalidating alt block %p from %p:%p (hash:%X/%X) for %p\n", db, db->x64_addr, db->x64_addr+db->x64_size, hash, db->hash, (void*)addr);
             // Free db, it's now invalid!
@@ -390,8 +440,10 @@ dynablock_t* DBAlternateBlock(x64emu_t* emu, uintptr_t addr, uintptr_t filladdr,
             } else
                 FreeInvalidDynablock(old, need_lock);
         } else {
+            if(db->weakmem)
+                dynablock_weakmem = 1;
             if(db->always_test)
-                protectDB((uintptr_t)db->x64_addr, db->x64_size);
+                protectDB((uintptr_t)db->x64_addr, db->hash_size);
             else {
                 #ifdef ARCH_NOP
                 if(db->callret_size) {
@@ -401,7 +453,7 @@ dynablock_t* DBAlternateBlock(x64emu_t* emu, uintptr_t addr, uintptr_t filladdr,
                     ClearCache(db->block, db->size);
                 }
                 #endif
-                protectDBJumpTable((uintptr_t)db->x64_addr, db->x64_size, db->block, db->jmpnext);
+                protectDBJumpTable((uintptr_t)db->x64_addr, db->hash_size, db->block, db->jmpnext);
             }
         }
         if(!need_lock)
@@ -412,6 +464,21 @@ dynablock_t* DBAlternateBlock(x64emu_t* emu, uintptr_t addr, uintptr_t filladdr,
     return db;
 }
 
+// index of the last checkpoint with an offset <= off (native or x64 side), -1 if none
+static int lastInstCheck(dynablock_t* db, uintptr_t off, int native)
+{
+    int lo = 0;
+    int hi = db->instcheck ? db->instcheck_size : 0;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if ((native ? db->instcheck[mid].nat : db->instcheck[mid].x64) <= off)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo - 1;
+}
+
 uintptr_t getX64Address(dynablock_t* db, uintptr_t native_addr)
 {
     uintptr_t x64addr = (uintptr_t)db->x64_addr;
@@ -419,6 +486,12 @@ uintptr_t getX64Address(dynablock_t* db, uintptr_t native_addr)
     if ((native_addr < (uintptr_t)db->block) || (native_addr > (uintptr_t)db->actual_block + db->size))
         return 0;
     int i = 0;
+    int k = lastInstCheck(db, native_addr - armaddr, 1);
+    if (k >= 0) {
+        i = db->instcheck[k].idx;
+        x64addr += db->instcheck[k].x64;
+        armaddr += db->instcheck[k].nat;
+    }
     do {
         int x64sz = 0;
         int armsz = 0;
@@ -444,6 +517,13 @@ int getX64AddressInst(dynablock_t* db, uintptr_t x64pc)
     if (x64pc < (uintptr_t)db->x64_addr || x64pc > (uintptr_t)db->x64_addr + db->x64_size)
         return -1;
     int i = 0;
+    int k = lastInstCheck(db, x64pc - x64addr, 0);
+    if (k >= 0) {
+        i = db->instcheck[k].idx;
+        x64addr += db->instcheck[k].x64;
+        armaddr += db->instcheck[k].nat;
+        ret = (k + 1) * INSTCHECK_STEP;
+    }
     do {
         int x64sz = 0;
         int armsz = 0;
@@ -6,6 +6,14 @@ typedef struct instsize_s {
     unsigned char nat:4;
 } instsize_t;
 
+// sparse checkpoint in instsize, to find an instruction without decoding the array from the start
+typedef struct instcheck_s {
+    uint32_t    idx;    // index in instsize
+    uint32_t    x64;    // offset from x64_addr
+    uint32_t    nat;    // offset from block
+} instcheck_t;
+#define INSTCHECK_STEP  16  // one checkpoint every 16 instructions
+
 typedef struct callret_s {
     uint32_t    offs:31;
     uint32_t    type:1;
@@ -17,6 +25,7 @@ typedef struct dynablock_s {
     struct dynablock_s*    previous;   // a previous block that might need to be freed
     void*           x64_addr;
     uintptr_t       x64_size;
+    uintptr_t       hash_size;  // size of the hashed (and protected / tracked) x64 range, can include the flags_kill start of a following block
     size_t          native_size;
     int             size;
     uint32_t        hash;
@@ -25,10 +34,14 @@ typedef struct dynablock_s {
     uint8_t         dirty;      // if need to be tested as soon as it's created
     uint8_t         always_test:2;
     uint8_t         is32bits:1;
+    uint8_t         weakmem:1;  // built without the strongmem barriers (BOX64_DYNAREC_STRONGMEM_MT)
+    uint8_t         flags_kill; // x64 size of the start of the block that overwrites all the flags before reading them (0 if incoming flags might be read)
     int             callret_size;   // size of the array
     int             isize;
     size_t          arch_size;  // size of of arch dependant infos
     instsize_t*     instsize;
+    int             instcheck_size;
+    instcheck_t*    instcheck;  // checkpoints in instsize (can be NULL)
     void*           arch;       // arch dependant per inst info (can be NULL)
     callret_t*      callrets;   // array of callret return, with NOP / UDF depending if the block is clean or dirty
     void*           jmpnext;    // a branch jmpnext code when block is marked
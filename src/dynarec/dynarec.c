@@ -22,6 +22,7 @@
 #include "dynarec_next.h"
 #include "custommem.h"
 #include "x64test.h"
+#include "stats.h"
 #endif
 #ifdef HAVE_TRACE
 #include "elfloader.h"
@@ -62,6 +63,7 @@ void* LinkNext(x64emu_t* emu, uintptr_t addr, void* x2, uintptr_t* x3)
     } else
         block = DBGetBlock(emu, addr, 1, is32bits);
     if(!block) {
+        STAT_INC(STAT_LINKNEXT_MISS);
         #ifdef HAVE_TRACE
         if(LOG_INFO<=BOX64ENV(dynarec_log)) {
             if(checkInHotPage(addr)) {
@@ -78,6 +80,7 @@ void* LinkNext(x64emu_t* emu, uintptr_t addr, void* x2, uintptr_t* x3)
     }
     if(!block->done) {
         // not finished yet... leave linker
+        STAT_INC(STAT_LINKNEXT_MISS);
         #ifdef HAVE_TRACE
         if(BOX64ENV(dynarec_log) && !block->isize) {
             dynablock_t* db = FindDynablockFromNativeAddress(x2-4);
@@ -160,10 +163,11 @@ void DynaRun(x64emu_t* emu)
             emu->old_savedsp = emu->xSPSave;
             #endif
             emu->flags.jmpbuf_ready = 1;
+            // no signal mask saved here, the signal handler restores the one of the interrupted context (see restoreSigMask)
             #ifdef ANDROID
-            if ((skip = SigSetJmp(*(JUMPBUFF*)emu->jmpbuf, 1)))
+            if ((skip = SigSetJmp(*(JUMPBUFF*)emu->jmpbuf, 0)))
             #else
-            if ((skip = SigSetJmp(emu->jmpbuf, 1)))
+            if ((skip = SigSetJmp(emu->jmpbuf, 0)))
             #endif
             {
                 printf_log(LOG_DEBUG, "Setjmp DynaRun, fs=0x%x\n", emu->segs[_FS]);
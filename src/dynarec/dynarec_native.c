@@ -259,6 +259,96 @@ int next_instruction(dynarec_native_t *dyn, uintptr_t addr)
     }
     return -1;
 }
+// minimal lifting of an x64 instruction for the constant propagation:
+// CP_CONST write value in reg dst, CP_COPY copy reg src in reg dst (value is 1 for a 64bits copy), CP_NODEF doesn't write any general register
+#define CP_UNKNOWN  0
+#define CP_NODEF    1
+#define CP_CONST    2
+#define CP_COPY     3
+static int liftInst(uintptr_t addr, int is32bits, int* dst, int* src, uint64_t* val)
+{
+    rex_t rex = {0};
+    if(!is32bits)
+        while(PK(0)>=0x40 && PK(0)<=0x4f) {
+            rex.rex = PK(0);
+            ++addr;
+        }
+    uint8_t opcode = PK(0);
+    uint8_t nextop = PK(1);
+    int reg = ((nextop>>3)&7)+(rex.r<<3);
+    int rm = (nextop&7)+(rex.b<<3);
+    switch(opcode) {
+        case 0x29:  // SUB Ed, Gd
+        case 0x2B:  // SUB Gd, Ed
+        case 0x31:  // XOR Ed, Gd
+        case 0x33:  // XOR Gd, Ed
+            if(((nextop&0xC0)==0xC0) && reg==rm) {
+                *dst = reg;
+                *val = 0;
+                return CP_CONST;
+            }
+            return CP_UNKNOWN;
+        case 0x38:  // CMP Eb, Gb
+        case 0x39:  // CMP Ed, Gd
+        case 0x3A:  // CMP Gb, Eb
+        case 0x3B:  // CMP Gd, Ed
+        case 0x3C:  // CMP AL, Ib
+        case 0x3D:  // CMP EAX, Id
+        case 0x84:  // TEST Eb, Gb
+        case 0x85:  // TEST Ed, Gd
+        case 0xA8:  // TEST AL, Ib
+        case 0xA9:  // TEST EAX, Id
+            return CP_NODEF;
+        case 0x70 ... 0x7F: // Jcc
+            return CP_NODEF;
+        case 0x80:
+        case 0x81:
+        case 0x83:
+            return (((nextop>>3)&7)==7)?CP_NODEF:CP_UNKNOWN;    // CMP Ed, Ix
+        case 0x88:  // MOV Eb, Gb
+        case 0x89:  // MOV Ed, Gd
+            if(!((nextop&0xC0)==0xC0))
+                return CP_NODEF;
+            if(opcode==0x88)
+                return CP_UNKNOWN;
+            *dst = rm;
+            *src = reg;
+            *val = rex.w;
+            return CP_COPY;
+        case 0x8B:  // MOV Gd, Ed
+            if(!((nextop&0xC0)==0xC0))
+                return CP_UNKNOWN;
+            *dst = reg;
+            *src = rm;
+            *val = rex.w;
+            return CP_COPY;
+        case 0x90:
+            return rex.b?CP_UNKNOWN:CP_NODEF;   // XCHG with R8 is not a NOP
+        case 0xB8 ... 0xBF: // MOV Reg, Id
+            *dst = (opcode&7)+(rex.b<<3);
+            *val = rex.w?*(uint64_t*)(addr+1):*(uint32_t*)(addr+1);
+            return CP_CONST;
+        case 0xC6:  // MOV Eb, Ib
+            return (!((nextop&0xC0)==0xC0) && !((nextop>>3)&7))?CP_NODEF:CP_UNKNOWN;
+        case 0xC7:  // MOV Ed, Id
+            if((nextop>>3)&7)
+                return CP_UNKNOWN;
+            if(!((nextop&0xC0)==0xC0))
+                return CP_NODEF;
+            *dst = rm;
+            *val = rex.w?(uint64_t)(int64_t)*(int32_t*)(addr+2):*(uint32_t*)(addr+2);
+            return CP_CONST;
+        case 0x0F:
+            if(nextop>=0x80 && nextop<=0x8F)    // Jcc
+                return CP_NODEF;
+            if(nextop==0x1F)    // NOP
+                return CP_NODEF;
+            return CP_UNKNOWN;
+        default:
+            return CP_UNKNOWN;
+    }
+}
+
 #undef PK
 
 int is_instructions(dynarec_native_t *dyn, uintptr_t addr, int n)
@@ -296,6 +386,30 @@ void addInst(instsize_t* insts, size_t* size, int x64_size, int native_size)
     }
 }
 
+int fillInstCheck(instsize_t* insts, instcheck_t* check, int max)
+{
+    int n = 0;
+    int ninst = 0;
+    int i = 0;
+    uint32_t x64 = 0;
+    uint32_t nat = 0;
+    while((insts[i].x64 || insts[i].nat) && n<max) {
+        do {
+            x64 += insts[i].x64;
+            nat += insts[i].nat*4;
+            ++i;
+        } while((insts[i-1].x64==15) || (insts[i-1].nat==15));
+        // no checkpoint on the end marker
+        if(!(++ninst%INSTCHECK_STEP) && (insts[i].x64 || insts[i].nat)) {
+            check[n].idx = i;
+            check[n].x64 = x64;
+            check[n].nat = nat;
+            ++n;
+        }
+    }
+    return n;
+}
+
 static kh_table64_t* khtable64 = NULL;
 
 int isTable64(dynarec_native_t *dyn, uint64_t val)
@@ -444,6 +558,85 @@ static int updateNeed(dynarec_native_t* dyn, int ninst, uint8_t need) {
     return ninst;
 }
 
+// forward constant propagation on general registers, on straight line parts of the block (any join point resets it).
+// Only a few instructions are lifted, anything else clobbers everything. The result is used by MOV Reg, Imm:
+// no need to load a value already in the register, and a 64bits value close to another one can be an ADD/SUB
+static void updateConsts(dynarec_native_t* dyn, int is32bits)
+{
+    uint16_t known = 0;
+    uint64_t val[16];
+    int enabled = BOX64DRENV(dynarec_constprop);
+    for(int i=0; i<dyn->size; ++i) {
+        instruction_x64_t* x64 = &dyn->insts[i].x64;
+        x64->const_reg = 0;
+        x64->const_delta = 0;
+        if(!enabled)
+            continue;
+        if(!i || dyn->insts[i].pred_sz!=1 || dyn->insts[i].pred[0]!=i-1 || x64->barrier)
+            known = 0;
+        int dst = 0, src = 0;
+        uint64_t v = 0;
+        switch(liftInst(x64->addr, is32bits, &dst, &src, &v)) {
+            case CP_CONST:
+                if((known&(1<<dst)) && val[dst]==v)
+                    x64->const_reg = 1+dst;
+                else if(v>0xffff && ~v>0xffff) // not a single MOVZ/MOVN
+                    for(int k=0; k<16 && !x64->const_reg; ++k)
+                        if((known&(1<<k)) && (val[k]-v+0xfff)<0x1fff) {
+                            x64->const_reg = 1+k;
+                            x64->const_delta = v-val[k];
+                        }
+                known |= 1<<dst;
+                val[dst] = v;
+                break;
+            case CP_COPY:
+                if(known&(1<<src)) {
+                    known |= 1<<dst;
+                    val[dst] = v?val[src]:(uint32_t)val[src];  // 32bits copy zero the upper part
+                } else
+                    known &= ~(1<<dst);
+                break;
+            case CP_NODEF:
+                break;
+            default:
+                known = 0;
+        }
+        if(!x64->has_next)
+            known = 0;
+    }
+}
+
+// x64 size of the start of the block that overwrites all the flags before reading them (0 if incoming flags might be read)
+static uint8_t getFlagsKill(dynarec_native_t* dyn)
+{
+    for(int i=0; i<dyn->size; ++i) {
+        instruction_x64_t* x64 = &dyn->insts[i].x64;
+        if(x64->use_flags || x64->may_set)
+            return 0;
+        if(x64->set_flags) {
+            // only a full set that also resets the deferred flags state
+            if((x64->set_flags&X_ALL)!=X_ALL || x64->state_flags!=SF_SET_PENDING)
+                return 0;
+            uintptr_t sz = x64->addr+x64->size-dyn->start;
+            return (sz<256)?sz:0;
+        }
+        if(x64->jmp || !x64->has_next || x64->barrier)
+            return 0;
+    }
+    return 0;
+}
+
+// end of the x64 code the existing block at addr relies on to overwrite all the flags, 0 if the flags might be read there
+static uintptr_t getFlagsKillEnd(uintptr_t addr, int is32bits)
+{
+    dynablock_t* db = getDB(addr);
+    if(!db || !db->done || db->dirty || db->always_test || !db->flags_kill || db->x64_addr!=(void*)addr || db->is32bits!=is32bits)
+        return 0;
+    if(X31_hash_code(db->x64_addr, db->hash_size)!=db->hash)
+        return 0;
+    return addr+db->flags_kill;
+}
+
 static void updateYmm0s(dynarec_native_t* dyn, int ninst, int max_ninst_reached) {
     int can_incr = ninst == max_ninst_reached; // Are we the top-level call?
     int ok = 1;
@@ -586,7 +779,7 @@ uintptr_t native_pass3(dynarec_native_t* dyn, uintptr_t addr, int alternate, int
 
 dynablock_t* CreateEmptyBlock(uintptr_t addr, int is32bits, int is_new) {
     size_t sz = 4*sizeof(void*) + sizeof(dynablock_t);
-    void* actual_p = (void*)AllocDynarecMap(addr, sz, is_new);
+    void* actual_p = (void*)AllocDynarecMap(addr, sz, is_new, 0);
     void* p = actual_p + sizeof(void*);
     if(actual_p==NULL) {
         dynarec_log(LOG_INFO, "AllocDynarecMap(%p, %zu) failed, canceling block\n", (void*)addr, sz);
@@ -624,7 +817,8 @@ dynablock_t* FillBlock64(uintptr_t addr, int alternate, int is32bits, int inst_m
         B+16 .. B+23    : jmpnext (or jmp_epilog) address. jumpnext is used when the block needs testing
         B+24 .. B+31    : empty (in case an architecture needs more than 2 opcodes)
         B+32 .. B+32+sz : instsize (compressed array with each instruction length on x64 and native side)
-        C ..    C+sz    : arch: arch specific info (likes flags info) per inst (can be absent)
+        C ..    C+sz    : instcheck: checkpoints in instsize, every INSTCHECK_STEP instructions (can be absent)
+        D ..    D+sz    : arch: arch specific info (likes flags info) per inst (can be absent)
 
     */
     if(addr>=BOX64ENV(nodynarec_start) && addr<BOX64ENV(nodynarec_end)) {
@@ -665,6 +859,7 @@ dynablock_t* FillBlock64(uintptr_t addr, int alternate, int is32bits, int inst_m
     if(helper.end == helper.start)  // that means there is no mmap with a file associated to the memory
         helper.end = (uintptr_t)~0LL;
     helper.need_reloc = IsAddrNeedReloc(addr);
+    helper.weakmem = (BOX64DRENV(dynarec_strongmem) && BOX64DRENV(dynarec_strongmem_mt) && DynablockWeakmem())?1:0;
     // pass 0, addresses, x64 jump addresses, overall size of the block
     uintptr_t end = native_pass0(&helper, addr, alternate, is32bits, inst_max);
     if(helper.abort) {
@@ -686,11 +881,33 @@ dynablock_t* FillBlock64(uintptr_t addr, int alternate, int is32bits, int inst_m
         CancelBlock64(0);
         return NULL;
     }
+    // flags liveness summary of this block, for the blocks jumping here
+    uint8_t flags_kill = getFlagsKill(&helper);
+    // jumps forward to an existing block that overwrites all the flags before reading them don't need the flags.
+    // The x64 code that summary relies on is added to the hash of this block (if on the same page), so a change there
+    // also invalidates this block
+    uintptr_t hash_end = end;
+    uintptr_t page_end = ((end-1)|(box64_pagesize-1))+1;
+    for(int ii=0; ii<helper.jmp_sz; ++ii) {
+        int i = helper.jmps[ii];
+        uintptr_t j = helper.insts[i].x64.jmp;
+        uintptr_t kill_end = 0;
+        helper.insts[i].x64.jmp_killflags = 0;
+        if(j>=end && !helper.insts[i].x64.has_callret)
+            kill_end = getFlagsKillEnd(j, is32bits);
+        if(kill_end && kill_end<=page_end) {
+            helper.insts[i].x64.jmp_killflags = 1;
+            if(kill_end>hash_end)
+                hash_end = kill_end;
+        }
+    }
     // protect the block of it goes over the 1st page
     if((addr&~(box64_pagesize-1))!=(end&~(box64_pagesize-1))) // need to protect some other pages too
         protectDB(addr, end-addr);  //end is 1byte after actual end
+    // track the code chunks, so writes to data sharing the page doesn't need to invalidate the block
+    markCodeChunks(addr, hash_end-addr);
     // compute hash signature
-    uint32_t hash = X31_hash_code((void*)addr, end-addr);
+    uint32_t hash = X31_hash_code((void*)addr, hash_end-addr);
     // calculate barriers
     for(int ii=0; ii<helper.jmp_sz; ++ii) {
         int i = helper.jmps[ii];
@@ -702,7 +919,9 @@ dynablock_t* FillBlock64(uintptr_t addr, int alternate, int is32bits, int inst_m
         if(j<start || j>=end)
         #endif
         {
-            helper.insts[i].x64.need_after |= X_PEND;
+            // check again the summary, now that the hash is computed
+            if(!helper.insts[i].x64.jmp_killflags || !getFlagsKillEnd(j, is32bits))
+                helper.insts[i].x64.need_after |= X_PEND;
             if(helper.insts[i].barrier_maybe) {
                 helper.insts[i].x64.barrier|=BARRIER_FLOAT;
                 helper.insts[i].barrier_maybe = 0;
@@ -793,6 +1012,7 @@ dynablock_t* FillBlock64(uintptr_t addr, int alternate, int is32bits, int inst_m
     }
     updateYmm0s(&helper, 0, 0);
     UPDATE_SPECIFICS(&helper);
+    updateConsts(&helper, is32bits);
     // check for still valid close loop
     for(int ii=0; ii<helper.jmp_sz && !helper.always_test; ++ii) {
         int i = helper.jmps[ii];
@@ -849,18 +1069,28 @@ dynablock_t* FillBlock64(uintptr_t addr, int alternate, int is32bits, int inst_m
     }
     size_t insts_rsize = (helper.insts_size+2)*sizeof(instsize_t);
     insts_rsize = (insts_rsize+7)&~7;   // round the size...
+    int instcheck_max = helper.insts_size/INSTCHECK_STEP;
+    size_t instcheck_rsize = (instcheck_max*sizeof(instcheck_t)+7)&~7;
     size_t arch_size = ARCH_SIZE(&helper);
     size_t callret_size = helper.callret_size*sizeof(callret_t);
     size_t reloc_size = helper.reloc_size*sizeof(uint32_t);
+    // blocks with a loop inside are the hot ones: they get allocated with the other hot blocks
+    int hot = 0;
+    for(int ii=0; ii<helper.jmp_sz && !hot; ++ii) {
+        int i = helper.jmps[ii];
+        if(helper.insts[i].x64.alive && ((helper.insts[i].x64.jmp_insts!=-1 && helper.insts[i].x64.jmp_insts<=i) || helper.insts[i].x64.jmp==helper.insts[i].x64.addr))
+            hot = 1;
+    }
     // ok, now allocate mapped memory, with executable flag on
-    size_t sz = sizeof(void*) + native_size + helper.table64size*sizeof(uint64_t) + 4*sizeof(void*) + insts_rsize + arch_size + callret_size + sizeof(dynablock_t) + reloc_size;
-    //           dynablock_t*     block (arm insts)            table64               jmpnext code       instsize     arch         callrets          dynablock           relocs
-    void* actual_p = (void*)AllocDynarecMap(addr, sz, is_new);
+    size_t sz = sizeof(void*) + native_size + helper.table64size*sizeof(uint64_t) + 4*sizeof(void*) + insts_rsize + instcheck_rsize + arch_size + callret_size + sizeof(dynablock_t) + reloc_size;
+    //           dynablock_t*     block (arm insts)            table64               jmpnext code       instsize     instcheck          arch         callrets          dynablock           relocs
+    void* actual_p = (void*)AllocDynarecMap(addr, sz, is_new, hot);
     void* p = (void*)(((uintptr_t)actual_p) + sizeof(void*));
     void* tablestart = p + native_size;
     void* next = tablestart + helper.table64size*sizeof(uint64_t);
     void* instsize = next + 4*sizeof(void*);
-    void* arch = instsize + insts_rsize;
+    void* instcheck = instsize + insts_rsize;
+    void* arch = instcheck + instcheck_rsize;
     void* callrets = arch + arch_size;
     if(actual_p==NULL) {
         dynarec_log(LOG_INFO, "AllocDynarecMap(%p, %zu) failed, canceling block\n", (void*)addr, sz);
@@ -918,6 +1148,8 @@ dynablock_t* FillBlock64(uintptr_t addr, int alternate, int is32bits, int inst_m
     helper.jmps = NULL;
     // keep size of instructions for signal handling
     block->instsize = instsize;
+    block->instcheck_size = fillInstCheck(instsize, instcheck, instcheck_max);
+    block->instcheck = block->instcheck_size?instcheck:NULL;
     helper.table64 = NULL;
     helper.instsize = NULL;
     helper.predecessor = NULL;
@@ -926,6 +1158,7 @@ dynablock_t* FillBlock64(uintptr_t addr, int alternate, int is32bits, int inst_m
     block->block = p;
     block->jmpnext = next+sizeof(void*);
     block->always_test = helper.always_test;
+    block->weakmem = helper.weakmem;
     block->dirty = block->always_test;
     block->is32bits = is32bits;
     block->relocsize = helper.reloc_size*sizeof(uint32_t);
@@ -946,6 +1179,8 @@ dynablock_t* FillBlock64(uintptr_t addr, int alternate, int is32bits, int inst_m
     ClearCache(block->jmpnext, 4*sizeof(void*));
     //block->x64_addr = (void*)start;
     block->x64_size = end-start;
+    block->hash_size = hash_end-start;
+    block->flags_kill = flags_kill;
     // all done...
     if (BOX64ENV(dynarec_gdbjit) && (!BOX64ENV(dynarec_gdbjit_end) || (addr >= BOX64ENV(dynarec_gdbjit_start) && addr < BOX64ENV(dynarec_gdbjit_end)))) {
         if (BOX64ENV(dynarec_gdbjit) != 3) GdbJITBlockReady(helper.gdbjit_block);
@@ -955,7 +1190,7 @@ dynablock_t* FillBlock64(uintptr_t addr, int alternate, int is32bits, int inst_m
         #endif
     }
     ClearCache(actual_p+sizeof(void*), native_size);   // need to clear the cache before execution...
-    block->hash = X31_hash_code(block->x64_addr, block->x64_size);
+    block->hash = X31_hash_code(block->x64_addr, block->hash_size);
     // Check if something changed, to abort if it is
     if((helper.abort || (block->hash != hash))) {
         dynarec_log(LOG_DEBUG, "Warning, a block changed while being processed hash(%p:%ld)=%x/%x\n", block->x64_addr, block->x64_size, block->hash, hash);
@@ -42,6 +42,7 @@ typedef struct instruction_x64_s {
     uint8_t     has_callret:1;    // this instruction have an optimized call setup
     uint8_t     alive:1;    // this opcode gets executed (0 if dead code in that block)
     uint8_t     self_loop:1;    // this is a landing address for a self-loop (loop on itslef with no exit)
+    uint8_t     jmp_killflags:1;    // the block jumped to overwrites all the flags before reading them
     uint8_t     barrier;    // next instruction is a jump point, so no optim allowed
     uint8_t     state_flags;// One of SF_XXX state
     uint8_t     use_flags;  // 0 or combination of X_?F
@@ -50,6 +51,8 @@ typedef struct instruction_x64_s {
     uint8_t     gen_flags;  // calculated
     uint8_t     need_before;// calculated
     uint8_t     need_after; // calculated
+    uint8_t     const_reg;  // for MOV Reg, Imm: 1+reg already holding that value or a close one (0 if none), calculated
+    int16_t     const_delta;// value to add to const_reg to get the immediate, calculated
 } instruction_x64_t;
 
 #endif //__DYNAREC_PRIVATE_H_
@@ -19,6 +19,7 @@
 #include "dynarec_native.h"
 #include "custommem.h"
 #include "alternate.h"
+#include "elfloader.h"
 
 #include "la64_printer.h"
 #include "dynarec_la64_private.h"
@@ -44,6 +45,7 @@ uintptr_t dynarec64_00(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
     int unscaled;
     int lock;
     int cacheupd = 0;
+    int v0, v1;
 
     opcode = F8;
     MAYUSE(eb1);
@@ -1305,6 +1307,24 @@ uintptr_t dynarec64_00(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
                 OR(x1, xRSI, xRDI);
                 ANDI(x1, x1, 7);
                 BNEZ_MARK(x1);
+                // wide path, 32 bytes per loop, only if a chunk cannot overlap itself
+                SUB_D(x2, xRDI, xRSI);
+                ADDI_D(x6, xZR, 32);
+                BLTU_MARKF2(x2, x6);
+                v0 = fpu_get_scratch(dyn);
+                v1 = fpu_get_scratch(dyn);
+                MARKF;
+                BLTU_MARKF2(xRCX, x6);
+                VLD(v0, xRSI, 0);
+                VLD(v1, xRSI, 16);
+                VST(v0, xRDI, 0);
+                VST(v1, xRDI, 16);
+                ADDI_D(xRSI, xRSI, 32);
+                ADDI_D(xRDI, xRDI, 32);
+                ADDI_D(xRCX, xRCX, -32);
+                CBZ_NEXT(xRCX);
+                B_MARKF_nocond;
+                MARKF2;
                 ADDI_D(x6, xZR, 8);
                 MARK3;
                 BLT_MARK(xRCX, x6);
@@ -1446,6 +1466,30 @@ uintptr_t dynarec64_00(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
                 CBZ_NEXT(xRCX);
                 ANDI(x1, xFlags, 1 << F_DF);
                 BNEZ_MARK2(x1);
+                // special optim for large RCX value on forward case only
+                ANDI(x1, xRDI, 7);
+                BNEZ_MARK(x1);
+                v0 = fpu_get_scratch(dyn);
+                VREPLGR2VR_B(v0, xRAX);
+                ADDI_D(x6, xZR, 32);
+                MARKF;  // wide path, 32 bytes per loop
+                BLTU_MARKF2(xRCX, x6);
+                VST(v0, xRDI, 0);
+                VST(v0, xRDI, 16);
+                ADDI_D(xRDI, xRDI, 32);
+                ADDI_D(xRCX, xRCX, -32);
+                CBZ_NEXT(xRCX);
+                B_MARKF_nocond;
+                MARKF2;
+                ADDI_D(x6, xZR, 8);
+                VPICKVE2GR_DU(x3, v0, 0);
+                MARK3;
+                BLTU_MARK(xRCX, x6);
+                ST_D(x3, xRDI, 0);
+                ADDI_D(xRDI, xRDI, 8);
+                ADDI_D(xRCX, xRCX, -8);
+                BNEZ_MARK3(xRCX);
+                B_NEXT_nocond;
                 MARK; // Part with DF==0
                 ST_B(xRAX, xRDI, 0);
                 ADDI_D(xRDI, xRDI, 1);
@@ -2373,6 +2417,11 @@ uintptr_t dynarec64_00(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
                 tmp = dyn->insts[ninst].pass2choice = 3;
             else
                 tmp = dyn->insts[ninst].pass2choice = i32 ? 0 : 1;
+            // a call to a PLT stub is done directly to the GOT target, with a check that the GOT didn't change
+            dyn->insts[ninst].pltgot = (!rex.is32bits && !dyn->need_reloc && i32 && tmp != 3) ? GetPltStubGot(addr + i32) : 0;
+            dyn->insts[ninst].pltval = dyn->insts[ninst].pltgot ? *(uintptr_t*)dyn->insts[ninst].pltgot : 0;
+            if (!dyn->insts[ninst].pltval)
+                dyn->insts[ninst].pltgot = 0;
 #else
             tmp = dyn->insts[ninst].pass2choice;
 #endif
@@ -2390,7 +2439,7 @@ uintptr_t dynarec64_00(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
                     MESSAGE(LOG_DUMP, "Native Call to %s (retn=%d)\n", GetNativeName(GetNativeFnc(dyn->insts[ninst].natcall - 1)), dyn->insts[ninst].retn);
                     // calling a native function
                     sse_purge07cache(dyn, ninst, x3);
-                    if ((BOX64ENV(log) < 2 && !BOX64ENV(rolling_log)) && dyn->insts[ninst].natcall) {
+                    if ((BOX64ENV(log) < 2 && !BOX64ENV(rolling_log) && !BOX64ENV(stats)) && dyn->insts[ninst].natcall) {
                         // FIXME: Add basic support for isSimpleWrapper
                         tmp = 0; // isSimpleWrapper(*(wrapper_t*)(dyn->insts[ninst].natcall + 2));
                     } else
@@ -2400,7 +2449,7 @@ uintptr_t dynarec64_00(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
                     // FIXME: if (dyn->insts[ninst].natcall && isRetX87Wrapper(*(wrapper_t*)(dyn->insts[ninst].natcall + 2)))
                     //     // return value will be on the stack, so the stack depth needs to be updated
                     //     x87_purgecache(dyn, ninst, 0, x3, x1, x4);
-                    if ((BOX64ENV(log) < 2 && !BOX64ENV(rolling_log)) && dyn->insts[ninst].natcall && tmp) {
+                    if ((BOX64ENV(log) < 2 && !BOX64ENV(rolling_log) && !BOX64ENV(stats)) && dyn->insts[ninst].natcall && tmp) {
                         // GETIP(ip+3+8+8, x7); // read the 0xCC
                         // FIXME: call_n(dyn, ninst, *(void**)(dyn->insts[ninst].natcall + 2 + 8), tmp);
                         POP1(xRIP); // pop the return address
@@ -2471,6 +2520,17 @@ uintptr_t dynarec64_00(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
                         j64 = (uint32_t)(addr + i32);
                     else
                         j64 = addr + i32;
+                    if (dyn->insts[ninst].pltgot) {
+                        // skip the PLT stub: direct jump to the GOT target if the slot didn't change, indirect one else
+                        MESSAGE(LOG_DUMP, "PLT stub %p folded (GOT %p)\n", (void*)j64, (void*)dyn->insts[ninst].pltgot);
+                        MOV64x(x4, dyn->insts[ninst].pltgot);
+                        LD_D(x1, x4, 0);
+                        MOV64x(x4, dyn->insts[ninst].pltval);
+                        BEQ_MARK3(x1, x4);
+                        jump_to_next(dyn, 0, x1, ninst, rex.is32bits);
+                        MARK3;
+                        j64 = dyn->insts[ninst].pltval;
+                    }
                     jump_to_next(dyn, j64, 0, ninst, rex.is32bits);
                     if (BOX64DRENV(dynarec_callret) && addr >= (dyn->start + dyn->isize)) {
                         // jumps out of current dynablock...
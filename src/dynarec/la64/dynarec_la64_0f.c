@@ -596,7 +596,8 @@ uintptr_t dynarec64_0F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
                     VXOR_V(v0, v0, v0);
                     VABSD_W(q0, q1, v0);
                     break;
-                case 0xC8 ... 0xCD:
+                case 0xC8 ... 0xCA:
+                case 0xCC ... 0xCD:
                     u8 = nextop;
                     switch (u8) {
                         case 0xC8:
@@ -608,9 +609,6 @@ uintptr_t dynarec64_0F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
                         case 0xCA:
                             INST_NAME("SHA1MSG2 Gx, Ex");
                             break;
-                        case 0xCB:
-                            INST_NAME("SHA256RNDS2 Gx, Ex");
-                            break;
                         case 0xCC:
                             INST_NAME("SHA256MSG1 Gx, Ex");
                             break;
@@ -619,6 +617,62 @@ uintptr_t dynarec64_0F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
                             break;
                     }
                     nextop = F8;
+                    GETGX(q0, 1);
+                    GETEX(q1, 0, 0);
+                    v0 = fpu_get_scratch(dyn);
+                    v1 = fpu_get_scratch(dyn);
+                    switch (u8) {
+                        case 0xC8:
+                            VROTRI_W(v0, q0, 2); // i.e. ROL 30
+                            VBSRL_V(v0, v0, 12);
+                            VBSLL_V(v0, v0, 12);
+                            VADD_W(q0, q1, v0);
+                            break;
+                        case 0xC9:
+                            VOR_V(v0, q1, q1);
+                            VSHUF4I_D(v0, q0, 0b1001); // {Ex.hi, Gx.lo}
+                            VXOR_V(q0, q0, v0);
+                            break;
+                        case 0xCA:
+                            VBSLL_V(v0, q1, 4);
+                            VXOR_V(v0, q0, v0);
+                            VROTRI_W(q0, v0, 31);
+                            // w19 also depends on w16
+                            VBSRL_V(v1, q0, 12);
+                            VROTRI_W(v1, v1, 31);
+                            VXOR_V(q0, q0, v1);
+                            break;
+                        case 0xCC:
+                            d0 = fpu_get_scratch(dyn);
+                            VBSRL_V(v0, q0, 4);
+                            VBSLL_V(v1, q1, 12);
+                            VOR_V(v0, v0, v1);
+                            VROTRI_W(v1, v0, 7);
+                            VROTRI_W(d0, v0, 18);
+                            VXOR_V(v1, v1, d0);
+                            VSRLI_W(d0, v0, 3);
+                            VXOR_V(v1, v1, d0);
+                            VADD_W(q0, q0, v1);
+                            break;
+                        case 0xCD:
+                            // w16/w17 first, then w18/w19 from them
+                            d0 = fpu_get_scratch(dyn);
+                            VBSRL_V(v0, q1, 8);
+                            for (int i = 0; i < 2; ++i) {
+                                if (i) VBSLL_V(v0, q0, 8);
+                                VROTRI_W(v1, v0, 17);
+                                VROTRI_W(d0, v0, 19);
+                                VXOR_V(v1, v1, d0);
+                                VSRLI_W(d0, v0, 10);
+                                VXOR_V(v1, v1, d0);
+                                VADD_W(q0, q0, v1);
+                            }
+                            break;
+                    }
+                    break;
+                case 0xCB:
+                    INST_NAME("SHA256RNDS2 Gx, Ex (, XMM0)");
+                    nextop = F8;
                     if (MODREG) {
                         ed = (nextop & 7) + (rex.b << 3);
                         sse_reflect_reg(dyn, ninst, ed);
@@ -634,26 +688,7 @@ uintptr_t dynarec64_0F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int ni
                     sse_forget_reg(dyn, ninst, gd);
                     ADDI_D(x1, xEmu, offsetof(x64emu_t, xmm[gd]));
                     sse_reflect_reg(dyn, ninst, 0);
-                    switch (u8) {
-                        case 0xC8:
-                            CALL(const_sha1nexte, -1);
-                            break;
-                        case 0xC9:
-                            CALL(const_sha1msg1, -1);
-                            break;
-                        case 0xCA:
-                            CALL(const_sha1msg2, -1);
-                            break;
-                        case 0xCB:
-                            CALL(const_sha256rnds2, -1);
-                            break;
-                        case 0xCC:
-                            CALL(const_sha256msg1, -1);
-                            break;
-                        case 0xCD:
-                            CALL(const_sha256msg2, -1);
-                            break;
-                    }
+                    CALL(const_sha256rnds2, -1);
                     break;
                 case 0xF0:
                     INST_NAME("MOVBE Gd, Ed");
@@ -1265,59 +1265,18 @@ uintptr_t dynarec64_660F(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t ip, int
                     CALL(const_native_pclmul, -1);
                     break;
                 case 0x61:
-                    INST_NAME("PCMPESTRI Gx, Ex, Ib");
-                    nextop = F8;
-                    GETG;
-                    u8 = geted_ib(dyn, addr, ninst, nextop);
-                    SETFLAGS(X_ALL, SF_SET_DF, NAT_FLAGS_NOFUSION);
-                    if (gd > 7) // no need to reflect cache as xmm0-xmm7 will be saved before the function call anyway
-                        sse_reflect_reg(dyn, ninst, gd);
-                    ADDI_D(x3, xEmu, offsetof(x64emu_t, xmm[gd]));
-                    if (MODREG) {
-                        ed = (nextop & 7) + (rex.b << 3);
-                        if (ed > 7)
-                            sse_reflect_reg(dyn, ninst, ed);
-                        ADDI_D(x1, xEmu, offsetof(x64emu_t, xmm[ed]));
-                    } else {
-                        addr = geted(dyn, addr, ninst, nextop, &ed, x1, x5, &fixedaddress, rex, NULL, 0, 1);
-                        if (ed != x1) MV(x1, ed);
-                    }
-                    MV(x2, xRDX);
-                    MV(x4, xRAX);
-                    u8 = F8;
-                    MOV32w(x5, u8);
-                    CALL(const_sse42_compare_string_explicit_len, x1);
-                    ZEROUP(x1);
-                    BNEZ_MARK(x1);
-                    MOV32w(xRCX, (u8 & 1) ? 8 : 16);
-                    B_NEXT_nocond;
-                    MARK;
-                    if (u8 & 0b1000000) {
-                        CLZ_W(xRCX, x1);
-                        ADDI_D(x2, xZR, 31);
-                        SUB_D(xRCX, x2, xRCX);
-                    } else {
-                        CTZ_W(xRCX, x1);
-                    }
-                    break;
                 case 0x63:
-                    INST_NAME("PCMPISTRI Gx, Ex, Ib");
-                    SETFLAGS(X_ALL, SF_SET_DF, NAT_FLAGS_NOFUSION);
-                    nextop = F8;
-                    GETG;
-                    if (gd > 7) sse_reflect_reg(dyn, ninst, gd);
-                    ADDI_D(x2, xEmu, offsetof(x64emu_t, xmm[gd]));
-                    if (MODREG) {
-                        ed = (nextop & 7) + (rex.b << 3);
-                        if (ed > 7) sse_reflect_reg(dyn, ninst, ed);
-                        ADDI_D(x1, xEmu, offsetof(x64emu_t, xmm[ed]));
+                    if (opcode == 0x61) {
+                        INST_NAME("PCMPESTRI Gx, Ex, Ib");
                     } else {
-                        addr = geted(dyn, addr, ninst, nextop, &ed, x1, x2, &fixedaddress, rex, NULL, 0, 1);
-                        if (ed != x1) MV(x1, ed);
+                        INST_NAME("PCMPISTRI Gx, Ex, Ib");
                     }
+                    SETFLAGS(X_ALL, SF_SET, NAT_FLAGS_NOFUSION);
+                    nextop = F8;
+                    GETGX(q0, 0);
+                    GETEX(q1, 0, 1);
                     u8 = F8;
-                    MOV32w(x3, u8);
-                    CALL(const_sse42_compare_string_implicit_len, x1);
+                    emit_pcmpstr(dyn, ninst, rex, q0, q1, u8, opcode == 0x61, x1, x2, x4, x5, x6);
                     BNEZ_MARK(x1);
                     MOV32w(xRCX, (u8 & 1) ? 8 : 16);
                     B_NEXT_nocond;
@@ -85,6 +85,30 @@ uintptr_t dynarec64_AVX_66_0F38(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t i
             GETGY_empty_EY_xy(q0, q2, 0);
             XVREPLVE0_Q(q0, q2);
             break;
+        case 0x1C:
+            INST_NAME("VPABSB Gx, Ex");
+            nextop = F8;
+            GETGY_empty_EY_xy(v0, v1, 0);
+            q0 = fpu_get_scratch(dyn);
+            VXOR_Vxy(q0, q0, q0);
+            VABSDxy(B, v0, v1, q0);
+            break;
+        case 0x1D:
+            INST_NAME("VPABSW Gx, Ex");
+            nextop = F8;
+            GETGY_empty_EY_xy(v0, v1, 0);
+            q0 = fpu_get_scratch(dyn);
+            VXOR_Vxy(q0, q0, q0);
+            VABSDxy(H, v0, v1, q0);
+            break;
+        case 0x1E:
+            INST_NAME("VPABSD Gx, Ex");
+            nextop = F8;
+            GETGY_empty_EY_xy(v0, v1, 0);
+            q0 = fpu_get_scratch(dyn);
+            VXOR_Vxy(q0, q0, q0);
+            VABSDxy(W, v0, v1, q0);
+            break;
         case 0x20:
             INST_NAME("VPMOVSXBW Gx, Ex");
             nextop = F8;
@@ -211,6 +235,18 @@ uintptr_t dynarec64_AVX_66_0F38(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t i
                 VSLLWIL_D_W(q0, q1, 0);
             }
             break;
+        case 0x28:
+            INST_NAME("VPMULDQ Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY_xy(v0, v1, v2, 0);
+            VMULWEVxy(D_W, v0, v1, v2);
+            break;
+        case 0x29:
+            INST_NAME("VPCMPEQQ Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY_xy(v0, v1, v2, 0);
+            VSEQxy(D, v0, v1, v2);
+            break;
         case 0x2C:
             INST_NAME("VMASKMOVPS Gx, Vx, Ex");
             nextop = F8;
@@ -399,6 +435,66 @@ uintptr_t dynarec64_AVX_66_0F38(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t i
                 VSLLWIL_DU_WU(q0, q1, 0);
             }
             break;
+        case 0x37:
+            INST_NAME("VPCMPGTQ Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY_xy(v0, v1, v2, 0);
+            VSLTxy(D, v0, v2, v1);
+            break;
+        case 0x38:
+            INST_NAME("VPMINSB Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY_xy(v0, v1, v2, 0);
+            VMINxy(B, v0, v1, v2);
+            break;
+        case 0x39:
+            INST_NAME("VPMINSD Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY_xy(v0, v1, v2, 0);
+            VMINxy(W, v0, v1, v2);
+            break;
+        case 0x3A:
+            INST_NAME("VPMINUW Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY_xy(v0, v1, v2, 0);
+            VMINxy(HU, v0, v1, v2);
+            break;
+        case 0x3B:
+            INST_NAME("VPMINUD Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY_xy(v0, v1, v2, 0);
+            VMINxy(WU, v0, v1, v2);
+            break;
+        case 0x3C:
+            INST_NAME("VPMAXSB Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY_xy(v0, v1, v2, 0);
+            VMAXxy(B, v0, v1, v2);
+            break;
+        case 0x3D:
+            INST_NAME("VPMAXSD Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY_xy(v0, v1, v2, 0);
+            VMAXxy(W, v0, v1, v2);
+            break;
+        case 0x3E:
+            INST_NAME("VPMAXUW Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY_xy(v0, v1, v2, 0);
+            VMAXxy(HU, v0, v1, v2);
+            break;
+        case 0x3F:
+            INST_NAME("VPMAXUD Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY_xy(v0, v1, v2, 0);
+            VMAXxy(WU, v0, v1, v2);
+            break;
+        case 0x40:
+            INST_NAME("VPMULLD Gx, Vx, Ex");
+            nextop = F8;
+            GETGY_empty_VYEY_xy(v0, v1, v2, 0);
+            VMULxy(W, v0, v1, v2);
+            break;
         case 0x8C:
             INST_NAME("VPMASKMOVD/Q Gx, Vx, Ex");
             nextop = F8;
@@ -446,6 +542,197 @@ uintptr_t dynarec64_AVX_66_0F38(dynarec_la64_t* dyn, uintptr_t addr, uintptr_t i
                 PUTEYx(v0);
             }
             break;
+        case 0x90:
+        case 0x91:
+        case 0x92:
+        case 0x93:
+            switch (opcode) {
+                case 0x90: INST_NAME("VPGATHERDD/VPGATHERDQ Gx, VSIB, Vx"); break;
+                case 0x91: INST_NAME("VPGATHERQD/VPGATHERQQ Gx, VSIB, Vx"); break;
+                case 0x92: INST_NAME("VGATHERDPS/VGATHERDPD Gx, VSIB, Vx"); break;
+                default: INST_NAME("VGATHERQPS/VGATHERQPD Gx, VSIB, Vx"); break;
+            }
+            nextop = F8;
+            if (((nextop & 7) != 4) || MODREG) {
+                UDF();
+                break;
+            }
+            GETG;
+            u8 = F8; // SIB
+            if ((u8 & 0x7) == 0x5 && !(nextop & 0xC0)) {
+                int64_t i64 = F32S64;
+                MOV64x(x5, i64);
+                eb1 = x5;
+            } else
+                eb1 = TO_NAT((u8 & 0x7) + (rex.b << 3)); // base
+            eb2 = ((u8 >> 3) & 7) + (rex.x << 3);        // index
+            if (nextop & 0x40)
+                i32 = F8S;
+            else if (nextop & 0x80)
+                i32 = F32S;
+            else
+                i32 = 0;
+            if (!i32)
+                ed = eb1;
+            else {
+                ed = x3;
+                if (i32 >= -2048 && i32 < 2048) {
+                    ADDI_D(ed, eb1, i32);
+                } else {
+                    MOV64x(ed, i32);
+                    ADD_D(ed, ed, eb1);
+                }
+            }
+            // ed is base
+            wb1 = u8 >> 6; // scale
+            // s0 is the number of elements, d0 the width of Gx/Vx, d1 the width of the index
+            if (opcode & 1) {
+                s0 = vex.l ? 4 : 2;
+                d0 = (rex.w && vex.l) ? LSX_AVX_WIDTH_256 : LSX_AVX_WIDTH_128;
+                d1 = vex.l ? LSX_AVX_WIDTH_256 : LSX_AVX_WIDTH_128;
+            } else {
+                s0 = (rex.w ? 2 : 4) << vex.l;
+                d0 = vex.l ? LSX_AVX_WIDTH_256 : LSX_AVX_WIDTH_128;
+                d1 = (vex.l && !rex.w) ? LSX_AVX_WIDTH_256 : LSX_AVX_WIDTH_128;
+            }
+            v0 = avx_get_reg(dyn, ninst, x1, gd, 1, d0);
+            v2 = avx_get_reg(dyn, ninst, x1, vex.v, 1, d0);
+            v1 = avx_get_reg(dyn, ninst, x1, eb2, 0, d1);
+            // slow gather, not much choice here... elements with a positive mask are skipped
+            for (int i = 0; i < s0; ++i) {
+                if (rex.w)
+                    XVPICKVE2GR_D(x4, v2, i);
+                else
+                    XVPICKVE2GR_W(x4, v2, i);
+                BGE(x4, xZR, 4 + 4 * 4);
+                if (opcode & 1)
+                    XVPICKVE2GR_D(x4, v1, i);
+                else
+                    XVPICKVE2GR_W(x4, v1, i);
+                if (wb1)
+                    ALSL_D(x4, x4, ed, wb1);
+                else
+                    ADD_D(x4, ed, x4);
+                if (rex.w) {
+                    LD_D(x4, x4, 0);
+                    XVINSGR2VR_D(v0, x4, i);
+                } else {
+                    LD_W(x4, x4, 0);
+                    XVINSGR2VR_W(v0, x4, i);
+                }
+            }
+            // mask is fully cleared once the gather is done
+            if (d0 == LSX_AVX_WIDTH_256) {
+                XVXOR_V(v2, v2, v2);
+            } else {
+                VXOR_V(v2, v2, v2);
+            }
+            if ((opcode & 1) && !rex.w && !vex.l) VINSGR2VR_D(v0, xZR, 1);
+            break;
+        case 0x98:
+        case 0x9A:
+        case 0x9C:
+        case 0x9E:
+        case 0xA8:
+        case 0xAA:
+        case 0xAC:
+        case 0xAE:
+        case 0xB8:
+        case 0xBA:
+        case 0xBC:
+        case 0xBE:
+            switch (opcode) {
+                case 0x98: INST_NAME("VFMADD132PS/D Gx, Vx, Ex"); break;
+                case 0x9A: INST_NAME("VFMSUB132PS/D Gx, Vx, Ex"); break;
+                case 0x9C: INST_NAME("VFNMADD132PS/D Gx, Vx, Ex"); break;
+                case 0x9E: INST_NAME("VFNMSUB132PS/D Gx, Vx, Ex"); break;
+                case 0xA8: INST_NAME("VFMADD213PS/D Gx, Vx, Ex"); break;
+                case 0xAA: INST_NAME("VFMSUB213PS/D Gx, Vx, Ex"); break;
+                case 0xAC: INST_NAME("VFNMADD213PS/D Gx, Vx, Ex"); break;
+                case 0xAE: INST_NAME("VFNMSUB213PS/D Gx, Vx, Ex"); break;
+                case 0xB8: INST_NAME("VFMADD231PS/D Gx, Vx, Ex"); break;
+                case 0xBA: INST_NAME("VFMSUB231PS/D Gx, Vx, Ex"); break;
+                case 0xBC: INST_NAME("VFNMADD231PS/D Gx, Vx, Ex"); break;
+                case 0xBE: INST_NAME("VFNMSUB231PS/D Gx, Vx, Ex"); break;
+            }
+            nextop = F8;
+            GETGY_VYEY_xy(v0, v1, v2, 0);
+            // q0 * q1 + q2, with the operand order encoded in the opcode
+            if ((opcode & 0xF0) == 0x90) {
+                q0 = v0;
+                q1 = v2;
+                q2 = v1;
+            } else if ((opcode & 0xF0) == 0xA0) {
+                q0 = v1;
+                q1 = v0;
+                q2 = v2;
+            } else {
+                q0 = v1;
+                q1 = v2;
+                q2 = v0;
+            }
+            if (!BOX64ENV(dynarec_fastnan)) {
+                d0 = fpu_get_scratch(dyn);
+                d1 = fpu_get_scratch(dyn);
+                if (rex.w) {
+                    VFCMPxy(D, d0, q0, q1, cUN);
+                    VFCMPxy(D, d1, q2, q2, cUN);
+                } else {
+                    VFCMPxy(S, d0, q0, q1, cUN);
+                    VFCMPxy(S, d1, q2, q2, cUN);
+                }
+                VOR_Vxy(d0, d0, d1);
+            }
+            // x86 FNMADD is -(a*b)+c, that is LA FNMSUB, and FNMSUB is -(a*b)-c, that is LA FNMADD
+            switch (opcode & 0x0F) {
+                case 0x8:
+                    if (rex.w) {
+                        VFMADDxy(D, v0, q0, q1, q2);
+                    } else {
+                        VFMADDxy(S, v0, q0, q1, q2);
+                    }
+                    break;
+                case 0xA:
+                    if (rex.w) {
+                        VFMSUBxy(D, v0, q0, q1, q2);
+                    } else {
+                        VFMSUBxy(S, v0, q0, q1, q2);
+                    }
+                    break;
+                case 0xC:
+                    if (rex.w) {
+                        VFNMSUBxy(D, v0, q0, q1, q2);
+                    } else {
+                        VFNMSUBxy(S, v0, q0, q1, q2);
+                    }
+                    break;
+                default:
+                    if (rex.w) {
+                        VFNMADDxy(D, v0, q0, q1, q2);
+                    } else {
+                        VFNMADDxy(S, v0, q0, q1, q2);
+                    }
+                    break;
+            }
+            if (!BOX64ENV(dynarec_fastnan)) {
+                if (rex.w) {
+                    VFCMPxy(D, d1, v0, v0, cUN);
+                } else {
+                    VFCMPxy(S, d1, v0, v0, cUN);
+                }
+                VANDN_Vxy(d0, d0, d1);
+                if (rex.w) {
+                    VLDIxy(d1, 0b011111111000); // broadcast 0xFFFFFFFFFFFFFFF8
+                    VSLLIxy(D, d1, d1, 48);
+                } else {
+                    VLDIxy(d1, 0b011111111100); // broadcast 0xFFFFFFFC
+                    VSLLIxy(W, d1, d1, 20);
+                }
+                VAND_Vxy(d1, d0, d1);
+                VANDN_Vxy(d0, d0, v0);
+                VOR_Vxy(v0, d0, d1);
+            }
+            break;
         default:
             DEFAULT;
     }
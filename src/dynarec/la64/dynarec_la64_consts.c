@@ -28,6 +28,10 @@
 void PrintTrace() {}
 #endif
 
+// lane index of a 128bits vector, as bytes then as words
+static const uint8_t lane_index[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                                      0, 0, 1, 0, 2, 0, 3, 0, 4, 0, 5, 0, 6, 0, 7, 0 };
+
 uintptr_t getConst(la64_consts_t which)
 {
     switch(which) {
@@ -132,6 +136,7 @@ uintptr_t getConst(la64_consts_t which)
         case const_jmptbl48: return getJumpTable48();
         case const_jmptbl64: return getJumpTable64();
         case const_context: return (uintptr_t)my_context;
+        case const_lane_index: return (uintptr_t)&lane_index;
 
         case const_last: dynarec_log(LOG_NONE, "Warning, const last used\n");
             return 0;
@@ -1270,6 +1270,204 @@ void emit_pf(dynarec_la64_t* dyn, int ninst, int s1, int s3, int s4)
     BSTRINS_D(xFlags, s3, F_PF, F_PF);
 }
 
+// convert a vector of byte/word lane masks in v to a bitmask in s1 (v is destroyed)
+static void pcmpstr_tobits(dynarec_la64_t* dyn, int ninst, int v, int word, int s1)
+{
+    if (word)
+        VMSKLTZ_H(v, v);
+    else
+        VMSKLTZ_B(v, v);
+    VPICKVE2GR_HU(s1, v, 0);
+}
+
+// Inline PCMPxSTRx, specialized on imm8: vreg is Gx, vmem is Ex.
+// Explicit length are taken from RAX/RDX, implicit from the 1st null element.
+// Return intres2 in s1, lreg in s2 and lmem in s3 and set the flags. s4 & s5 are scratch
+// Also return the scratch register containing intres2 as a byte/word mask
+int emit_pcmpstr(dynarec_la64_t* dyn, int ninst, rex_t rex, int vreg, int vmem, uint8_t imm8, int explicit_len, int s1, int s2, int s3, int s4, int s5)
+{
+    int word = imm8 & 1;
+    int n = word ? 8 : 16;
+    int es = word ? 2 : 1;
+    int nvr = fpu_get_scratch(dyn);
+    int nvm = fpu_get_scratch(dyn);
+    int acc = fpu_get_scratch(dyn);
+    int t1 = fpu_get_scratch(dyn);
+    int t2 = fpu_get_scratch(dyn);
+    // lengths
+    if (explicit_len) {
+        // abs(eax) / abs(edx), saturated to n
+        if (rex.w) {
+            MV(s2, xRAX);
+            MV(s3, xRDX);
+        } else {
+            ADDI_W(s2, xRAX, 0);
+            ADDI_W(s3, xRDX, 0);
+        }
+        SRAI_D(s4, s2, 63);
+        XOR(s2, s2, s4);
+        SUB_D(s2, s2, s4);
+        SRAI_D(s4, s3, 63);
+        XOR(s3, s3, s4);
+        SUB_D(s3, s3, s4);
+        ADDI_D(s4, xZR, n);
+        BGE(s4, s2, 8);
+        MV(s2, s4);
+        BGE(s4, s3, 8);
+        MV(s3, s4);
+    } else {
+        if (word)
+            ADDI_D(s4, xZR, 1 << 8);
+        else
+            LU12I_W(s4, 1 << 4); // 1<<16
+        VXOR_V(t2, t2, t2);
+        if (word) VSEQ_H(t1, vreg, t2); else VSEQ_B(t1, vreg, t2);
+        pcmpstr_tobits(dyn, ninst, t1, word, s2);
+        OR(s2, s2, s4); // set bit n
+        CTZ_W(s2, s2);
+        if (word) VSEQ_H(t1, vmem, t2); else VSEQ_B(t1, vmem, t2);
+        pcmpstr_tobits(dyn, ninst, t1, word, s3);
+        OR(s3, s3, s4);
+        CTZ_W(s3, s3);
+    }
+    // invalid element masks
+    TABLE64C(s4, const_lane_index);
+    if (word) {
+        VLD(t1, s4, 16);
+        VREPLGR2VR_H(nvr, s2);
+        VSLE_HU(nvr, nvr, t1);
+        VREPLGR2VR_H(nvm, s3);
+        VSLE_HU(nvm, nvm, t1);
+    } else {
+        VLD(t1, s4, 0);
+        VREPLGR2VR_B(nvr, s2);
+        VSLE_BU(nvr, nvr, t1);
+        VREPLGR2VR_B(nvm, s3);
+        VSLE_BU(nvm, nvm, t1);
+    }
+    // aggregation, acc lanes are the mem elements
+    switch ((imm8 >> 2) & 3) {
+        case 0b00: // equal any
+            VXOR_V(acc, acc, acc);
+            for (int i = 0; i < n; ++i) {
+                if (word) {
+                    VREPLVEI_H(t1, vreg, i);
+                    VSEQ_H(t1, t1, vmem);
+                    VREPLVEI_H(t2, nvr, i);
+                } else {
+                    VREPLVEI_B(t1, vreg, i);
+                    VSEQ_B(t1, t1, vmem);
+                    VREPLVEI_B(t2, nvr, i);
+                }
+                VANDN_V(t1, t2, t1);
+                VOR_V(acc, acc, t1);
+            }
+            VANDN_V(acc, nvm, acc);
+            break;
+        case 0b01: // ranges
+            VXOR_V(acc, acc, acc);
+            for (int i = 0; i < n; i += 2) {
+                if (word) {
+                    VREPLVEI_H(t1, vreg, i);
+                    VREPLVEI_H(t2, vreg, i + 1);
+                    if (imm8 & 2) {
+                        VSLE_H(t1, t1, vmem);
+                        VSLE_H(t2, vmem, t2);
+                    } else {
+                        VSLE_HU(t1, t1, vmem);
+                        VSLE_HU(t2, vmem, t2);
+                    }
+                    VAND_V(t1, t1, t2);
+                    VREPLVEI_H(t2, nvr, i + 1);
+                } else {
+                    VREPLVEI_B(t1, vreg, i);
+                    VREPLVEI_B(t2, vreg, i + 1);
+                    if (imm8 & 2) {
+                        VSLE_B(t1, t1, vmem);
+                        VSLE_B(t2, vmem, t2);
+                    } else {
+                        VSLE_BU(t1, t1, vmem);
+                        VSLE_BU(t2, vmem, t2);
+                    }
+                    VAND_V(t1, t1, t2);
+                    VREPLVEI_B(t2, nvr, i + 1);
+                }
+                VANDN_V(t1, t2, t1);
+                VOR_V(acc, acc, t1);
+            }
+            VANDN_V(acc, nvm, acc);
+            break;
+        case 0b10: // equal each
+            if (word) VSEQ_H(acc, vreg, vmem); else VSEQ_B(acc, vreg, vmem);
+            VANDN_V(acc, nvr, acc);
+            VANDN_V(acc, nvm, acc);
+            VAND_V(t1, nvr, nvm); // both invalid is true
+            VOR_V(acc, acc, t1);
+            break;
+        case 0b11: // equal ordered
+            // acc[j] = AND(i<n-j) of (reg[i] invalid || (mem[i+j] valid && reg[i]==mem[i+j]))
+            {
+                int vo = fpu_get_scratch(dyn);
+                VSEQ_B(acc, acc, acc);
+                VSEQ_B(vo, vo, vo);
+                for (int i = 0; i < n; ++i) {
+                    if (word) VREPLVEI_H(t1, vreg, i); else VREPLVEI_B(t1, vreg, i);
+                    if (i) {
+                        // elements beyond n-i are shifted out, but forced to true just after
+                        VBSRL_V(t2, vmem, i * es);
+                        if (word) VSEQ_H(t1, t1, t2); else VSEQ_B(t1, t1, t2);
+                        VBSRL_V(t2, nvm, i * es);
+                        VANDN_V(t1, t2, t1);
+                        VBSLL_V(t2, vo, 16 - i * es);
+                        VOR_V(t1, t1, t2);
+                    } else {
+                        if (word) VSEQ_H(t1, t1, vmem); else VSEQ_B(t1, t1, vmem);
+                        VANDN_V(t1, nvm, t1);
+                    }
+                    if (word) VREPLVEI_H(t2, nvr, i); else VREPLVEI_B(t2, nvr, i);
+                    VOR_V(t1, t1, t2);
+                    VAND_V(acc, acc, t1);
+                }
+            }
+            break;
+    }
+    // intres2
+    switch ((imm8 >> 4) & 3) {
+        case 0b01: // negate all
+            VNOR_V(acc, acc, acc);
+            break;
+        case 0b11: // negate valid mem elements only
+            VXOR_V(acc, acc, nvm);
+            VNOR_V(acc, acc, acc);
+            break;
+    }
+    VOR_V(t1, acc, acc);
+    pcmpstr_tobits(dyn, ninst, t1, word, s1);
+    // flags
+    IFX (X_ALL) {
+        SET_DFNONE();
+        SLTU(s4, xZR, s1); // CF
+        ADDI_D(s5, xZR, n);
+        SLT(s5, s3, s5);
+        SLLI_D(s5, s5, F_ZF);
+        OR(s4, s4, s5);
+        ADDI_D(s5, xZR, n);
+        SLT(s5, s2, s5);
+        SLLI_D(s5, s5, F_SF);
+        OR(s4, s4, s5);
+        ANDI(s5, s1, 1);
+        SLLI_D(s5, s5, F_OF);
+        OR(s4, s4, s5);
+        if (cpuext.lbt) {
+            X64_SET_EFLAGS(s4, X_ALL);
+        } else {
+            CLEAR_FLAGS_(s5);
+            OR(xFlags, xFlags, s4);
+        }
+    }
+    return acc;
+}
+
 void fpu_reset_cache(dynarec_la64_t* dyn, int ninst, int reset_n)
 {
     MESSAGE(LOG_DEBUG, "Reset Caches with %d\n", reset_n);
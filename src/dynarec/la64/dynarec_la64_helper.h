@@ -774,6 +774,10 @@
 #define B_MARK2_nocond Bxx_gen(__, MARK2, 0, 0)
 // Branch to MARK3 instruction unconditionnal (use j64)
 #define B_MARK3_nocond Bxx_gen(__, MARK3, 0, 0)
+// Branch to MARKF2 if reg1<reg2 (unsigned) (use j64)
+#define BLTU_MARKF2(reg1, reg2) Bxx_gen(LTU, MARKF2, reg1, reg2)
+// Branch to MARKF instruction unconditionnal (use j64)
+#define B_MARKF_nocond Bxx_gen(__, MARKF, 0, 0)
 
 // Branch to NEXT if reg1==0 (use j64)
 #define CBZ_NEXT(reg1)                                                        \
@@ -1190,6 +1194,7 @@
 #define emit_rol32c         STEPNAME(emit_rol32c)
 
 #define emit_pf STEPNAME(emit_pf)
+#define emit_pcmpstr STEPNAME(emit_pcmpstr)
 
 #define x87_restoreround  STEPNAME(x87_restoreround)
 #define sse_setround      STEPNAME(sse_setround)
@@ -1314,6 +1319,7 @@ void emit_rol32(dynarec_la64_t* dyn, int ninst, rex_t rex, int s1, int s2, int s
 void emit_rol32c(dynarec_la64_t* dyn, int ninst, rex_t rex, int s1, uint32_t c, int s3, int s4);
 
 void emit_pf(dynarec_la64_t* dyn, int ninst, int s1, int s3, int s4);
+int emit_pcmpstr(dynarec_la64_t* dyn, int ninst, rex_t rex, int vreg, int vmem, uint8_t imm8, int explicit_len, int s1, int s2, int s3, int s4, int s5);
 
 // common coproc helpers
 // reset the cache with n
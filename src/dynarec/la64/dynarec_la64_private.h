@@ -100,6 +100,8 @@ typedef struct instruction_la64_s {
     uintptr_t           marklock2;
     int                 pass2choice;// value for choices that are fixed on pass2 for pass3
     uintptr_t           natcall;
+    uintptr_t           pltgot;     // CALL to a PLT stub: address of its GOT slot
+    uintptr_t           pltval;     // and the value of the slot when the block was built
     uint16_t            retn;
     uint16_t            purge_ymm;  // need to purge some ymm
     uint16_t            ymm0_in;    // bitmap of ymm to zero at purge
@@ -162,6 +164,7 @@ typedef struct dynarec_la64_s {
     int                  forward_ninst;  // ninst at the forward point
     uint16_t             ymm_zero;   // bitmap of ymm to zero at purge
     uint8_t              smwrite;    // for strongmem model emulation
+    uint8_t              weakmem;    // strongmem barriers not needed (process still single threaded)
     uint8_t              always_test;
     uint8_t              abort;
     void*               gdbjit_block;
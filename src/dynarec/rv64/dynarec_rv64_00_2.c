@@ -674,6 +674,26 @@ uintptr_t dynarec64_00_2(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
                 OR(x1, xRSI, xRDI);
                 ANDI(x1, x1, 7);
                 BNEZ_MARK(x1);
+                // wide path, 32 bytes per loop, only if a chunk cannot overlap itself
+                SUB(x2, xRDI, xRSI);
+                ADDI(x6, xZR, 32);
+                BLTU_MARKF2(x2, x6);
+                MARKF;
+                BLTU_MARKF2(xRCX, x6);
+                LD(x1, xRSI, 0);
+                LD(x2, xRSI, 8);
+                LD(x3, xRSI, 16);
+                LD(x4, xRSI, 24);
+                SD(x1, xRDI, 0);
+                SD(x2, xRDI, 8);
+                SD(x3, xRDI, 16);
+                SD(x4, xRDI, 24);
+                ADDI(xRSI, xRSI, 32);
+                ADDI(xRDI, xRDI, 32);
+                SUBI(xRCX, xRCX, 32);
+                BEQZ_MARKLOCK(xRCX);
+                B_MARKF_nocond;
+                MARKF2;
                 ADDI(x6, xZR, 8);
                 MARK3;
                 BLT_MARK(xRCX, x6);
@@ -872,6 +892,32 @@ uintptr_t dynarec64_00_2(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
                 CBZ_NEXT(xRCX);
                 ANDI(x1, xFlags, 1 << F_DF);
                 BNEZ_MARK2(x1);
+                // special optim for large RCX value on forward case only
+                ANDI(x1, xRDI, 7);
+                BNEZ_MARK(x1);
+                ANDI(x3, xRAX, 0xff);
+                MOV64x(x4, 0x0101010101010101LL);
+                MUL(x3, x3, x4); // 8 bytes...
+                ADDI(x6, xZR, 32);
+                MARKF; // wide path, 32 bytes per loop
+                BLTU_MARKF2(xRCX, x6);
+                SD(x3, xRDI, 0);
+                SD(x3, xRDI, 8);
+                SD(x3, xRDI, 16);
+                SD(x3, xRDI, 24);
+                ADDI(xRDI, xRDI, 32);
+                SUBI(xRCX, xRCX, 32);
+                CBZ_NEXT(xRCX);
+                B_MARKF_nocond;
+                MARKF2;
+                ADDI(x6, xZR, 8);
+                MARK3;
+                BLTU_MARK(xRCX, x6);
+                SD(x3, xRDI, 0);
+                ADDI(xRDI, xRDI, 8);
+                SUBI(xRCX, xRCX, 8);
+                BNEZ_MARK3(xRCX);
+                B_NEXT_nocond;
                 MARK; // Part with DF==0
                 SB(xRAX, xRDI, 0);
                 ADDI(xRDI, xRDI, 1);
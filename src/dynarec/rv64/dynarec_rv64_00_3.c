@@ -19,6 +19,7 @@
 #include "dynarec_native.h"
 #include "custommem.h"
 #include "alternate.h"
+#include "elfloader.h"
 
 #include "rv64_printer.h"
 #include "dynarec_rv64_private.h"
@@ -459,7 +460,7 @@ uintptr_t dynarec64_00_3(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
                         x87_purgecache(dyn, ninst, 0, x3, x1, x4);
                     if (tmp < 0 || (tmp & 15) > 1)
                         tmp = 0; // TODO: removed when FP is in place
-                    if ((BOX64ENV(log) < 2 && !BOX64ENV(rolling_log)) && tmp) {
+                    if ((BOX64ENV(log) < 2 && !BOX64ENV(rolling_log) && !BOX64ENV(stats)) && tmp) {
                         call_n(dyn, ninst, (void*)(addr + 8), tmp);
                         addr += 8 + 8;
                     } else {
@@ -968,6 +969,11 @@ uintptr_t dynarec64_00_3(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
                 tmp = dyn->insts[ninst].pass2choice = 3;
             else
                 tmp = dyn->insts[ninst].pass2choice = i32 ? 0 : 1;
+            // a call to a PLT stub is done directly to the GOT target, with a check that the GOT didn't change
+            dyn->insts[ninst].pltgot = (!rex.is32bits && !dyn->need_reloc && i32 && tmp != 3) ? GetPltStubGot(addr + i32) : 0;
+            dyn->insts[ninst].pltval = dyn->insts[ninst].pltgot ? *(uintptr_t*)dyn->insts[ninst].pltgot : 0;
+            if (!dyn->insts[ninst].pltval)
+                dyn->insts[ninst].pltgot = 0;
 #else
             tmp = dyn->insts[ninst].pass2choice;
 #endif
@@ -991,7 +997,7 @@ uintptr_t dynarec64_00_3(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
                     MESSAGE(LOG_DUMP, "Native Call to %s (retn=%d)\n", GetNativeName(GetNativeFnc(dyn->insts[ninst].natcall - 1)), dyn->insts[ninst].retn);
                     // calling a native function
                     sse_purge07cache(dyn, ninst, x3);
-                    if ((BOX64ENV(log) < 2 && !BOX64ENV(rolling_log)) && dyn->insts[ninst].natcall) {
+                    if ((BOX64ENV(log) < 2 && !BOX64ENV(rolling_log) && !BOX64ENV(stats)) && dyn->insts[ninst].natcall) {
                         // Partially support isSimpleWrapper
                         tmp = isSimpleWrapper(*(wrapper_t*)(dyn->insts[ninst].natcall + 2));
                     } else
@@ -1001,7 +1007,7 @@ uintptr_t dynarec64_00_3(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
                     if (dyn->insts[ninst].natcall && isRetX87Wrapper(*(wrapper_t*)(dyn->insts[ninst].natcall + 2)))
                         // return value will be on the stack, so the stack depth needs to be updated
                         x87_purgecache(dyn, ninst, 0, x3, x1, x4);
-                    if ((BOX64ENV(log) < 2 && !BOX64ENV(rolling_log)) && dyn->insts[ninst].natcall && tmp) {
+                    if ((BOX64ENV(log) < 2 && !BOX64ENV(rolling_log) && !BOX64ENV(stats)) && dyn->insts[ninst].natcall && tmp) {
                         call_n(dyn, ninst, (void*)(dyn->insts[ninst].natcall + 2 + 8), tmp);
                         POP1(xRIP); // pop the return address
                         dyn->last_ip = addr;
@@ -1071,6 +1077,17 @@ uintptr_t dynarec64_00_3(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int
                         j64 = (uint32_t)(addr + i32);
                     else
                         j64 = addr + i32;
+                    if (dyn->insts[ninst].pltgot) {
+                        // skip the PLT stub: direct jump to the GOT target if the slot didn't change, indirect one else
+                        MESSAGE(LOG_DUMP, "PLT stub %p folded (GOT %p)\n", (void*)j64, (void*)dyn->insts[ninst].pltgot);
+                        MOV64x(x4, dyn->insts[ninst].pltgot);
+                        LD(x1, x4, 0);
+                        MOV64x(x4, dyn->insts[ninst].pltval);
+                        BEQ_MARK3(x1, x4);
+                        jump_to_next(dyn, 0, x1, ninst, rex.is32bits);
+                        MARK3;
+                        j64 = dyn->insts[ninst].pltval;
+                    }
                     jump_to_next(dyn, j64, 0, ninst, rex.is32bits);
                     MARK;
                     if (BOX64DRENV(dynarec_callret) && dyn->vector_sew != VECTOR_SEWNA)
@@ -0,0 +1,223 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "box64cpu.h"
+#include "emu/x64emu_private.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "dynarec_native.h"
+
+#include "rv64_printer.h"
+#include "dynarec_rv64_private.h"
+#include "dynarec_rv64_functions.h"
+#include "../dynarec_helper.h"
+
+uintptr_t dynarec64_AVX_0F(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog)
+{
+    (void)ip;
+    (void)need_epilog;
+
+    uint8_t opcode = F8;
+    uint8_t nextop;
+    uint8_t gd, ed;
+    uint8_t wback;
+    int v0, v1, v2;
+    int64_t fixedaddress;
+    int unscaled;
+
+    rex_t rex = vex.rex;
+
+    MAYUSE(v2);
+
+    switch (opcode) {
+        case 0x10:
+        case 0x28:
+            if (opcode == 0x10) {
+                INST_NAME("VMOVUPS Gx, Ex");
+            } else {
+                INST_NAME("VMOVAPS Gx, Ex");
+            }
+            nextop = F8;
+            GETG;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW8, 1);
+            GETEX_avx(v1, 0, VECTOR_SEW8);
+            v0 = sse_get_reg_empty_vector(dyn, ninst, x1, gd);
+            VMV_V_V(v0, v1);
+            if (vex.l) {
+                GETEY_avx(v1, VECTOR_SEW8);
+                PUTGY_avx(v1);
+            } else {
+                YMM0(gd);
+            }
+            break;
+        case 0x11:
+        case 0x29:
+            if (opcode == 0x11) {
+                INST_NAME("VMOVUPS Ex, Gx");
+            } else {
+                INST_NAME("VMOVAPS Ex, Gx");
+            }
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW8, 1);
+            GETGX_vector(v0, 0, VECTOR_SEW8);
+            PUTEX_avx(v0, v1);
+            break;
+        case 0x51:
+            INST_NAME("VSQRTPS Gx, Ex");
+            nextop = F8;
+            GETG;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW32, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) {
+                    GETEX_avx(v1, 0, VECTOR_SEW32);
+                    v0 = sse_get_reg_empty_vector(dyn, ninst, x1, gd);
+                } else {
+                    GETEY_avx(v1, VECTOR_SEW32);
+                    v0 = fpu_get_scratch(dyn);
+                }
+                VFSQRT_V(v0, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x54:
+            INST_NAME("VANDPS Gx, Vx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW64); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW64); }
+                VAND_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x55:
+            INST_NAME("VANDNPS Gx, Vx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW64); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW64); }
+                if (v0 == v1) {
+                    // Gx is also Ex, need a scratch for the NOT
+                    v1 = fpu_get_scratch(dyn);
+                    VMV_V_V(v1, v0);
+                }
+                VXOR_VI(v0, v2, 0x1f, VECTOR_UNMASKED);
+                VAND_VV(v0, v0, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x56:
+            INST_NAME("VORPS Gx, Vx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW64); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW64); }
+                VOR_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x57:
+            INST_NAME("VXORPS Gx, Vx, Ex");
+            nextop = F8;
+            GETG;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            if (MODREG && ((nextop & 7) + (rex.b << 3)) == vex.v) {
+                // special case: zeroing
+                v0 = sse_get_reg_empty_vector(dyn, ninst, x1, gd);
+                VXOR_VV(v0, v0, v0, VECTOR_UNMASKED);
+                YMM0(gd);
+                break;
+            }
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW64); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW64); }
+                VXOR_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x58:
+            INST_NAME("VADDPS Gx, Vx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW32, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW32); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW32); }
+                VFADD_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x59:
+            if (!BOX64ENV(dynarec_fastnan)) {
+                DEFAULT;
+                break;
+            }
+            INST_NAME("VMULPS Gx, Vx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW32, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW32); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW32); }
+                VFMUL_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x5C:
+            if (!BOX64ENV(dynarec_fastnan)) {
+                DEFAULT;
+                break;
+            }
+            INST_NAME("VSUBPS Gx, Vx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW32, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW32); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW32); }
+                VFSUB_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x5E:
+            if (!BOX64ENV(dynarec_fastnan)) {
+                DEFAULT;
+                break;
+            }
+            INST_NAME("VDIVPS Gx, Vx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW32, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW32); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW32); }
+                VFDIV_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x77:
+            if (!vex.l) {
+                INST_NAME("VZEROUPPER");
+                for (int i = 0; i < (rex.is32bits ? 8 : 16); ++i)
+                    YMM0(i);
+            } else {
+                INST_NAME("VZEROALL");
+                SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+                for (int i = 0; i < (rex.is32bits ? 8 : 16); ++i) {
+                    v0 = sse_get_reg_empty_vector(dyn, ninst, x1, i);
+                    VXOR_VV(v0, v0, v0, VECTOR_UNMASKED);
+                    YMM0(i);
+                }
+            }
+            break;
+        default:
+            DEFAULT;
+    }
+    return addr;
+}
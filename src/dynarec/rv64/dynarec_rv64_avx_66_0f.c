@@ -0,0 +1,380 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "box64cpu.h"
+#include "emu/x64emu_private.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "dynarec_native.h"
+
+#include "rv64_printer.h"
+#include "dynarec_rv64_private.h"
+#include "dynarec_rv64_functions.h"
+#include "../dynarec_helper.h"
+
+uintptr_t dynarec64_AVX_66_0F(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog)
+{
+    (void)ip;
+    (void)need_epilog;
+
+    uint8_t opcode = F8;
+    uint8_t nextop, u8;
+    uint8_t gd, ed;
+    uint8_t wback;
+    int v0, v1, v2;
+    int64_t fixedaddress;
+    int unscaled;
+
+    rex_t rex = vex.rex;
+
+    MAYUSE(v2);
+
+    switch (opcode) {
+        case 0x10:
+        case 0x28:
+        case 0x6F:
+            if (opcode == 0x10) {
+                INST_NAME("VMOVUPD Gx, Ex");
+            } else if (opcode == 0x28) {
+                INST_NAME("VMOVAPD Gx, Ex");
+            } else {
+                INST_NAME("VMOVDQA Gx, Ex");
+            }
+            nextop = F8;
+            GETG;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW8, 1);
+            GETEX_avx(v1, 0, VECTOR_SEW8);
+            v0 = sse_get_reg_empty_vector(dyn, ninst, x1, gd);
+            VMV_V_V(v0, v1);
+            if (vex.l) {
+                GETEY_avx(v1, VECTOR_SEW8);
+                PUTGY_avx(v1);
+            } else {
+                YMM0(gd);
+            }
+            break;
+        case 0x11:
+        case 0x29:
+        case 0x7F:
+        case 0xE7:
+            if (opcode == 0x11) {
+                INST_NAME("VMOVUPD Ex, Gx");
+            } else if (opcode == 0x29) {
+                INST_NAME("VMOVAPD Ex, Gx");
+            } else if (opcode == 0x7F) {
+                INST_NAME("VMOVDQA Ex, Gx");
+            } else {
+                INST_NAME("VMOVNTDQ Ex, Gx");
+            }
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW8, 1);
+            GETGX_vector(v0, 0, VECTOR_SEW8);
+            PUTEX_avx(v0, v1);
+            break;
+        case 0x51:
+            INST_NAME("VSQRTPD Gx, Ex");
+            nextop = F8;
+            GETG;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) {
+                    GETEX_avx(v1, 0, VECTOR_SEW64);
+                    v0 = sse_get_reg_empty_vector(dyn, ninst, x1, gd);
+                } else {
+                    GETEY_avx(v1, VECTOR_SEW64);
+                    v0 = fpu_get_scratch(dyn);
+                }
+                VFSQRT_V(v0, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x54:
+        case 0xDB:
+            if (opcode == 0x54) {
+                INST_NAME("VANDPD Gx, Vx, Ex");
+            } else {
+                INST_NAME("VPAND Gx, Vx, Ex");
+            }
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW64); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW64); }
+                VAND_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x55:
+        case 0xDF:
+            if (opcode == 0x55) {
+                INST_NAME("VANDNPD Gx, Vx, Ex");
+            } else {
+                INST_NAME("VPANDN Gx, Vx, Ex");
+            }
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW64); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW64); }
+                if (v0 == v1) {
+                    // Gx is also Ex, need a scratch for the NOT
+                    v1 = fpu_get_scratch(dyn);
+                    VMV_V_V(v1, v0);
+                }
+                VXOR_VI(v0, v2, 0x1f, VECTOR_UNMASKED);
+                VAND_VV(v0, v0, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x56:
+        case 0xEB:
+            if (opcode == 0x56) {
+                INST_NAME("VORPD Gx, Vx, Ex");
+            } else {
+                INST_NAME("VPOR Gx, Vx, Ex");
+            }
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW64); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW64); }
+                VOR_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x57:
+        case 0xEF:
+            if (opcode == 0x57) {
+                INST_NAME("VXORPD Gx, Vx, Ex");
+            } else {
+                INST_NAME("VPXOR Gx, Vx, Ex");
+            }
+            nextop = F8;
+            GETG;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            if (MODREG && ((nextop & 7) + (rex.b << 3)) == vex.v) {
+                // special case: zeroing
+                v0 = sse_get_reg_empty_vector(dyn, ninst, x1, gd);
+                VXOR_VV(v0, v0, v0, VECTOR_UNMASKED);
+                YMM0(gd);
+                break;
+            }
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW64); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW64); }
+                VXOR_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x58:
+            INST_NAME("VADDPD Gx, Vx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW64); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW64); }
+                VFADD_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x59:
+            if (!BOX64ENV(dynarec_fastnan)) {
+                DEFAULT;
+                break;
+            }
+            INST_NAME("VMULPD Gx, Vx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW64); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW64); }
+                VFMUL_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x5C:
+            if (!BOX64ENV(dynarec_fastnan)) {
+                DEFAULT;
+                break;
+            }
+            INST_NAME("VSUBPD Gx, Vx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW64); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW64); }
+                VFSUB_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x5E:
+            if (!BOX64ENV(dynarec_fastnan)) {
+                DEFAULT;
+                break;
+            }
+            INST_NAME("VDIVPD Gx, Vx, Ex");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, VECTOR_SEW64); } else { GETGY_empty_VYEY_avx(v0, v2, v1, VECTOR_SEW64); }
+                VFDIV_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x6E:
+            INST_NAME("VMOVD Gx, Ed");
+            nextop = F8;
+            GETGX_empty_vector(v0);
+            GETED(0);
+            if (rex.w) {
+                SET_ELEMENT_WIDTH(x3, VECTOR_SEW64, 1);
+            } else {
+                SET_ELEMENT_WIDTH(x3, VECTOR_SEW32, 1);
+            }
+            VXOR_VV(v0, v0, v0, VECTOR_UNMASKED);
+            VECTOR_LOAD_VMASK(1, x4, 1);
+            VMERGE_VXM(v0, v0, ed);
+            YMM0(gd);
+            break;
+        case 0x74 ... 0x76:
+            if (opcode == 0x74) {
+                INST_NAME("VPCMPEQB Gx, Vx, Ex");
+                u8 = VECTOR_SEW8;
+            } else if (opcode == 0x75) {
+                INST_NAME("VPCMPEQW Gx, Vx, Ex");
+                u8 = VECTOR_SEW16;
+            } else {
+                INST_NAME("VPCMPEQD Gx, Vx, Ex");
+                u8 = VECTOR_SEW32;
+            }
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, u8, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, u8); } else { GETGY_empty_VYEY_avx(v0, v2, v1, u8); }
+                VMSEQ_VV(VMASK, v1, v2, VECTOR_UNMASKED);
+                VXOR_VV(v0, v0, v0, VECTOR_UNMASKED);
+                VMERGE_VIM(v0, v0, 0b11111); // implies vmask and widened it
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0x7E:
+            INST_NAME("VMOVD Ed, Gx");
+            nextop = F8;
+            if (rex.w) {
+                SET_ELEMENT_WIDTH(x1, VECTOR_SEW64, 1);
+            } else {
+                SET_ELEMENT_WIDTH(x1, VECTOR_SEW32, 1);
+            }
+            GETGX_vector(v0, 0, dyn->vector_eew);
+            if (MODREG) {
+                ed = TO_NAT((nextop & 7) + (rex.b << 3));
+                VMV_X_S(ed, v0);
+                if (!rex.w) ZEROUP(ed);
+            } else {
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, x3, &fixedaddress, rex, NULL, 1, 0);
+                VMV_X_S(x3, v0);
+                if (rex.w) {
+                    SD(x3, ed, fixedaddress);
+                } else {
+                    SW(x3, ed, fixedaddress);
+                }
+                SMWRITE2();
+            }
+            break;
+        case 0xD7:
+            if (cpuext.xtheadvector) {
+                // xtheadvector needs a LMUL8 widening for the mask, not worth it here
+                DEFAULT;
+                break;
+            }
+            INST_NAME("VPMOVMSKB Gd, Ex");
+            nextop = F8;
+            GETGD;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW8, 1);
+            GETEX_avx(v1, 0, VECTOR_SEW8);
+            VMSLT_VX(VMASK, v1, xZR, VECTOR_UNMASKED);
+            if (vex.l) {
+                GETEY_avx(v2, VECTOR_SEW8);
+                SET_ELEMENT_WIDTH(x1, VECTOR_SEW16, 1);
+                VMV_X_S(gd, VMASK);
+                ZEXTH(gd, gd);
+                SET_ELEMENT_WIDTH(x1, VECTOR_SEW8, 1);
+                VMSLT_VX(VMASK, v2, xZR, VECTOR_UNMASKED);
+                SET_ELEMENT_WIDTH(x1, VECTOR_SEW16, 1);
+                VMV_X_S(x4, VMASK);
+                ZEXTH(x4, x4);
+                SLLI(x4, x4, 16);
+                OR(gd, gd, x4);
+            } else {
+                SET_ELEMENT_WIDTH(x1, VECTOR_SEW16, 1);
+                VMV_X_S(gd, VMASK);
+                ZEXTH(gd, gd);
+            }
+            break;
+        case 0xF8:
+        case 0xF9:
+        case 0xFA:
+        case 0xFB:
+            if (opcode == 0xF8) {
+                INST_NAME("VPSUBB Gx, Vx, Ex");
+                u8 = VECTOR_SEW8;
+            } else if (opcode == 0xF9) {
+                INST_NAME("VPSUBW Gx, Vx, Ex");
+                u8 = VECTOR_SEW16;
+            } else if (opcode == 0xFA) {
+                INST_NAME("VPSUBD Gx, Vx, Ex");
+                u8 = VECTOR_SEW32;
+            } else {
+                INST_NAME("VPSUBQ Gx, Vx, Ex");
+                u8 = VECTOR_SEW64;
+            }
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, u8, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, u8); } else { GETGY_empty_VYEY_avx(v0, v2, v1, u8); }
+                VSUB_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        case 0xD4:
+        case 0xFC:
+        case 0xFD:
+        case 0xFE:
+            if (opcode == 0xD4) {
+                INST_NAME("VPADDQ Gx, Vx, Ex");
+                u8 = VECTOR_SEW64;
+            } else if (opcode == 0xFC) {
+                INST_NAME("VPADDB Gx, Vx, Ex");
+                u8 = VECTOR_SEW8;
+            } else if (opcode == 0xFD) {
+                INST_NAME("VPADDW Gx, Vx, Ex");
+                u8 = VECTOR_SEW16;
+            } else {
+                INST_NAME("VPADDD Gx, Vx, Ex");
+                u8 = VECTOR_SEW32;
+            }
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, u8, 1);
+            for (int l = 0; l < 1 + vex.l; ++l) {
+                if (!l) { GETGX_empty_VXEX_avx(v0, v2, v1, 0, u8); } else { GETGY_empty_VYEY_avx(v0, v2, v1, u8); }
+                VADD_VV(v0, v2, v1, VECTOR_UNMASKED);
+                if (l) PUTGY_avx(v0);
+            }
+            if (!vex.l) YMM0(gd);
+            break;
+        default:
+            DEFAULT;
+    }
+    return addr;
+}
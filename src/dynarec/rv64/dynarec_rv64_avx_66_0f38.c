@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "debug.h"
+#include "box64context.h"
+#include "box64cpu.h"
+#include "emu/x64emu_private.h"
+#include "x64emu.h"
+#include "box64stack.h"
+#include "callback.h"
+#include "emu/x64run_private.h"
+#include "x64trace.h"
+#include "dynarec_native.h"
+
+#include "rv64_printer.h"
+#include "dynarec_rv64_private.h"
+#include "dynarec_rv64_functions.h"
+#include "../dynarec_helper.h"
+
+uintptr_t dynarec64_AVX_66_0F38(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog)
+{
+    (void)ip;
+    (void)need_epilog;
+
+    uint8_t opcode = F8;
+    uint8_t nextop, u8;
+    uint8_t gd, ed;
+    int v0, v1;
+    int64_t fixedaddress;
+    int unscaled;
+
+    rex_t rex = vex.rex;
+
+    switch (opcode) {
+        case 0x18:
+        case 0x19:
+        case 0x58:
+        case 0x59:
+        case 0x78:
+        case 0x79:
+            if (opcode == 0x18) {
+                INST_NAME("VBROADCASTSS Gx, Ex");
+                u8 = VECTOR_SEW32;
+            } else if (opcode == 0x19) {
+                INST_NAME("VBROADCASTSD Gx, Ex");
+                u8 = VECTOR_SEW64;
+            } else if (opcode == 0x58) {
+                INST_NAME("VPBROADCASTD Gx, Ex");
+                u8 = VECTOR_SEW32;
+            } else if (opcode == 0x59) {
+                INST_NAME("VPBROADCASTQ Gx, Ex");
+                u8 = VECTOR_SEW64;
+            } else if (opcode == 0x78) {
+                INST_NAME("VPBROADCASTB Gx, Ex");
+                u8 = VECTOR_SEW8;
+            } else {
+                INST_NAME("VPBROADCASTW Gx, Ex");
+                u8 = VECTOR_SEW16;
+            }
+            nextop = F8;
+            GETG;
+            SET_ELEMENT_WIDTH(x1, u8, 1);
+            if (MODREG) {
+                v1 = sse_get_reg_vector(dyn, ninst, x1, (nextop & 7) + (rex.b << 3), 0, u8);
+                VMV_X_S(x4, v1);
+            } else {
+                SMREAD();
+                addr = geted(dyn, addr, ninst, nextop, &ed, x2, x3, &fixedaddress, rex, NULL, 1, 0);
+                switch (u8) {
+                    case VECTOR_SEW8: LBU(x4, ed, fixedaddress); break;
+                    case VECTOR_SEW16: LHU(x4, ed, fixedaddress); break;
+                    case VECTOR_SEW32: LWU(x4, ed, fixedaddress); break;
+                    default: LD(x4, ed, fixedaddress);
+                }
+            }
+            v0 = sse_get_reg_empty_vector(dyn, ninst, x1, gd);
+            VMV_V_X(v0, x4);
+            if (vex.l) {
+                PUTGY_avx(v0);
+            } else {
+                YMM0(gd);
+            }
+            break;
+        default:
+            DEFAULT;
+    }
+    return addr;
+}
@@ -87,6 +87,36 @@ uintptr_t dynarec64_AVX_F3_0F(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip,
             }
             YMM0(gd);
             break;
+        case 0x6F:
+            if (!cpuext.vector) {
+                DEFAULT;
+                break;
+            }
+            INST_NAME("VMOVDQU Gx, Ex");
+            nextop = F8;
+            GETG;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW8, 1);
+            GETEX_avx(v1, 0, VECTOR_SEW8);
+            v0 = sse_get_reg_empty_vector(dyn, ninst, x1, gd);
+            VMV_V_V(v0, v1);
+            if (vex.l) {
+                GETEY_avx(v1, VECTOR_SEW8);
+                PUTGY_avx(v1);
+            } else {
+                YMM0(gd);
+            }
+            break;
+        case 0x7F:
+            if (!cpuext.vector) {
+                DEFAULT;
+                break;
+            }
+            INST_NAME("VMOVDQU Ex, Gx");
+            nextop = F8;
+            SET_ELEMENT_WIDTH(x1, VECTOR_SEW8, 1);
+            GETGX_vector(v0, 0, VECTOR_SEW8);
+            PUTEX_avx(v0, v1);
+            break;
         default:
             DEFAULT;
     }
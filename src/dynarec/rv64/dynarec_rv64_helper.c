@@ -2143,6 +2143,28 @@ void ymm_mark_zero(dynarec_rv64_t* dyn, int ninst, int a)
     avx_mark_zero(dyn, ninst, a);
 }
 
+int ymm_load_upper(dynarec_rv64_t* dyn, int ninst, int s1, int a)
+{
+    int ret = fpu_get_scratch(dyn);
+    if (is_avx_zero(dyn, ninst, a)) {
+        VXOR_VV(ret, ret, ret, VECTOR_UNMASKED);
+    } else {
+        ADDI(s1, xEmu, offsetof(x64emu_t, ymm[a]));
+        VLE_V(ret, s1, dyn->vector_eew, VECTOR_UNMASKED, VECTOR_NFIELD1);
+    }
+    return ret;
+}
+
+void ymm_store_upper(dynarec_rv64_t* dyn, int ninst, int s1, int a, int v)
+{
+    ADDI(s1, xEmu, offsetof(x64emu_t, ymm[a]));
+    VSE_V(v, s1, dyn->vector_eew, VECTOR_UNMASKED, VECTOR_NFIELD1);
+#if STEP == 0
+    dyn->insts[ninst].ymm0_sub |= (1 << a);
+#endif
+    avx_unmark_zero(dyn, ninst, a);
+}
+
 void fpu_pushcache(dynarec_rv64_t* dyn, int ninst, int s1, int not07)
 {
     // for float registers, we might lost f0..f7, f10..f17 and f28..f31, that means
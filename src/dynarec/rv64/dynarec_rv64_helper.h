@@ -560,6 +560,78 @@
     gd = ((nextop & 0x38) >> 3) + (rex.r << 3); \
     a = sse_get_reg_empty_vector(dyn, ninst, x1, gd)
 
+// AVX: get VX as a quad (x1 is used)
+#define GETVX_vector(a, w, sew) \
+    a = sse_get_reg_vector(dyn, ninst, x1, vex.v, w, sew)
+
+// AVX: get EX as a quad, VEX memory operands can be unaligned, so they are loaded as bytes. sew is restored after. (x1 is used, wback is the address)
+#define GETEX_avx(a, D, sew)                                                                    \
+    if (MODREG) {                                                                               \
+        ed = (nextop & 7) + (rex.b << 3);                                                       \
+        a = sse_get_reg_vector(dyn, ninst, x1, ed, 0, sew);                                     \
+    } else {                                                                                    \
+        SMREAD();                                                                               \
+        ed = 16;                                                                                \
+        addr = geted(dyn, addr, ninst, nextop, &wback, x3, x2, &fixedaddress, rex, NULL, 0, D); \
+        a = fpu_get_scratch(dyn);                                                               \
+        SET_ELEMENT_WIDTH(x1, VECTOR_SEW8, 1);                                                  \
+        VLE_V(a, wback, VECTOR_SEW8, VECTOR_UNMASKED, VECTOR_NFIELD1);                          \
+        SET_ELEMENT_WIDTH(x1, sew, 1);                                                          \
+    }
+
+// AVX: get the upper part of EX, after a GETEX_avx (x1 and x2 are used)
+#define GETEY_avx(a, sew)                                              \
+    if (MODREG) {                                                      \
+        a = ymm_load_upper(dyn, ninst, x1, ed);                        \
+    } else {                                                           \
+        a = fpu_get_scratch(dyn);                                      \
+        ADDI(x2, wback, 16);                                           \
+        SET_ELEMENT_WIDTH(x1, VECTOR_SEW8, 1);                         \
+        VLE_V(a, x2, VECTOR_SEW8, VECTOR_UNMASKED, VECTOR_NFIELD1);    \
+        SET_ELEMENT_WIDTH(x1, sew, 1);                                 \
+    }
+
+// AVX: get the upper part of VX and GX (x1 is used)
+#define GETVY_avx(a) a = ymm_load_upper(dyn, ninst, x1, vex.v)
+#define GETGY_avx(a) a = ymm_load_upper(dyn, ninst, x1, gd)
+// AVX: write a as the upper part of GX (x1 is used)
+#define PUTGY_avx(a) ymm_store_upper(dyn, ninst, x1, gd, a)
+
+// AVX: store GX (already in gx) and its upper part (if vex.l) to EX, using scratch v (x1, x2 and x3 are used)
+#define PUTEX_avx(gx, v)                                                                            \
+    if (MODREG) {                                                                                   \
+        ed = (nextop & 7) + (rex.b << 3);                                                           \
+        v = sse_get_reg_empty_vector(dyn, ninst, x1, ed);                                           \
+        VMV_V_V(v, gx);                                                                             \
+        if (vex.l) {                                                                                \
+            GETGY_avx(v);                                                                           \
+            ymm_store_upper(dyn, ninst, x1, ed, v);                                                 \
+        } else {                                                                                    \
+            YMM0(ed);                                                                               \
+        }                                                                                           \
+    } else {                                                                                        \
+        addr = geted(dyn, addr, ninst, nextop, &wback, x3, x2, &fixedaddress, rex, NULL, 0, 0);     \
+        VSE_V(gx, wback, dyn->vector_eew, VECTOR_UNMASKED, VECTOR_NFIELD1);                         \
+        if (vex.l) {                                                                                \
+            GETGY_avx(v);                                                                           \
+            ADDI(x2, wback, 16);                                                                    \
+            VSE_V(v, x2, dyn->vector_eew, VECTOR_UNMASKED, VECTOR_NFIELD1);                         \
+        }                                                                                           \
+        SMWRITE2();                                                                                 \
+    }
+
+// AVX: get EX, VX and an empty GX, for a Gx = Vx op Ex
+#define GETGX_empty_VXEX_avx(gx, vx, ex, D, sew) \
+    GETEX_avx(ex, D, sew);                       \
+    GETVX_vector(vx, 0, sew);                    \
+    GETGX_empty_vector(gx)
+
+// AVX: same as GETGX_empty_VXEX_avx, for the upper parts. gx is a scratch to write back with PUTGY_avx
+#define GETGY_empty_VYEY_avx(gx, vx, ex, sew) \
+    GETEY_avx(ex, sew);                       \
+    GETVY_avx(vx);                            \
+    gx = fpu_get_scratch(dyn)
+
 
 #define SSE_LOOP_D_ITEM(GX1, EX1, F, i)    \
     LWU(GX1, gback, gdoffset + i * 4);     \
@@ -779,6 +851,10 @@
 #define BEQZ_MARK3(reg) BEQ_MARK3(reg, xZR)
 // Branch to MARK3 instruction unconditionnal (use j64)
 #define B_MARK3_nocond Bxx_gen(__, MARK3, 0, 0)
+// Branch to MARKF2 if reg1<reg2 (unsigned) (use j64)
+#define BLTU_MARKF2(reg1, reg2) Bxx_gen(LTU, MARKF2, reg1, reg2)
+// Branch to MARKF instruction unconditionnal (use j64)
+#define B_MARKF_nocond Bxx_gen(__, MARKF, 0, 0)
 // Branch to MARKLOCK if reg1!=reg2 (use j64)
 #define BNE_MARKLOCK(reg1, reg2) Bxx_gen(NE, MARKLOCK, reg1, reg2)
 // Branch to MARKLOCK if reg1!=0 (use j64)
@@ -1270,8 +1346,11 @@
 #define dynarec64_F20F_vector STEPNAME(dynarec64_F20F_vector)
 #define dynarec64_F30F_vector STEPNAME(dynarec64_F30F_vector)
 
-#define dynarec64_AVX       STEPNAME(dynarec64_AVX)
-#define dynarec64_AVX_F3_0F STEPNAME(dynarec64_AVX_F3_0F)
+#define dynarec64_AVX         STEPNAME(dynarec64_AVX)
+#define dynarec64_AVX_F3_0F   STEPNAME(dynarec64_AVX_F3_0F)
+#define dynarec64_AVX_0F      STEPNAME(dynarec64_AVX_0F)
+#define dynarec64_AVX_66_0F   STEPNAME(dynarec64_AVX_66_0F)
+#define dynarec64_AVX_66_0F38 STEPNAME(dynarec64_AVX_66_0F38)
 
 #define geted               STEPNAME(geted)
 #define geted32             STEPNAME(geted32)
@@ -1410,6 +1489,8 @@
 #define sse_reflect_reg          STEPNAME(sse_reflect_reg)
 
 #define ymm_mark_zero STEPNAME(ymm_mark_zero)
+#define ymm_load_upper  STEPNAME(ymm_load_upper)
+#define ymm_store_upper STEPNAME(ymm_store_upper)
 
 #define mmx_get_reg_vector       STEPNAME(mmx_get_reg_vector)
 #define mmx_get_reg_empty_vector STEPNAME(mmx_get_reg_empty_vector)
@@ -1670,6 +1751,10 @@ void sse_reflect_reg(dynarec_rv64_t* dyn, int ninst, int s1, int a);
 
 // mark an ymm upper part has zero (forgetting upper part if needed)
 void ymm_mark_zero(dynarec_rv64_t* dyn, int ninst, int a);
+// load the upper part of an ymm in a scratch rvv register (zeroed if marked as zero)
+int ymm_load_upper(dynarec_rv64_t* dyn, int ninst, int s1, int a);
+// store rvv register v as the upper part of an ymm
+void ymm_store_upper(dynarec_rv64_t* dyn, int ninst, int s1, int a, int v);
 
 // common coproc helpers
 // reset the cache with n
@@ -1730,6 +1815,9 @@ uintptr_t dynarec64_F30F_vector(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t i
 
 uintptr_t dynarec64_AVX(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog);
 uintptr_t dynarec64_AVX_F3_0F(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog);
+uintptr_t dynarec64_AVX_0F(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog);
+uintptr_t dynarec64_AVX_66_0F(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog);
+uintptr_t dynarec64_AVX_66_0F38(dynarec_rv64_t* dyn, uintptr_t addr, uintptr_t ip, int ninst, vex_t vex, int* ok, int* need_epilog);
 
 #if STEP < 2
 #define PASS2(A)
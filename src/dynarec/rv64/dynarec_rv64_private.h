@@ -116,6 +116,8 @@ typedef struct instruction_rv64_s {
     uintptr_t           marklock2;
     int                 pass2choice;// value for choices that are fixed on pass2 for pass3
     uintptr_t           natcall;
+    uintptr_t           pltgot;     // CALL to a PLT stub: address of its GOT slot
+    uintptr_t           pltval;     // and the value of the slot when the block was built
     uint16_t            retn;
     uint16_t            purge_ymm;  // need to purge some ymm
     uint16_t            ymm0_in;    // bitmap of ymm to zero at purge
@@ -179,6 +181,7 @@ typedef struct dynarec_rv64_s {
     int                 callret_size;   // size of the array
     callret_t*          callrets;   // arrey of callret return, with NOP / UDF depending if the block is clean or dirty
     uint8_t             smwrite;    // for strongmem model emulation
+    uint8_t             weakmem;    // strongmem barriers not needed (process still single threaded)
     uintptr_t           forward;    // address of the last end of code while testing forward
     uintptr_t           forward_to; // address of the next jump to (to check if everything is ok)
     int32_t             forward_size;   // size at the forward point
@@ -0,0 +1,226 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <elf.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "os.h"
+#include "debug.h"
+#include "env.h"
+#include "box64version.h"
+#include "elfloader.h"
+#include "elfloader_private.h"
+#include "librarian.h"
+#include "library.h"
+#include "box64context.h"
+#include "khash.h"
+
+/*
+    Binding cache (BOX64_BINDCACHE): for each relocation, remember in which lib the symbol was found,
+    so on next launch the lookup is done on that lib only instead of searching all the maplib.
+    A table is only used if the elf, and all the libs of the search scope (in order) are the same.
+    Replaying a bind still look the symbol in the lib, and fall back to the full search if not there.
+*/
+
+#define BINDCACHE_SIGN      "BindCache"
+#define BINDCACHE_VERSION   2
+
+typedef struct bindcache_header_s {
+    char        sign[10];   // "BindCache\0"
+    uint16_t    version;
+    uint32_t    cnt[2];     // rela / plt
+    uint64_t    key[2];
+} bindcache_header_t;
+
+struct bindcache_s {
+    bindcache_header_t  file;       // what was read from disk
+    symbind_t*          file_binds[2];
+    uint64_t            key[2];
+    uint32_t            cnt[2];
+    symbind_t*          binds[2];
+    int                 dirty;
+};
+
+uint64_t ElfBindHash(uint64_t hash, const void* p, size_t sz)
+{
+    // FNV-1a
+    for(size_t i=0; i<sz; ++i)
+        hash = (hash^((const uint8_t*)p)[i])*0x100000001b3ULL;
+    return hash;
+}
+
+uint64_t ElfBuildId(elfheader_t* h)
+{
+    if(h->buildid)
+        return h->buildid;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    int found = 0;
+    if(!box64_is32bits && h->memory)
+        for(int i=0; i<h->numPHEntries && !found; ++i) {
+            Elf64_Phdr* ph = &h->PHEntries._64[i];
+            if(ph->p_type!=PT_NOTE || ph->p_vaddr<h->vaddr || ph->p_vaddr-h->vaddr+ph->p_filesz>h->memsz)
+                continue;
+            uint8_t* p = (uint8_t*)(ph->p_vaddr + h->delta);
+            uint8_t* end = p + ph->p_filesz;
+            while(p+sizeof(Elf64_Nhdr)<=end) {
+                Elf64_Nhdr* n = (Elf64_Nhdr*)p;
+                uint8_t* name = p + sizeof(Elf64_Nhdr);
+                uint8_t* desc = name + ((n->n_namesz+3)&~3);
+                if(desc+n->n_descsz>end)
+                    break;
+                if(n->n_type==NT_GNU_BUILD_ID && n->n_namesz==4 && !memcmp(name, "GNU", 4)) {
+                    hash = ElfBindHash(hash, desc, n->n_descsz);
+                    found = 1;
+                    break;
+                }
+                p = desc + ((n->n_descsz+3)&~3);
+            }
+        }
+    if(!found && h->path) {
+        // no build-id, use the file itself
+        struct stat st;
+        hash = ElfBindHash(hash, h->path, strlen(h->path));
+        if(!stat(h->path, &st)) {
+            hash = ElfBindHash(hash, &st.st_size, sizeof(st.st_size));
+            hash = ElfBindHash(hash, &st.st_mtime, sizeof(st.st_mtime));
+        }
+    }
+    h->buildid = hash?hash:1;
+    return h->buildid;
+}
+
+static uint64_t bindCacheKey(lib_t* maplib, lib_t* local_maplib, int bindnow, int deepbind, elfheader_t* head, int cnt)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    int vals[] = {BINDCACHE_VERSION, BOX64_MAJOR, BOX64_MINOR, BOX64_REVISION, cnt, bindnow, deepbind};
+    hash = ElfBindHash(hash, vals, sizeof(vals));
+    uint64_t id = ElfBuildId(head);
+    hash = ElfBindHash(hash, &id, sizeof(id));
+    id = ElfBuildId(my_context->elfs[0]);
+    hash = ElfBindHash(hash, &id, sizeof(id));
+    if(my_context->preload)
+        for(int i=0; i<my_context->preload->size; ++i) {
+            library_t* lib = my_context->preload->libs[i];
+            id = (lib && GetElf(lib))?ElfBuildId(GetElf(lib)):0;
+            hash = ElfBindHash(hash, &id, sizeof(id));
+        }
+    hash = MapLibHash(maplib, hash);
+    hash = MapLibHash(local_maplib, hash);
+    return hash;
+}
+
+static const char* bindCacheName(elfheader_t* h)
+{
+    const char* folder = GetDynacacheFolder(NULL);
+    if(!folder || !h->path)
+        return NULL;
+    static char name[4096];
+    const char* base = strrchr(h->path, '/');
+    base = base?(base+1):h->path;
+    snprintf(name, sizeof(name), "%s%s-%u.bind", folder, base, __ac_X31_hash_string(h->path));
+    return name;
+}
+
+static void loadBindCache(elfheader_t* h)
+{
+    h->bindcache = box_calloc(1, sizeof(bindcache_t));
+    const char* name = bindCacheName(h);
+    if(!name)
+        return;
+    FILE* f = fopen(name, "rb");
+    if(!f)
+        return;
+    bindcache_header_t* header = &h->bindcache->file;
+    if(fread(header, sizeof(*header), 1, f)!=1 || memcmp(header->sign, BINDCACHE_SIGN, sizeof(BINDCACHE_SIGN)) || header->version!=BINDCACHE_VERSION) {
+        printf_log(LOG_DEBUG, "BindCache: ignoring invalid %s\n", name);
+        memset(header, 0, sizeof(*header));
+        fclose(f);
+        return;
+    }
+    for(int i=0; i<2; ++i)
+        if(header->cnt[i]) {
+            h->bindcache->file_binds[i] = box_malloc(header->cnt[i]*sizeof(symbind_t));
+            if(fread(h->bindcache->file_binds[i], sizeof(symbind_t), header->cnt[i], f)!=header->cnt[i]) {
+                box_free(h->bindcache->file_binds[i]);
+                h->bindcache->file_binds[i] = NULL;
+                header->cnt[i] = 0;
+            }
+        }
+    fclose(f);
+}
+
+symbind_t* GetElfBindCache(lib_t* maplib, lib_t* local_maplib, int bindnow, int deepbind, elfheader_t* h, int plt, int cnt, int* replay)
+{
+    *replay = 0;
+    if(!BOX64ENV(bindcache) || !cnt)
+        return NULL;
+    uint64_t key = bindCacheKey(maplib, local_maplib, bindnow, deepbind, h, cnt);
+    if(!h->bindcache)
+        loadBindCache(h);
+    bindcache_t* bc = h->bindcache;
+    if(bc->binds[plt])
+        box_free(bc->binds[plt]);
+    bc->binds[plt] = box_calloc(cnt, sizeof(symbind_t));
+    bc->cnt[plt] = cnt;
+    bc->key[plt] = key;
+    if(bc->file_binds[plt] && bc->file.cnt[plt]==(uint32_t)cnt && bc->file.key[plt]==key) {
+        memcpy(bc->binds[plt], bc->file_binds[plt], cnt*sizeof(symbind_t));
+        *replay = 1;
+    } else
+        bc->dirty = 1;
+    return bc->binds[plt];
+}
+
+void ElfBindCacheChanged(elfheader_t* h)
+{
+    if(h->bindcache)
+        h->bindcache->dirty = 1;
+}
+
+void FreeElfBindCache(elfheader_t* h)
+{
+    bindcache_t* bc = h->bindcache;
+    if(!bc)
+        return;
+    for(int i=0; i<2; ++i) {
+        box_free(bc->binds[i]);
+        box_free(bc->file_binds[i]);
+    }
+    box_free(bc);
+    h->bindcache = NULL;
+}
+
+void SaveElfBindCache(elfheader_t* h)
+{
+    bindcache_t* bc = h->bindcache;
+    if(!bc)
+        return;
+    const char* name = (bc->dirty && BOX64ENV(bindcache)==1)?bindCacheName(h):NULL;
+    if(name) {
+        bindcache_header_t header = {0};
+        strcpy(header.sign, BINDCACHE_SIGN);
+        header.version = BINDCACHE_VERSION;
+        for(int i=0; i<2; ++i) {
+            header.cnt[i] = bc->binds[i]?bc->cnt[i]:0;
+            header.key[i] = bc->key[i];
+        }
+        unlink(name);
+        FILE* f = fopen(name, "wbx");
+        if(f) {
+            int ok = (fwrite(&header, sizeof(header), 1, f)==1);
+            for(int i=0; i<2 && ok; ++i)
+                if(header.cnt[i])
+                    ok = (fwrite(bc->binds[i], sizeof(symbind_t), header.cnt[i], f)==header.cnt[i]);
+            fclose(f);
+            if(!ok) {
+                printf_log(LOG_INFO, "BindCache: error writing %s (disk full?)\n", name);
+                unlink(name);
+            } else
+                printf_log(LOG_DEBUG, "BindCache: saved %u+%u binds for %s\n", header.cnt[0], header.cnt[1], h->name);
+        } else
+            printf_log(LOG_INFO, "BindCache: cannot create %s\n", name);
+    }
+    FreeElfBindCache(h);
+}
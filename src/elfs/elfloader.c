@@ -94,6 +94,7 @@ void FreeElfHeader(elfheader_t** head)
     actual_free(h->DynStr);
     actual_free(h->SymTab._64);
     actual_free(h->DynSym._64);
+    FreeElfBindCache(h);
 
     FreeElfMemory(h);
 
@@ -575,9 +576,11 @@ static elfheader_t* checkElfLib(elfheader_t* h, library_t* lib)
     return h;
 }
 
-static int RelocateElfRELA(lib_t *maplib, lib_t *local_maplib, int bindnow, int deepbind, elfheader_t* head, int cnt, Elf64_Rela *rela, int* need_resolv)
+static int RelocateElfRELA(lib_t *maplib, lib_t *local_maplib, int bindnow, int deepbind, elfheader_t* head, int cnt, Elf64_Rela *rela, int* need_resolv, symbind_t* binds, int replay)
 {
     int ret_ok = 0;
+    int replayed = 0;
+    int changed = 0;
     for (int i=0; i<cnt; ++i) {
         int t = ELF64_R_TYPE(rela[i].r_info);
         Elf64_Sym *sym = &head->DynSym._64[ELF64_R_SYM(rela[i].r_info)];
@@ -626,13 +629,30 @@ static int RelocateElfRELA(lib_t *maplib, lib_t *local_maplib, int bindnow, int
                     if(!offs && !end && local_maplib && !deepbind)
                         GetLocalSymbolStartEnd(local_maplib, symname, &offs, &end, head, version, vername, veropt, (void**)&elfsym);
                 }
+            } else if(replay && binds[i].src!=SYMBIND_NONE
+                   && ReplayGlobalSymbolStartEnd(binds[i].local?local_maplib:maplib, symname, &offs, &end, head, version, vername, veropt, (void**)&elfsym, &binds[i])) {
+                ++replayed;
             } else {
-                if(!offs && !end && local_maplib && deepbind)
-                    GetGlobalSymbolStartEnd(local_maplib, symname, &offs, &end, head, version, vername, veropt, (void**)&elfsym);
-                if(!offs && !end)
-                    GetGlobalSymbolStartEnd(maplib, symname, &offs, &end, head, version, vername, veropt, (void**)&elfsym);
-                if(!offs && !end && local_maplib && !deepbind)
-                    GetGlobalSymbolStartEnd(local_maplib, symname, &offs, &end, head, version, vername, veropt, (void**)&elfsym);
+                symbind_t bind = {0};
+                bind.src = SYMBIND_NOTFOUND;
+                offs = end = 0;
+                elfsym = NULL;
+                if(!offs && !end && local_maplib && deepbind) {
+                    GetGlobalSymbolStartEndBind(local_maplib, symname, &offs, &end, head, version, vername, veropt, (void**)&elfsym, &bind);
+                    bind.local = 1;
+                }
+                if(!offs && !end) {
+                    GetGlobalSymbolStartEndBind(maplib, symname, &offs, &end, head, version, vername, veropt, (void**)&elfsym, &bind);
+                    bind.local = 0;
+                }
+                if(!offs && !end && local_maplib && !deepbind) {
+                    GetGlobalSymbolStartEndBind(local_maplib, symname, &offs, &end, head, version, vername, veropt, (void**)&elfsym, &bind);
+                    bind.local = 1;
+                }
+                if(binds && memcmp(&binds[i], &bind, sizeof(bind))) {
+                    binds[i] = bind;
+                    ++changed;
+                }
             }
         }
         sym_elf = FindElfSymbol(my_context, elfsym);
@@ -830,6 +850,10 @@ static int RelocateElfRELA(lib_t *maplib, lib_t *local_maplib, int bindnow, int
                 printf_log(LOG_INFO, "Warning, don't know of to handle rela #%d %s on %s\n", i, DumpRelType64(ELF64_R_TYPE(rela[i].r_info)), symname);
         }
     }
+    if(changed)
+        ElfBindCacheChanged(head);
+    if(binds)
+        printf_log(LOG_DEBUG, "BindCache: %d symbol lookup(s) replayed, %d recorded for %s\n", replayed, changed, head->name);
     return bindnow?ret_ok:0;
 }
 
@@ -883,7 +907,9 @@ int RelocateElf64(lib_t *maplib, lib_t *local_maplib, int bindnow, int deepbind,
         int cnt = head->relasz / head->relaent;
         DumpRelATable64(head, cnt, (Elf64_Rela *)(head->rela + head->delta), "RelA");
         printf_dump(LOG_DEBUG, "Applying %d Relocation(s) with Addend for %s bindnow=%d, deepbind=%d\n", cnt, head->name, bindnow, deepbind);
-        if(RelocateElfRELA(maplib, local_maplib, bindnow, deepbind, head, cnt, (Elf64_Rela *)(head->rela + head->delta), NULL))
+        int replay;
+        symbind_t* binds = GetElfBindCache(maplib, local_maplib, bindnow, deepbind, head, 0, cnt, &replay);
+        if(RelocateElfRELA(maplib, local_maplib, bindnow, deepbind, head, cnt, (Elf64_Rela *)(head->rela + head->delta), NULL, binds, replay))
             return -1;
     }
     return 0;
@@ -916,7 +942,9 @@ int RelocateElfPlt64(lib_t *maplib, lib_t *local_maplib, int bindnow, int deepbi
         } else if(head->pltrel==DT_RELA) {
             DumpRelATable64(head, cnt, (Elf64_Rela *)(head->jmprel + head->delta), "PLT");
             printf_dump(LOG_DEBUG, "Applying %d PLT Relocation(s) with Addend for %s bindnow=%d, deepbind=%d\n", cnt, head->name, bindnow, deepbind);
-            if(RelocateElfRELA(maplib, local_maplib, bindnow, deepbind, head, cnt, (Elf64_Rela *)(head->jmprel + head->delta), &need_resolver))
+            int replay;
+            symbind_t* binds = GetElfBindCache(maplib, local_maplib, bindnow, deepbind, head, 1, cnt, &replay);
+            if(RelocateElfRELA(maplib, local_maplib, bindnow, deepbind, head, cnt, (Elf64_Rela *)(head->jmprel + head->delta), &need_resolver, binds, replay))
                 return -1;
         }
         if(need_resolver) {
@@ -934,6 +962,7 @@ int RelocateElfPlt64(lib_t *maplib, lib_t *local_maplib, int bindnow, int deepbi
             }
         }
     }
+    SaveElfBindCache(head);
 
     return 0;
 }
@@ -1324,6 +1353,33 @@ elfheader_t* FindElfAddress(box64context_t *context, uintptr_t addr)
     return NULL;
 }
 
+uintptr_t GetPltStubGot(uintptr_t addr)
+{
+    if(!my_context || !addr || !(getProtection(addr)&PROT_READ))
+        return 0;
+    elfheader_t* h = FindElfAddress(my_context, addr);
+    if(!h || box64_is32bits)
+        return 0;
+    uint8_t* p = (uint8_t*)addr;
+    if(p[0]==0xf3 && p[1]==0x0f && p[2]==0x1e && p[3]==0xfa)  // endbr64 (.plt.sec)
+        p+=4;
+    if(p[0]==0xf2)  // bnd
+        ++p;
+    if(p[0]!=0xff || p[1]!=0x25)    // jmp *[rip+disp32]
+        return 0;
+    uintptr_t got = (uintptr_t)p + 6 + *(int32_t*)(p+2);
+    if(got&7)
+        return 0;
+    // the slot needs to be in the GOT of the same elf (or at least in the elf if there is no section headers)
+    if(h->gotplt || h->got) {
+        if(!(h->gotplt && got>=h->gotplt+h->delta && got<h->gotplt_end+h->delta)
+        && !(h->got && got>=h->got+h->delta && got<h->got_end+h->delta))
+            return 0;
+    } else if(!IsAddressInElfSpace(h, got))
+        return 0;
+    return got;
+}
+
 const char* FindNearestSymbolName(elfheader_t* h, void* p, uintptr_t* start, uint64_t* sz)
 {
     uintptr_t addr = (uintptr_t)p;
@@ -4,6 +4,8 @@
 typedef struct library_s library_t;
 typedef struct needed_libs_s needed_libs_t;
 typedef struct cleanup_s cleanup_t;
+typedef struct bindcache_s bindcache_t;
+typedef struct symbind_s symbind_t;
 
 #include <elf.h>
 #include "elfloader.h"
@@ -136,6 +138,9 @@ typedef struct elfheader_s {
     library_t   *lib;       // attached lib (exept on main elf)
     needed_libs_t* needed;
 
+    uint64_t    buildid;    // hash of the build-id (or of the file), 0 if not computed yet
+    bindcache_t* bindcache; // BOX64_BINDCACHE tables, only during relocation
+
     FILE*       file;
     int         fileno;
 
@@ -223,4 +228,11 @@ Elf64_Sym* ElfLookup64(elfheader_t* h, const char* symname, int ver, const char*
 Elf64_Sym* ElfSymTabLookup64(elfheader_t* h, const char* symname);
 Elf64_Sym* ElfDynSymLookup64(elfheader_t* h, const char* symname);
 
+// in elfbindcache.c
+// get the bind table of the rela (plt=0) or plt (plt=1) relocations. replay is set if it comes from the cache file
+symbind_t* GetElfBindCache(lib_t* maplib, lib_t* local_maplib, int bindnow, int deepbind, elfheader_t* h, int plt, int cnt, int* replay);
+void ElfBindCacheChanged(elfheader_t* h);
+void SaveElfBindCache(elfheader_t* h);  // write the file if needed and free the tables
+void FreeElfBindCache(elfheader_t* h);
+
 #endif //__ELFLOADER_PRIVATE_H_
@@ -15,6 +15,8 @@
 
 #include "os.h"
 #include "debug.h"
+#include "stats.h"
+#include "rollinglog.h"
 #include "box64stack.h"
 #include "x64emu.h"
 #include "box64cpu.h"
@@ -108,22 +110,30 @@ void x64Int3(x64emu_t* emu, uintptr_t* addr)
             wrapper_t w = bridge->w;
             a = F64(addr);
             R_RIP = *addr;
+            StatsWrapper(a);
             /* This part can be used to trace only 1 specific lib (but it is quite slow)
             elfheader_t *h = FindElfAddress(my_context, *(uintptr_t*)(R_ESP));
             int have_trace = 0;
             if(h && strstr(ElfName(h), "libMiles")) have_trace = 1;*/
-            if(BOX64ENV(log)>=LOG_DEBUG || BOX64ENV(rolling_log)) {
+            if(BOX64ENV(rolling_log)) {
+                // binary event only, formatted when the log is dumped
+                uint64_t id;
+                if(a==(uintptr_t)PltResolver64) {
+                    uintptr_t addr = *((uint64_t*)(R_RSP));
+                    int slot = *((uint64_t*)(R_RSP+8));
+                    elfheader_t *h = (elfheader_t*)addr;
+                    Elf64_Rela * rel = (Elf64_Rela *)(h->jmprel + h->delta) + slot;
+                    Elf64_Sym *sym = &h->DynSym._64[ELF64_R_SYM(rel->r_info)];
+                    id = RollingLogCall(RLOG_PLT, *(uintptr_t*)(R_RSP+16), a, SymName64(h, sym), 0, 0, 0, 0, 0, 0);
+                } else
+                    id = RollingLogCall(RLOG_CALL, *(uintptr_t*)(R_RSP), a, bridge->name, R_RDI, R_RSI, R_RDX, R_RCX, R_R8, R_R9);
+                w(emu, a);
+                RollingLogRet(id, R_RAX);
+            } else if(BOX64ENV(log)>=LOG_DEBUG) {
                 int tid = GetTID();
-                char t_buff[256] = "\0";
+                char buff[256] = "\0";
                 char buff2[64] = "\0";
                 char buff3[64] = "\0";
-                int cycle_line = my_context->current_line;
-                if(BOX64ENV(rolling_log)) {
-                    my_context->current_line = (my_context->current_line+1)%BOX64ENV(rolling_log);
-                }
-                char* buff = BOX64ENV(rolling_log)?(my_context->log_call+256*cycle_line):t_buff;
-                char* buffret = BOX64ENV(rolling_log)?(my_context->log_ret+128*cycle_line):NULL;
-                if(buffret) buffret[0] = '\0';
                 char *tmp;
                 int post = 0;
                 int perr = 0;
@@ -134,17 +144,7 @@ void x64Int3(x64emu_t* emu, uintptr_t* addr)
                 if(!s)
                     s = GetNativeName((void*)a);
                 if(a==(uintptr_t)PltResolver64) {
-                    if(BOX64ENV(rolling_log)) {
-                        uintptr_t addr = *((uint64_t*)(R_RSP));
-                        int slot = *((uint64_t*)(R_RSP+8));
-                        elfheader_t *h = (elfheader_t*)addr;
-                        Elf64_Rela * rel = (Elf64_Rela *)(h->jmprel + h->delta) + slot;
-                        Elf64_Sym *sym = &h->DynSym._64[ELF64_R_SYM(rel->r_info)];
-                        const char* symname = SymName64(h, sym);
-                        snprintf(buff, 256, "%04d|PltResolver \"%s\"", tid, symname?symname:"???");
-                    } else {
-                        snprintf(buff, 256, "%s", " ... ");
-                    }
+                    snprintf(buff, 256, "%s", " ... ");
                 } else if (!strcmp(s, "__open") || !strcmp(s, "open") || !strcmp(s, "open ") || !strcmp(s, "open64") || !strcmp(s, "my_open")) {
                     tmp = (char*)(R_RDI);
                     snprintf(buff, 256, "%04d|%p: Calling %s(\"%s\", %d (,%d))", tid, *(void**)(R_RSP), s, (tmp)?tmp:"(nil)", (int)(R_ESI), (int)(R_EDX));
@@ -326,11 +326,9 @@ void x64Int3(x64emu_t* emu, uintptr_t* addr)
                 } else {
                     x64Print(emu, buff, 256, s, tid, w);
                 }
-                if(!BOX64ENV(rolling_log)) {
-                    mutex_lock(&emu->context->mutex_trace);
-                    printf_log_prefix(0, LOG_NONE, "%s =>", buff);
-                    mutex_unlock(&emu->context->mutex_trace);
-                }
+                mutex_lock(&emu->context->mutex_trace);
+                printf_log_prefix(0, LOG_NONE, "%s =>", buff);
+                mutex_unlock(&emu->context->mutex_trace);
                 w(emu, a);   // some function never come back, so unlock the mutex first!
                 if(post)
                     switch(post) { // Only ever 2 for now...
@@ -378,13 +376,9 @@ void x64Int3(x64emu_t* emu, uintptr_t* addr)
                 else if(perr==3 && (S_RAX)==-1)
                     snprintf(buff3, 64, " (errno=%d:\"%s\")", errno, strerror(errno));
 
-                if(BOX64ENV(rolling_log))
-                    snprintf(buffret, 127, "0x%lX%s%s", R_RAX, buff2, buff3);
-                else {
-                    mutex_lock(&emu->context->mutex_trace);
-                    printf_log_prefix(0, LOG_NONE, " return 0x%lX%s%s\n", R_RAX, buff2, buff3);
-                    mutex_unlock(&emu->context->mutex_trace);
-                }
+                mutex_lock(&emu->context->mutex_trace);
+                printf_log_prefix(0, LOG_NONE, " return 0x%lX%s%s\n", R_RAX, buff2, buff3);
+                mutex_unlock(&emu->context->mutex_trace);
             } else
                 w(emu, a);
         }
@@ -405,19 +399,6 @@ void x64Int3(x64emu_t* emu, uintptr_t* addr)
     //emu->quit = 1;
 }
 
-void print_rolling_log(int loglevel) {
-    if(BOX64ENV(rolling_log)) {
-        printf_log(loglevel, "Last calls\n");
-        int j = (my_context->current_line+1)%BOX64ENV(rolling_log);
-        for (int i=0; i<BOX64ENV(rolling_log); ++i) {
-            int k = (i+j)%BOX64ENV(rolling_log);
-            if(my_context->log_call[256*k+0]) {
-                printf_log(loglevel, "%s => return %s\n", my_context->log_call+256*k, my_context->log_ret+128*k);
-            }
-        }
-    }
-}
-
 #ifndef BOX32
 void x86Int3(x64emu_t* emu, uintptr_t* addr)
 {
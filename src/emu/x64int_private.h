@@ -2,6 +2,8 @@
 #define __X64INT_PRIVATE_H_
 
 void x64Syscall(x64emu_t *emu);
+// native syscall number if syscall s can be done directly from translated code (0 else), nbpars is the number of args
+int x64SyscallDirect(uint32_t s, int* nbpars);
 void x64Int3(x64emu_t* emu, uintptr_t* addr);
 x64emu_t* x64emu_fork(x64emu_t* e, int forktype);
 void x86Syscall(x64emu_t *emu); //32bits syscall
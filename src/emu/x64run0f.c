@@ -31,6 +31,7 @@
 #endif
 
 #include "modrm.h"
+#include "x64simd.h"
 
 #ifdef TEST_INTERPRETER
 uintptr_t Test0F(x64test_t *test, rex_t rex, uintptr_t addr, int *step)
@@ -795,21 +796,13 @@ uintptr_t Run0F(x64emu_t *emu, rex_t rex, uintptr_t addr, int *step)
             nextop = F8;
             GETEX(0);
             GETGX;
-            for(int i=0; i<4; ++i) {
-                maskps[i] = isnanf(GX->f[i]) || isnanf(EX->f[i]);
-                GX->f[i] += EX->f[i];
-                if(isnanf(GX->f[i]) && !maskps[i]) GX->ud[i] |= 0x80000000;
-            }
+            simd_addps(GX, GX, EX);
             break;
         case 0x59:                      /* MULPS Gx, Ex */
             nextop = F8;
             GETEX(0);
             GETGX;
-            for(int i=0; i<4; ++i) {
-                maskps[i] = isnanf(GX->f[i]) || isnanf(EX->f[i]);
-                GX->f[i] *= EX->f[i];
-                if(isnanf(GX->f[i]) && !maskps[i]) GX->ud[i] |= 0x80000000;
-            }
+            simd_mulps(GX, GX, EX);
             break;
         case 0x5A:                      /* CVTPS2PD Gx, Ex */
             nextop = F8;
@@ -831,11 +824,7 @@ uintptr_t Run0F(x64emu_t *emu, rex_t rex, uintptr_t addr, int *step)
             nextop = F8;
             GETEX(0);
             GETGX;
-            for(int i=0; i<4; ++i) {
-                maskps[i] = isnanf(GX->f[i]) || isnanf(EX->f[i]);
-                GX->f[i] -= EX->f[i];
-                if(isnanf(GX->f[i]) && !maskps[i]) GX->ud[i] |= 0x80000000;
-            }
+            simd_subps(GX, GX, EX);
             break;
         case 0x5D:                      /* MINPS Gx, Ex */
             nextop = F8;
@@ -850,11 +839,7 @@ uintptr_t Run0F(x64emu_t *emu, rex_t rex, uintptr_t addr, int *step)
             nextop = F8;
             GETEX(0);
             GETGX;
-            for(int i=0; i<4; ++i) {
-                maskps[i] = isnanf(GX->f[i]) || isnanf(EX->f[i]);
-                GX->f[i] /= EX->f[i];
-                if(isnanf(GX->f[i]) && !maskps[i]) GX->ud[i] |= 0x80000000;
-            }
+            simd_divps(GX, GX, EX);
             break;
         case 0x5F:                      /* MAXPS Gx, Ex */
             nextop = F8;
@@ -27,6 +27,7 @@
 
 #include "modrm.h"
 #include "x64compstrings.h"
+#include "x64simd.h"
 
 static uint8_t ff_mult(uint8_t a, uint8_t b)
 {
@@ -1328,21 +1329,13 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        MARK_NAN_VD_2(GX, EX);
-        for(int i=0; i<2; ++i) {
-            GX->d[i] += EX->d[i];
-        }
-        CHECK_NAN_VD(GX);
+        simd_addpd(GX, GX, EX);
         break;
     case 0x59:                      /* MULPD Gx, Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        MARK_NAN_VD_2(GX, EX);
-        for(int i=0; i<2; ++i) {
-            GX->d[i] *= EX->d[i];
-        }
-        CHECK_NAN_VD(GX);
+        simd_mulpd(GX, GX, EX);
         break;
     case 0x5A:                      /* CVTPD2PS Gx, Ex */
         nextop = F8;
@@ -1389,11 +1382,7 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        MARK_NAN_VD_2(GX, EX);
-        for(int i=0; i<2; ++i) {
-            GX->d[i] -= EX->d[i];
-        }
-        CHECK_NAN_VD(GX);
+        simd_subpd(GX, GX, EX);
         break;
     case 0x5D:                      /* MINPD Gx, Ex */
         nextop = F8;
@@ -1408,12 +1397,7 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<2; ++i) {
-            is_nan = isnan(GX->d[i]) || isnan(EX->d[i]);
-            GX->d[i] /= EX->d[i];
-            if(!is_nan && isnan(GX->d[i]))
-                GX->d[i] = -NAN;
-        }
+        simd_divpd(GX, GX, EX);
         break;
     case 0x5F:                      /* MAXPD Gx, Ex */
         nextop = F8;
@@ -1469,22 +1453,19 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<16; ++i)
-            GX->ub[i] = (GX->sb[i]>EX->sb[i])?0xFF:0x00;
+        simd_pcmpgtb(GX, GX, EX);
         break;
     case 0x65:  /* PCMPGTW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i)
-            GX->uw[i] = (GX->sw[i]>EX->sw[i])?0xFFFF:0x0000;
+        simd_pcmpgtw(GX, GX, EX);
         break;
     case 0x66:  /* PCMPGTD Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<4; ++i)
-            GX->ud[i] = (GX->sd[i]>EX->sd[i])?0xFFFFFFFF:0x00000000;
+        simd_pcmpgtd(GX, GX, EX);
         break;
     case 0x67:  /* PACKUSWB Gx,Ex */
         nextop = F8;
@@ -1589,22 +1570,15 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         switch((nextop>>3)&7) {
             case 2:                 /* PSRLW Ex, Ib */
                 tmp8u = F8;
-                if(tmp8u>15)
-                    {EX->q[0] = EX->q[1] = 0;}
-                else
-                    for (int i=0; i<8; ++i) EX->uw[i] >>= tmp8u;
+                simd_psrlw(EX, EX, tmp8u);
                 break;
             case 4:                 /* PSRAW Ex, Ib */
                 tmp8u = F8;
-                if(tmp8u>15) tmp8u=15;
-                for (int i=0; i<8; ++i) EX->sw[i] >>= tmp8u;
+                simd_psraw(EX, EX, tmp8u);
                 break;
             case 6:                 /* PSLLW Ex, Ib */
                 tmp8u = F8;
-                if(tmp8u>15)
-                    {EX->q[0] = EX->q[1] = 0;}
-                else
-                    for (int i=0; i<8; ++i) EX->uw[i] <<= tmp8u;
+                simd_psllw(EX, EX, tmp8u);
                 break;
             default:
                 return 0;
@@ -1616,22 +1590,15 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         switch((nextop>>3)&7) {
             case 2:                 /* PSRLD Ex, Ib */
                 tmp8u = F8;
-                if(tmp8u>31)
-                    {EX->q[0] = EX->q[1] = 0;}
-                else
-                    for (int i=0; i<4; ++i) EX->ud[i] >>= tmp8u;
+                simd_psrld(EX, EX, tmp8u);
                 break;
             case 4:                 /* PSRAD Ex, Ib */
                 tmp8u = F8;
-                if(tmp8u>31) tmp8u=31;
-                for (int i=0; i<4; ++i) EX->sd[i] >>= tmp8u;
+                simd_psrad(EX, EX, tmp8u);
                 break;
             case 6:                 /* PSLLD Ex, Ib */
                 tmp8u = F8;
-                if(tmp8u>31)
-                    {EX->q[0] = EX->q[1] = 0;}
-                else
-                    for (int i=0; i<4; ++i) EX->ud[i] <<= tmp8u;
+                simd_pslld(EX, EX, tmp8u);
                 break;
             default:
                 return 0;
@@ -1677,22 +1644,19 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<16; ++i)
-            GX->ub[i] = (GX->ub[i]==EX->ub[i])?0xff:0;
+        simd_pcmpeqb(GX, GX, EX);
         break;
     case 0x75:  /* PCMPEQW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<8; ++i)
-            GX->uw[i] = (GX->uw[i]==EX->uw[i])?0xffff:0;
+        simd_pcmpeqw(GX, GX, EX);
         break;
     case 0x76:  /* PCMPEQD Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<4; ++i)
-            GX->ud[i] = (GX->ud[i]==EX->ud[i])?0xffffffff:0;
+        simd_pcmpeqd(GX, GX, EX);
         break;
     
     case 0x78:  /* EXTRQ Ex, ib, ib */
@@ -2275,44 +2239,31 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        if(EX->q[0]>15)
-            {GX->q[0] = GX->q[1] = 0;}
-        else
-            {tmp8u=EX->ub[0]; for (int i=0; i<8; ++i) GX->uw[i] >>= tmp8u;}
+        simd_psrlw(GX, GX, EX->q[0]);
         break;
     case 0xD2:  /* PSRLD Gx, Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        if(EX->q[0]>31)
-            {GX->q[0] = GX->q[1] = 0;}
-        else
-            {tmp8u=EX->ub[0]; for (int i=0; i<4; ++i) GX->ud[i] >>= tmp8u;}
+        simd_psrld(GX, GX, EX->q[0]);
         break;
     case 0xD3:  /* PSRLQ Gx, Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        if(EX->q[0]>63)
-            {GX->q[0] = GX->q[1] = 0;}
-        else
-            {tmp8u=EX->ub[0]; for (int i=0; i<2; ++i) GX->q[i] >>= tmp8u;}
+        simd_psrlq(GX, GX, EX->q[0]);
         break;
     case 0xD4:  /* PADDQ Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        GX->sq[0] += EX->sq[0];
-        GX->sq[1] += EX->sq[1];
+        simd_paddq(GX, GX, EX);
         break;
     case 0xD5:  /* PMULLW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i) {
-            tmp32s = (int32_t)GX->sw[i] * EX->sw[i];
-            GX->sw[i] = tmp32s&0xffff;
-        }
+        simd_pmullw(GX, GX, EX);
         break;
     case 0xD6:                      /* MOVQ Ex,Gx */
         nextop = F8;
@@ -2338,26 +2289,19 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<16; ++i) {
-            tmp16s = (int16_t)GX->ub[i] - EX->ub[i];
-            GX->ub[i] = (tmp16s<0)?0:tmp16s;
-        }
+        simd_psubusb(GX, GX, EX);
         break;
     case 0xD9:  /* PSUBUSW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i) {
-            tmp32s = (int32_t)GX->uw[i] - EX->uw[i];
-            GX->uw[i] = (tmp32s<0)?0:tmp32s;
-        }
+        simd_psubusw(GX, GX, EX);
         break;
     case 0xDA:  /* PMINUB Gx, Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<16; ++i)
-            if(EX->ub[i]<GX->ub[i]) GX->ub[i] = EX->ub[i];
+        simd_pminub(GX, GX, EX);
         break;
     case 0xDB:  /* PAND Gx,Ex */
         nextop = F8;
@@ -2370,26 +2314,19 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<16; ++i) {
-            tmp16s = (int16_t)GX->ub[i] + EX->ub[i];
-            GX->ub[i] = (tmp16s>255)?255:tmp16s;
-        }
+        simd_paddusb(GX, GX, EX);
         break;
     case 0xDD:  /* PADDUSW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i) {
-            tmp32s = (int32_t)GX->uw[i] + EX->uw[i];
-            GX->uw[i] = (tmp32s>65535)?65535:tmp32s;
-        }
+        simd_paddusw(GX, GX, EX);
         break;
     case 0xDE:  /* PMAXUB Gx, Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<16; ++i)
-            if(EX->ub[i]>GX->ub[i]) GX->ub[i] = EX->ub[i];
+        simd_pmaxub(GX, GX, EX);
         break;
     case 0xDF:  /* PANDN Gx,Ex */
         nextop = F8;
@@ -2402,49 +2339,37 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<16; ++i)
-            GX->ub[i] = ((uint16_t)GX->ub[i] + EX->ub[i] + 1)>>1;
+        simd_pavgb(GX, GX, EX);
         break;
     case 0xE1:  /* PSRAW Gx, Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        tmp8u=(EX->q[0]>15)?15:EX->ub[0];
-        for (int i=0; i<8; ++i)
-            GX->sw[i] >>= tmp8u;
+        simd_psraw(GX, GX, EX->q[0]);
         break;
     case 0xE2:  /* PSRAD Gx, Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        tmp8u=(EX->q[0]>31)?31:EX->ub[0];
-        for (int i=0; i<4; ++i)
-            GX->sd[i] >>= tmp8u;
+        simd_psrad(GX, GX, EX->q[0]);
         break;
     case 0xE3:  /* PAVGW Gx, Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<8; ++i)
-            GX->uw[i] = ((uint32_t)GX->uw[i] + EX->uw[i] + 1)>>1;
+        simd_pavgw(GX, GX, EX);
         break;
     case 0xE4:  /* PMULHUW Gx, Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i) {
-            tmp32u = (uint32_t)GX->uw[i] * EX->uw[i];
-            GX->uw[i] = (tmp32u>>16)&0xffff;
-        }
+        simd_pmulhuw(GX, GX, EX);
         break;
     case 0xE5:  /* PMULHW Gx, Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i) {
-            tmp32s = (int32_t)GX->sw[i] * EX->sw[i];
-            GX->uw[i] = (tmp32s>>16)&0xffff;
-        }
+        simd_pmulhw(GX, GX, EX);
         break;
     case 0xE6:  /* CVTTPD2DQ Gx, Ex */
         nextop = F8;
@@ -2473,26 +2398,19 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<16; ++i) {
-            tmp16s = (int16_t)GX->sb[i] - EX->sb[i];
-            GX->sb[i] = (tmp16s<-128)?-128:((tmp16s>127)?127:tmp16s);
-        }
+        simd_psubsb(GX, GX, EX);
         break;
     case 0xE9:  /* PSUBSW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i) {
-            tmp32s = (int32_t)GX->sw[i] - EX->sw[i];
-            GX->sw[i] = (tmp32s>32767)?32767:((tmp32s<-32768)?-32768:tmp32s);
-        }
+        simd_psubsw(GX, GX, EX);
         break;
     case 0xEA:  /* PMINSW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<8; ++i)
-            GX->sw[i] = (GX->sw[i]<EX->sw[i])?GX->sw[i]:EX->sw[i];
+        simd_pminsw(GX, GX, EX);
         break;
     case 0xEB:  /* POR Gx,Ex */
         nextop = F8;
@@ -2505,26 +2423,19 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<16; ++i) {
-            tmp16s = (int16_t)GX->sb[i] + EX->sb[i];
-            GX->sb[i] = (tmp16s>127)?127:((tmp16s<-128)?-128:tmp16s);
-        }
+        simd_paddsb(GX, GX, EX);
         break;
     case 0xED:  /* PADDSW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i) {
-            tmp32s = (int32_t)GX->sw[i] + EX->sw[i];
-            GX->sw[i] = (tmp32s>32767)?32767:((tmp32s<-32768)?-32768:tmp32s);
-        }
+        simd_paddsw(GX, GX, EX);
         break;
     case 0xEE:  /* PMAXSW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i)
-            GX->sw[i] = (GX->sw[i]>EX->sw[i])?GX->sw[i]:EX->sw[i];
+        simd_pmaxsw(GX, GX, EX);
         break;
     case 0xEF:                      /* PXOR Gx,Ex */
         nextop = F8;
@@ -2538,42 +2449,31 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        if(EX->q[0]>15)
-            {GX->q[0] = GX->q[1] = 0;}
-        else
-            {tmp8u=EX->ub[0]; for (int i=0; i<8; ++i) GX->uw[i] <<= tmp8u;}
+        simd_psllw(GX, GX, EX->q[0]);
         break;
     case 0xF2:  /* PSLLD Gx, Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        if(EX->q[0]>31)
-            {GX->q[0] = GX->q[1] = 0;}
-        else
-            {tmp8u=EX->ub[0]; for (int i=0; i<4; ++i) GX->ud[i] <<= tmp8u;}
+        simd_pslld(GX, GX, EX->q[0]);
         break;
     case 0xF3:  /* PSLLQ Gx, Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        if(EX->q[0]>63)
-            {GX->q[0] = GX->q[1] = 0;}
-        else
-            {tmp8u=EX->ub[0]; for (int i=0; i<2; ++i) GX->q[i] <<= tmp8u;}
+        simd_psllq(GX, GX, EX->q[0]);
         break;
     case 0xF4:  /* PMULUDQ Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        GX->q[1] = (uint64_t)EX->ud[2]*GX->ud[2];
-        GX->q[0] = (uint64_t)EX->ud[0]*GX->ud[0];
+        simd_pmuludq(GX, GX, EX);
         break;
     case 0xF5:  /* PMADDWD Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for (int i=0; i<4; ++i)
-            GX->sd[i] = (int32_t)(GX->sw[i*2+0])*EX->sw[i*2+0] + (int32_t)(GX->sw[i*2+1])*EX->sw[i*2+1];
+        simd_pmaddwd(GX, GX, EX);
         break;
     case 0xF6:  /* PSADBW Gx, Ex */
         nextop = F8;
@@ -2602,54 +2502,43 @@ uintptr_t Run660F(x64emu_t *emu, rex_t rex, uintptr_t addr)
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<16; ++i)
-            GX->sb[i] -= EX->sb[i];
+        simd_psubb(GX, GX, EX);
         break;
     case 0xF9:  /* PSUBW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i)
-            GX->sw[i] -= EX->sw[i];
+        simd_psubw(GX, GX, EX);
         break;
     case 0xFA:  /* PSUBD Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        GX->sd[0] -= EX->sd[0];
-        GX->sd[1] -= EX->sd[1];
-        GX->sd[2] -= EX->sd[2];
-        GX->sd[3] -= EX->sd[3];
+        simd_psubd(GX, GX, EX);
         break;
     case 0xFB:  /* PSUBQ Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        GX->sq[0] -= EX->sq[0];
-        GX->sq[1] -= EX->sq[1];
+        simd_psubq(GX, GX, EX);
         break;
     case 0xFC:  /* PADDB Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<16; ++i)
-            GX->sb[i] += EX->sb[i];
+        simd_paddb(GX, GX, EX);
         break;
     case 0xFD:  /* PADDW Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        for(int i=0; i<8; ++i)
-            GX->sw[i] += EX->sw[i];
+        simd_paddw(GX, GX, EX);
         break;
     case 0xFE:  /* PADDD Gx,Ex */
         nextop = F8;
         GETEX(0);
         GETGX;
-        GX->sd[0] += EX->sd[0];
-        GX->sd[1] += EX->sd[1];
-        GX->sd[2] += EX->sd[2];
-        GX->sd[3] += EX->sd[3];
+        simd_paddd(GX, GX, EX);
         break;
 
     default:
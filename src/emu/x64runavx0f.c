@@ -29,6 +29,7 @@
 #endif
 
 #include "modrm.h"
+#include "x64simd.h"
 
 #ifdef TEST_INTERPRETER
 uintptr_t TestAVX_0F(x64test_t *test, vex_t vex, uintptr_t addr, int *step)
@@ -393,31 +394,11 @@ uintptr_t RunAVX_0F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<4; ++i) {
-                if (isnan(VX->f[i]) || isnan(EX->f[i])) {
-                    if (isnan(VX->f[i]))
-                        GX->f[i] = VX->f[i];
-                    else
-                        GX->f[i] = EX->f[i];
-                    continue;
-                }
-                GX->f[i] = VX->f[i] + EX->f[i];
-                if(isnan(GX->f[i])) GX->f[i] = -NAN;
-            }
+            simd_addps(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<4; ++i) {
-                    if (isnan(VY->f[i]) || isnan(EY->f[i])) {
-                        if (isnan(VY->f[i]))
-                            GY->f[i] = VY->f[i];
-                        else
-                            GY->f[i] = EY->f[i];
-                        continue;
-                    }
-                    GY->f[i] = VY->f[i] + EY->f[i];
-                    if(isnan(GY->f[i])) GY->f[i] = -NAN;
-                }
+                simd_addps(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -427,31 +408,11 @@ uintptr_t RunAVX_0F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<4; ++i) {
-                if (isnan(VX->f[i]) || isnan(EX->f[i])) {
-                    if (isnan(VX->f[i]))
-                        GX->f[i] = VX->f[i];
-                    else
-                        GX->f[i] = EX->f[i];
-                    continue;
-                }
-                GX->f[i] = VX->f[i] * EX->f[i];
-                if (isnan(GX->f[i])) GX->ud[i] |= 0x80000000;
-            }
+            simd_mulps(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<4; ++i) {
-                    if (isnan(VY->f[i]) || isnan(EY->f[i])) {
-                        if (isnan(VY->f[i]))
-                            GY->f[i] = VY->f[i];
-                        else
-                            GY->f[i] = EY->f[i];
-                        continue;
-                    }
-                    GY->f[i] = VY->f[i] * EY->f[i];
-                    if (isnan(GY->f[i])) GY->ud[i] |= 0x80000000;
-                }
+                simd_mulps(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -493,31 +454,11 @@ uintptr_t RunAVX_0F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<4; ++i) {
-                if (isnan(VX->f[i]) || isnan(EX->f[i])) {
-                    if (isnan(VX->f[i]))
-                        GX->f[i] = VX->f[i];
-                    else
-                        GX->f[i] = EX->f[i];
-                    continue;
-                }
-                GX->f[i] = VX->f[i] - EX->f[i];
-                if (isnan(GX->f[i])) GX->ud[i] |= 0x80000000;
-            }
+            simd_subps(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<4; ++i) {
-                    if (isnan(VY->f[i]) || isnan(EY->f[i])) {
-                        if (isnan(VY->f[i]))
-                            GY->f[i] = VY->f[i];
-                        else
-                            GY->f[i] = EY->f[i];
-                        continue;
-                    }
-                    GY->f[i] = VY->f[i] - EY->f[i];
-                    if (isnan(GY->f[i])) GY->ud[i] |= 0x80000000;
-                }
+                simd_subps(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -549,31 +490,11 @@ uintptr_t RunAVX_0F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<4; ++i) {
-                if (isnan(VX->f[i]) || isnan(EX->f[i])) {
-                    if (isnan(VX->f[i]))
-                        GX->f[i] = VX->f[i];
-                    else
-                        GX->f[i] = EX->f[i];
-                    continue;
-                }
-                GX->f[i] = VX->f[i] / EX->f[i];
-                if (isnan(GX->f[i])) GX->ud[i] |= 0x80000000;
-            }
+            simd_divps(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<4; ++i) {
-                    if (isnan(VY->f[i]) || isnan(EY->f[i])) {
-                        if (isnan(VY->f[i]))
-                            GY->f[i] = VY->f[i];
-                        else
-                            GY->f[i] = EY->f[i];
-                        continue;
-                    }
-                    GY->f[i] = VY->f[i] / EY->f[i];
-                    if (isnan(GY->f[i])) GY->ud[i] |= 0x80000000;
-                }
+                simd_divps(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -29,6 +29,7 @@
 #endif
 
 #include "modrm.h"
+#include "x64simd.h"
 
 #ifdef TEST_INTERPRETER
 uintptr_t TestAVX_660F(x64test_t *test, vex_t vex, uintptr_t addr, int *step)
@@ -319,23 +320,14 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETEX(0);
             GETGX;
             GETVX;
-            MARK_NAN_VD_2(VX, EX);
-            for(int i=0; i<2; ++i) {
-                GX->d[i] = VX->d[i] + EX->d[i];
-            }
-            CHECK_NAN_VD(GX);
             GETGY;
+            simd_addpd(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                MARK_NAN_VD_2(VY, EY);
-                for(int i=0; i<2; ++i) {
-                    GY->d[i] = VY->d[i] + EY->d[i];
-                }
-                CHECK_NAN_VD(GY);
-            } else {
+                simd_addpd(GY, VY, EY);
+            } else
                 GY->u128 = 0;
-            }
             break;
         case 0x59:  /* MULPD Gx, Vx, Ex */
             nextop = F8;
@@ -343,19 +335,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            MARK_NAN_VD_2(VX, EX);
-            for(int i=0; i<2; ++i) {
-                GX->d[i] = VX->d[i] * EX->d[i];
-            }
-            CHECK_NAN_VD(GX);
+            simd_mulpd(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                MARK_NAN_VD_2(VY, EY);
-                for(int i=0; i<2; ++i) {
-                    GY->d[i] = VY->d[i] * EY->d[i];
-                }
-                CHECK_NAN_VD(GY);
+                simd_mulpd(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -445,21 +429,14 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETEX(0);
             GETGX;
             GETVX;
-            MARK_NAN_VD_2(VX, EX);
-            GX->d[0] = VX->d[0] - EX->d[0];
-            GX->d[1] = VX->d[1] - EX->d[1];
-            CHECK_NAN_VD(GX);
             GETGY;
+            simd_subpd(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                MARK_NAN_VD_2(VY, EY);
-                GY->d[0] = VY->d[0] - EY->d[0];
-                GY->d[1] = VY->d[1] - EY->d[1];
-                CHECK_NAN_VD(GY);
-            } else {
+                simd_subpd(GY, VY, EY);
+            } else
                 GY->u128 = 0;
-            }
             break;
         case 0x5D:                      /* VMINPD Gx, Vx, Ex */
             nextop = F8;
@@ -489,19 +466,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            MARK_NAN_VD_2(VX, EX);
-            for (int i=0; i<2; ++i) {
-                GX->d[i] = VX->d[i] / EX->d[i];
-            }
-            CHECK_NAN_VD(GX);
+            simd_divpd(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                MARK_NAN_VD_2(VY, EY);
-                for (int i=0; i<2; ++i) {
-                    GY->d[i] = VY->d[i] / EY->d[i];
-                }
-                CHECK_NAN_VD(GY);
+                simd_divpd(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -625,13 +594,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<16; ++i)
-                GX->ub[i] = (VX->sb[i]>EX->sb[i])?0xFF:0x00;
+            simd_pcmpgtb(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<16; ++i)
-                    GY->ub[i] = (VY->sb[i]>EY->sb[i])?0xFF:0x00;
+                simd_pcmpgtb(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -641,13 +608,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<8; ++i)
-                GX->uw[i] = (VX->sw[i]>EX->sw[i])?0xFFFF:0x0000;
+            simd_pcmpgtw(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<8; ++i)
-                    GY->uw[i] = (VY->sw[i]>EY->sw[i])?0xFFFF:0x0000;
+                simd_pcmpgtw(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -657,13 +622,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<4; ++i)
-                GX->ud[i] = (VX->sd[i]>EX->sd[i])?0xFFFFFFFF:0x00000000;
+            simd_pcmpgtd(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<4; ++i)
-                    GY->ud[i] = (VY->sd[i]>EY->sd[i])?0xFFFFFFFF:0x00000000;
+                simd_pcmpgtd(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -880,35 +843,26 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             switch((nextop>>3)&7) {
                 case 2:                 /* VPSRLW Vx, Ex, Ib */
                     tmp8u = F8;
-                    if(tmp8u>15) VX->u128 = 0;
-                    else
-                        for (int i=0; i<8; ++i) VX->uw[i] = EX->uw[i] >> tmp8u;
+                    simd_psrlw(VX, EX, tmp8u);
                     if(vex.l) {
                         GETEY;
-                        if(tmp8u>15) VY->u128 = 0;
-                        else
-                            for (int i=0; i<8; ++i) VY->uw[i] = EY->uw[i] >> tmp8u;
+                        simd_psrlw(VY, EY, tmp8u);
                     }
                     break;
                 case 4:                 /* VPSRAW Vx, Ex, Ib */
                     tmp8u = F8;
-                    if(tmp8u>15) tmp8u=15;
-                    for (int i=0; i<8; ++i) VX->sw[i] = EX->sw[i] >> tmp8u;
+                    simd_psraw(VX, EX, tmp8u);
                     if(vex.l) {
                         GETEY;
-                        for (int i=0; i<8; ++i) VY->sw[i] = EY->sw[i] >> tmp8u;
+                        simd_psraw(VY, EY, tmp8u);
                     }
                     break;
                 case 6:                 /* VPSLLW Vx, Ex, Ib */
                     tmp8u = F8;
-                    if(tmp8u>15) VX->u128 = 0;
-                    else
-                        for (int i=0; i<8; ++i) VX->uw[i] = EX->uw[i] << tmp8u;
+                    simd_psllw(VX, EX, tmp8u);
                     if(vex.l) {
                         GETEY;
-                        if(tmp8u>15) VY->u128 = 0;
-                        else
-                            for (int i=0; i<8; ++i) VY->uw[i] = EY->uw[i] << tmp8u;
+                        simd_psllw(VY, EY, tmp8u);
                     }
                     break;
                 default:
@@ -924,35 +878,26 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             switch((nextop>>3)&7) {
                 case 2:                 /* VPSRLD Vx, Ex, Ib */
                     tmp8u = F8;
-                    if(tmp8u>31) VX->u128 = 0;
-                    else
-                        for (int i=0; i<4; ++i) VX->ud[i] = EX->ud[i] >> tmp8u;
+                    simd_psrld(VX, EX, tmp8u);
                     if(vex.l) {
                         GETEY;
-                        if(tmp8u>31) VY->u128 = 0;
-                        else
-                            for (int i=0; i<4; ++i) VY->ud[i] = EY->ud[i] >> tmp8u;
+                        simd_psrld(VY, EY, tmp8u);
                     }
                     break;
                 case 4:                 /* VPSRAD Vx, Ex, Ib */
                     tmp8u = F8;
-                    if(tmp8u>31) tmp8u=31;
-                    for (int i=0; i<4; ++i) VX->sd[i] = EX->sd[i] >> tmp8u;
+                    simd_psrad(VX, EX, tmp8u);
                     if(vex.l) {
                         GETEY;
-                        for (int i=0; i<4; ++i) VY->sd[i] = EY->sd[i] >> tmp8u;
+                        simd_psrad(VY, EY, tmp8u);
                     }
                     break;
                 case 6:                 /* VPSLLD Vx, Ex, Ib */
                     tmp8u = F8;
-                    if(tmp8u>31) VX->u128 = 0;
-                    else
-                        for (int i=0; i<4; ++i) VX->ud[i] = EX->ud[i] << tmp8u;
+                    simd_pslld(VX, EX, tmp8u);
                     if(vex.l) {
                         GETEY;
-                        if(tmp8u>31) VY->u128 = 0;
-                        else
-                            for (int i=0; i<4; ++i) VY->ud[i] = EY->ud[i] << tmp8u;
+                        simd_pslld(VY, EY, tmp8u);
                     }
                     break;
                 default:
@@ -968,14 +913,10 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             switch((nextop>>3)&7) {
                 case 2:                 /* VPSRLQ Vx, Ex, Ib */
                     tmp8u = F8;
-                    if(tmp8u>63) VX->u128 = 0;
-                    else
-                        {VX->q[0] = EX->q[0] >> tmp8u; VX->q[1] = EX->q[1] >> tmp8u;}
+                    simd_psrlq(VX, EX, tmp8u);
                     if(vex.l) {
                         GETEY;
-                        if(tmp8u>63) VY->u128 = 0;
-                        else
-                            {VY->q[0] = EY->q[0] >> tmp8u; VY->q[1] = EY->q[1] >> tmp8u;}
+                        simd_psrlq(VY, EY, tmp8u);
                     }
                     break;
                 case 3:                 /* VPSRLDQ Vx, Ex, Ib */
@@ -996,14 +937,10 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
                     break;
                 case 6:                 /* VPSLLQ Vx, Ex, Ib */
                     tmp8u = F8;
-                    if(tmp8u>63) VX->u128 = 0;
-                    else
-                        {VX->q[0] = EX->q[0] << tmp8u; VX->q[1] = EX->q[1] << tmp8u;}
+                    simd_psllq(VX, EX, tmp8u);
                     if(vex.l) {
                         GETEY;
-                        if(tmp8u>63) VY->u128 = 0;
-                        else
-                            {VY->q[0] = EY->q[0] << tmp8u; VY->q[1] = EY->q[1] << tmp8u;}
+                        simd_psllq(VY, EY, tmp8u);
                     }
                     break;
                 case 7:                 /* VPSLLDQ Vx, Ex, Ib */
@@ -1032,13 +969,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for (int i=0; i<16; ++i)
-                GX->ub[i] = (VX->ub[i]==EX->ub[i])?0xff:0;
+            simd_pcmpeqb(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for (int i=0; i<16; ++i)
-                    GY->ub[i] = (VY->ub[i]==EY->ub[i])?0xff:0;
+                simd_pcmpeqb(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1048,13 +983,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for (int i=0; i<8; ++i)
-                GX->uw[i] = (VX->uw[i]==EX->uw[i])?0xffff:0;
+            simd_pcmpeqw(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for (int i=0; i<8; ++i)
-                    GY->uw[i] = (VY->uw[i]==EY->uw[i])?0xffff:0;
+                simd_pcmpeqw(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1064,13 +997,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for (int i=0; i<4; ++i)
-                GX->ud[i] = (VX->ud[i]==EX->ud[i])?0xffffffff:0;
+            simd_pcmpeqd(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for (int i=0; i<4; ++i)
-                    GY->ud[i] = (VY->ud[i]==EY->ud[i])?0xffffffff:0;
+                simd_pcmpeqd(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1315,16 +1246,13 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             nextop = F8;
             GETEX(0);
             GETGX;
-            GETVX; GETGY;
+            GETVX;
+            GETGY;
             tmp64u = EX->q[0];
-            if(tmp64u>15) GX->u128 = 0;
-            else
-                {tmp8u=tmp64u; for (int i=0; i<8; ++i) GX->uw[i] = VX->uw[i] >> tmp8u;}
+            simd_psrlw(GX, VX, tmp64u);
             if(vex.l) {
                 GETVY;
-                if(tmp64u>15) GY->u128 = 0;
-                else
-                    {tmp8u=tmp64u; for (int i=0; i<8; ++i) GY->uw[i] = VY->uw[i] >> tmp8u;}
+                simd_psrlw(GY, VY, tmp64u);
             } else
                 GY->u128 = 0;
             break;
@@ -1332,16 +1260,13 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             nextop = F8;
             GETEX(0);
             GETGX;
-            GETVX; GETGY;
+            GETVX;
+            GETGY;
             tmp64u = EX->q[0];
-            if(tmp64u>31) GX->u128 = 0;
-            else
-                {tmp8u=tmp64u; for (int i=0; i<4; ++i) GX->ud[i] = VX->ud[i] >> tmp8u;}
+            simd_psrld(GX, VX, tmp64u);
             if(vex.l) {
                 GETVY;
-                if(tmp64u>31) GY->u128 = 0;
-                else
-                    {tmp8u=tmp64u; for (int i=0; i<4; ++i) GY->ud[i] = VY->ud[i] >> tmp8u;}
+                simd_psrld(GY, VY, tmp64u);
             } else
                 GY->u128 = 0;
             break;
@@ -1349,16 +1274,13 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             nextop = F8;
             GETEX(0);
             GETGX;
-            GETVX; GETGY;
+            GETVX;
+            GETGY;
             tmp64u = EX->q[0];
-            if(tmp64u>63) GX->u128 = 0;
-            else
-                {tmp8u=tmp64u; for (int i=0; i<2; ++i) GX->q[i] = VX->q[i] >> tmp8u;}
+            simd_psrlq(GX, VX, tmp64u);
             if(vex.l) {
                 GETVY;
-                if(tmp64u>63) GY->u128 = 0;
-                else
-                    {tmp8u=tmp64u; for (int i=0; i<2; ++i) GY->q[i] = VY->q[i] >> tmp8u;}
+                simd_psrlq(GY, VY, tmp64u);
             } else
                 GY->u128 = 0;
             break;
@@ -1368,30 +1290,25 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<2; ++i)
-                GX->sq[i] = VX->sq[i] + EX->sq[i];
+            simd_paddq(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<2; ++i)
-                    GY->sq[i] = VY->sq[i] + EY->sq[i];
+                simd_paddq(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
         case 0xD5:  /* VPMULLW Gx, Vx, Ex */
             nextop = F8;
             GETEX(0);
-            GETGX; GETVX; GETGY;
-            for(int i=0; i<8; ++i) {
-                tmp32s = (int32_t)VX->sw[i] * EX->sw[i];
-                GX->sw[i] = tmp32s&0xffff;
-            }
+            GETGX;
+            GETVX;
+            GETGY;
+            simd_pmullw(GX, VX, EX);
             if(vex.l) {
-                GETEY; GETVY;
-                for(int i=0; i<8; ++i) {
-                    tmp32s = (int32_t)VY->sw[i] * EY->sw[i];
-                    GY->sw[i] = tmp32s&0xffff;
-                }
+                GETEY;
+                GETVY;
+                simd_pmullw(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1430,17 +1347,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<16; ++i) {
-                tmp16s = (int16_t)VX->ub[i] - EX->ub[i];
-                GX->ub[i] = (tmp16s>255)?255:((tmp16s<0)?0:tmp16s);
-            }
+            simd_psubusb(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<16; ++i) {
-                    tmp16s = (int16_t)VY->ub[i] - EY->ub[i];
-                    GY->ub[i] = (tmp16s>255)?255:((tmp16s<0)?0:tmp16s);
-                }
+                simd_psubusb(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1450,17 +1361,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<8; ++i) {
-                tmp32s = (int32_t)VX->uw[i] - EX->uw[i];
-                GX->uw[i] = (tmp32s>65535)?65535:((tmp32s<0)?0:tmp32s);
-            }
+            simd_psubusw(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<8; ++i) {
-                    tmp32s = (int32_t)VY->uw[i] - EY->uw[i];
-                    GY->uw[i] = (tmp32s>65535)?65535:((tmp32s<0)?0:tmp32s);
-                }
+                simd_psubusw(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1470,12 +1375,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for (int i=0; i<16; ++i)
-                GX->ub[i] = (EX->ub[i]<VX->ub[i])?EX->ub[i]:VX->ub[i];
+            simd_pminub(GX, VX, EX);
             if(vex.l) {
-                GETEY; GETVY;
-                for (int i=0; i<16; ++i)
-                    GY->ub[i] = (EY->ub[i]<VY->ub[i])?EY->ub[i]:VY->ub[i];
+                GETEY;
+                GETVY;
+                simd_pminub(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1502,17 +1406,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<16; ++i) {
-                tmp16s = (int16_t)VX->ub[i] + EX->ub[i];
-                GX->ub[i] = (tmp16s>255)?255:tmp16s;
-            }
+            simd_paddusb(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<16; ++i) {
-                    tmp16s = (int16_t)VY->ub[i] + EY->ub[i];
-                    GY->ub[i] = (tmp16s>255)?255:tmp16s;
-                }
+                simd_paddusb(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1522,17 +1420,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<8; ++i) {
-                tmp32s = (int32_t)VX->uw[i] + EX->uw[i];
-                GX->uw[i] = (tmp32s>65535)?65535:tmp32s;
-            }
+            simd_paddusw(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<8; ++i) {
-                    tmp32s = (int32_t)VY->uw[i] + EY->uw[i];
-                    GY->uw[i] = (tmp32s>65535)?65535:tmp32s;
-                }
+                simd_paddusw(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1542,12 +1434,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for (int i=0; i<16; ++i)
-                GX->ub[i] = (EX->ub[i]>VX->ub[i])?EX->ub[i]:VX->ub[i];
+            simd_pmaxub(GX, VX, EX);
             if(vex.l) {
-                GETEY; GETVY;
-                for (int i=0; i<16; ++i)
-                    GY->ub[i] = (EY->ub[i]>VY->ub[i])?EY->ub[i]:VY->ub[i];
+                GETEY;
+                GETVY;
+                simd_pmaxub(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1573,28 +1464,25 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for (int i=0; i<16; ++i)
-                GX->ub[i] = ((uint16_t)VX->ub[i] + EX->ub[i] + 1)>>1;
+            simd_pavgb(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for (int i=0; i<16; ++i)
-                    GY->ub[i] = ((uint16_t)VY->ub[i] + EY->ub[i] + 1)>>1;
-            } else 
+                simd_pavgb(GY, VY, EY);
+            } else
                 GY->u128 = 0;
             break;
         case 0xE1:  /* VPSRAW Gx, Vx, Ex */
             nextop = F8;
             GETEX(0);
             GETGX;
-            GETVX; GETGY;
-            tmp8u=(EX->q[0]>15)?15:EX->ub[0];
-            for (int i=0; i<8; ++i)
-                GX->sw[i] = VX->sw[i] >> tmp8u;
+            GETVX;
+            GETGY;
+            tmp64u = EX->q[0];
+            simd_psraw(GX, VX, tmp64u);
             if(vex.l) {
                 GETVY;
-                for (int i=0; i<8; ++i)
-                    GY->sw[i] = VY->sw[i] >> tmp8u;
+                simd_psraw(GY, VY, tmp64u);
             } else
                 GY->u128 = 0;
             break;
@@ -1602,14 +1490,13 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             nextop = F8;
             GETEX(0);
             GETGX;
-            GETVX; GETGY;
-            tmp8u=(EX->q[0]>31)?31:EX->ub[0];
-            for (int i=0; i<4; ++i)
-                GX->sd[i] = VX->sd[i] >> tmp8u;
+            GETVX;
+            GETGY;
+            tmp64u = EX->q[0];
+            simd_psrad(GX, VX, tmp64u);
             if(vex.l) {
-                GETEY; GETVY;
-                for (int i=0; i<4; ++i)
-                    GY->sd[i] = VY->sd[i] >> tmp8u;
+                GETVY;
+                simd_psrad(GY, VY, tmp64u);
             } else
                 GY->u128 = 0;
             break;
@@ -1619,47 +1506,39 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for (int i=0; i<8; ++i)
-                GX->uw[i] = ((uint32_t)VX->uw[i] + EX->uw[i] + 1)>>1;
+            simd_pavgw(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for (int i=0; i<8; ++i)
-                    GY->uw[i] = ((uint32_t)VY->uw[i] + EY->uw[i] + 1)>>1;
+                simd_pavgw(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
         case 0xE4:  /* VPMULHUW Gx, Vx, Ex */
             nextop = F8;
             GETEX(0);
-            GETGX; GETVX; GETGY;
-            for(int i=0; i<8; ++i) {
-                tmp32u = (uint32_t)VX->uw[i] * EX->uw[i];
-                GX->uw[i] = (tmp32u>>16)&0xffff;
-            }
+            GETGX;
+            GETVX;
+            GETGY;
+            simd_pmulhuw(GX, VX, EX);
             if(vex.l) {
-                GETEY; GETVY;
-                for(int i=0; i<8; ++i) {
-                    tmp32u = (uint32_t)VY->uw[i] * EY->uw[i];
-                    GY->uw[i] = (tmp32u>>16)&0xffff;
-                }
+                GETEY;
+                GETVY;
+                simd_pmulhuw(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
         case 0xE5:  /* VPMULHW Gx, Vx, Ex */
             nextop = F8;
             GETEX(0);
-            GETGX; GETVX, GETGY;
-            for(int i=0; i<8; ++i) {
-                tmp32s = (int32_t)VX->sw[i] * EX->sw[i];
-                GX->uw[i] = (tmp32s>>16)&0xffff;
-            }
+            GETGX;
+            GETVX;
+            GETGY;
+            simd_pmulhw(GX, VX, EX);
             if(vex.l) {
-                GETEY; GETVY;
-                for(int i=0; i<8; ++i) {
-                    tmp32s = (int32_t)VY->sw[i] * EY->sw[i];
-                    GY->uw[i] = (tmp32s>>16)&0xffff;
-                }
+                GETEY;
+                GETVY;
+                simd_pmulhw(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1711,17 +1590,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<16; ++i) {
-                tmp16s = (int16_t)VX->sb[i] - EX->sb[i];
-                GX->sb[i] = (tmp16s>127)?127:((tmp16s<-128)?-128:tmp16s);
-            }
+            simd_psubsb(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<16; ++i) {
-                    tmp16s = (int16_t)VY->sb[i] - EY->sb[i];
-                    GY->sb[i] = (tmp16s>127)?127:((tmp16s<-128)?-128:tmp16s);
-                }
+                simd_psubsb(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1731,17 +1604,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<8; ++i) {
-                tmp32s = (int32_t)VX->sw[i] - EX->sw[i];
-                GX->sw[i] = (tmp32s>32767)?32767:((tmp32s<-32768)?-32768:tmp32s);
-            }
+            simd_psubsw(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<8; ++i) {
-                    tmp32s = (int32_t)VY->sw[i] - EY->sw[i];
-                    GY->sw[i] = (tmp32s>32767)?32767:((tmp32s<-32768)?-32768:tmp32s);
-                }
+                simd_psubsw(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1751,12 +1618,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<8; ++i)
-                GX->sw[i] = (VX->sw[i]<EX->sw[i])?VX->sw[i]:EX->sw[i];
+            simd_pminsw(GX, VX, EX);
             if(vex.l) {
-                GETEY; GETVY;
-                for(int i=0; i<8; ++i)
-                    GY->sw[i] = (VY->sw[i]<EY->sw[i])?VY->sw[i]:EY->sw[i];
+                GETEY;
+                GETVY;
+                simd_pminsw(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1783,17 +1649,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<16; ++i) {
-                tmp16s = (int16_t)VX->sb[i] + EX->sb[i];
-                GX->sb[i] = (tmp16s>127)?127:((tmp16s<-128)?-128:tmp16s);
-            }
+            simd_paddsb(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<16; ++i) {
-                    tmp16s = (int16_t)VY->sb[i] + EY->sb[i];
-                    GY->sb[i] = (tmp16s>127)?127:((tmp16s<-128)?-128:tmp16s);
-                }
+                simd_paddsb(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1803,17 +1663,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<8; ++i) {
-                tmp32s = (int32_t)VX->sw[i] + EX->sw[i];
-                GX->sw[i] = (tmp32s>32767)?32767:((tmp32s<-32768)?-32768:tmp32s);
-            }
+            simd_paddsw(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<8; ++i) {
-                    tmp32s = (int32_t)VY->sw[i] + EY->sw[i];
-                    GY->sw[i] = (tmp32s>32767)?32767:((tmp32s<-32768)?-32768:tmp32s);
-                }
+                simd_paddsw(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1823,12 +1677,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<8; ++i)
-                GX->sw[i] = (VX->sw[i]>EX->sw[i])?VX->sw[i]:EX->sw[i];
+            simd_pmaxsw(GX, VX, EX);
             if(vex.l) {
-                GETEY; GETVY;
-                for(int i=0; i<8; ++i)
-                    GY->sw[i] = (VY->sw[i]>EY->sw[i])?VY->sw[i]:EY->sw[i];
+                GETEY;
+                GETVY;
+                simd_pmaxsw(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1852,64 +1705,56 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
         case 0xF1:  /* VPSLLW Gx, Vx, Ex */
             nextop = F8;
             GETEX(0);
-            GETGX; GETVX; GETGY;
-            if(EX->q[0]>15)
-                GX->u128 = 0;
-            else
-                {tmp8u=EX->ub[0]; for (int i=0; i<8; ++i) GX->uw[i] = VX->uw[i]<<tmp8u;}
+            GETGX;
+            GETVX;
+            GETGY;
+            tmp64u = EX->q[0];
+            simd_psllw(GX, VX, tmp64u);
             if(vex.l) {
                 GETVY;
-                if(EX->q[0]>15)
-                    GY->u128 = 0;
-                else
-                    {for (int i=0; i<8; ++i) GY->uw[i] = VY->uw[i]<<tmp8u;}
+                simd_psllw(GY, VY, tmp64u);
             } else
                 GY->u128 = 0;
             break;
         case 0xF2:  /* VPSLLD Gx, Vx, Ex */
             nextop = F8;
             GETEX(0);
-            GETGX; GETVX; GETGY;
-            if(EX->q[0]>31)
-                GX->u128 = 0;
-            else
-                {tmp8u=EX->ub[0]; for (int i=0; i<4; ++i) GX->ud[i] = VX->ud[i]<<tmp8u;}
+            GETGX;
+            GETVX;
+            GETGY;
+            tmp64u = EX->q[0];
+            simd_pslld(GX, VX, tmp64u);
             if(vex.l) {
                 GETVY;
-                if(EX->q[0]>31)
-                    GY->u128 = 0;
-                else
-                    {for (int i=0; i<4; ++i) GY->ud[i] = VY->ud[i]<<tmp8u;}
+                simd_pslld(GY, VY, tmp64u);
             } else
                 GY->u128 = 0;
             break;
         case 0xF3:  /* VPSLLQ Gx, Vx, Ex */
             nextop = F8;
             GETEX(0);
-            GETGX; GETVX; GETGY;
-            if(EX->q[0]>63)
-                GX->u128 = 0;
-            else
-                {tmp8u=EX->ub[0]; for (int i=0; i<2; ++i) GX->q[i] = VX->q[i]<<tmp8u;}
+            GETGX;
+            GETVX;
+            GETGY;
+            tmp64u = EX->q[0];
+            simd_psllq(GX, VX, tmp64u);
             if(vex.l) {
                 GETVY;
-                if(EX->q[0]>63)
-                    GY->u128 = 0;
-                else
-                    {for (int i=0; i<2; ++i) GY->q[i] = VY->q[i]<<tmp8u;}
+                simd_psllq(GY, VY, tmp64u);
             } else
                 GY->u128 = 0;
             break;
         case 0xF4:  /* VPMULUDQ Gx, Vx, Ex */
             nextop = F8;
             GETEX(0);
-            GETGX; GETVX, GETGY;
-            GX->q[1] = (uint64_t)EX->ud[2]*VX->ud[2];
-            GX->q[0] = (uint64_t)EX->ud[0]*VX->ud[0];
+            GETGX;
+            GETVX;
+            GETGY;
+            simd_pmuludq(GX, VX, EX);
             if(vex.l) {
-                GETEY; GETVY;
-                GY->q[1] = (uint64_t)EY->ud[2]*VY->ud[2];
-                GY->q[0] = (uint64_t)EY->ud[0]*VY->ud[0];
+                GETEY;
+                GETVY;
+                simd_pmuludq(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1919,12 +1764,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for (int i=0; i<4; ++i)
-                GX->sd[i] = (int32_t)(VX->sw[i*2+0])*EX->sw[i*2+0] + (int32_t)(VX->sw[i*2+1])*EX->sw[i*2+1];
+            simd_pmaddwd(GX, VX, EX);
             if(vex.l) {
-                GETEY; GETVY;
-                for (int i=0; i<4; ++i)
-                    GY->sd[i] = (int32_t)(VY->sw[i*2+0])*EY->sw[i*2+0] + (int32_t)(VY->sw[i*2+1])*EY->sw[i*2+1];
+                GETEY;
+                GETVY;
+                simd_pmaddwd(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1973,13 +1817,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<16; ++i)
-                GX->sb[i] = VX->sb[i] - EX->sb[i];
+            simd_psubb(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<16; ++i)
-                    GY->sb[i] = VY->sb[i] - EY->sb[i];
+                simd_psubb(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -1989,13 +1831,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<8; ++i)
-                GX->sw[i] = VX->sw[i] - EX->sw[i];
+            simd_psubw(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<8; ++i)
-                    GY->sw[i] = VY->sw[i] - EY->sw[i];
+                simd_psubw(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -2005,13 +1845,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<4; ++i)
-                GX->sd[i] = VX->sd[i] - EX->sd[i];
+            simd_psubd(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<4; ++i)
-                    GY->sd[i] = VY->sd[i] - EY->sd[i];
+                simd_psubd(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -2021,13 +1859,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<2; ++i)
-                GX->sq[i] = VX->sq[i] - EX->sq[i];
+            simd_psubq(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<2; ++i)
-                    GY->sq[i] = VY->sq[i] - EY->sq[i];
+                simd_psubq(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -2037,13 +1873,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<16; ++i)
-                GX->sb[i] = VX->sb[i] + EX->sb[i];
+            simd_paddb(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<16; ++i)
-                    GY->sb[i] = VY->sb[i] + EY->sb[i];
+                simd_paddb(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -2053,13 +1887,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<8; ++i)
-                GX->sw[i] = VX->sw[i] + EX->sw[i];
+            simd_paddw(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<8; ++i)
-                    GY->sw[i] = VY->sw[i] + EY->sw[i];
+                simd_paddw(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -2069,13 +1901,11 @@ uintptr_t RunAVX_660F(x64emu_t *emu, vex_t vex, uintptr_t addr, int *step)
             GETGX;
             GETVX;
             GETGY;
-            for(int i=0; i<4; ++i)
-                GX->sd[i] = VX->sd[i] + EX->sd[i];
+            simd_paddd(GX, VX, EX);
             if(vex.l) {
                 GETEY;
                 GETVY;
-                for(int i=0; i<4; ++i)
-                    GY->sd[i] = VY->sd[i] + EY->sd[i];
+                simd_paddd(GY, VY, EY);
             } else
                 GY->u128 = 0;
             break;
@@ -0,0 +1,148 @@
+#ifndef __X64SIMD_H__
+#define __X64SIMD_H__
+
+#include <stdint.h>
+#include <string.h>
+
+#include "regs.h"
+
+// Packed operations for the interpreter, using the compiler vector types so they are done by the host SIMD unit
+// (SSE2, NEON, LSX... depending on the build target) instead of lane by lane.
+// All are d = a op b on 128bits, d can be a or b. Registers can be in guest memory, so unaligned: access is done with memcpy.
+
+typedef uint8_t  v16u8 __attribute__((vector_size(16)));
+typedef int8_t   v16s8 __attribute__((vector_size(16)));
+typedef uint16_t v8u16 __attribute__((vector_size(16)));
+typedef int16_t  v8s16 __attribute__((vector_size(16)));
+typedef uint32_t v4u32 __attribute__((vector_size(16)));
+typedef int32_t  v4s32 __attribute__((vector_size(16)));
+typedef uint64_t v2u64 __attribute__((vector_size(16)));
+typedef int64_t  v2s64 __attribute__((vector_size(16)));
+typedef float    v4f32 __attribute__((vector_size(16)));
+typedef double   v2f64 __attribute__((vector_size(16)));
+
+#define SIMD_LD(T, R)   ({ T v_; memcpy(&v_, (R), sizeof(v_)); v_; })
+#define SIMD_ST(R, V)   do { __typeof__(V) v_ = (V); memcpy((R), &v_, sizeof(v_)); } while (0)
+
+#define SIMD_OP(NAME, T, EXPR)                                                              \
+    static inline void simd_##NAME(sse_regs_t* d, const sse_regs_t* pa, const sse_regs_t* pb) \
+    {                                                                                       \
+        T a = SIMD_LD(T, pa);                                                               \
+        T b = SIMD_LD(T, pb);                                                               \
+        SIMD_ST(d, (T)(EXPR));                                                              \
+    }
+
+// signed saturation is done on the wrapped result: overflow if the sign of the result is wrong
+#define SIMD_ADDS(T, U, BITS) ({                        \
+    T r_ = (T)((U)a + (U)b);                            \
+    T o_ = ((a ^ r_) & (b ^ r_)) >> (BITS - 1);         \
+    T s_ = (a >> (BITS - 1)) ^ ((1 << (BITS - 1)) - 1); \
+    (s_ & o_) | (r_ & ~o_); })
+#define SIMD_SUBS(T, U, BITS) ({                        \
+    T r_ = (T)((U)a - (U)b);                            \
+    T o_ = ((a ^ b) & (a ^ r_)) >> (BITS - 1);          \
+    T s_ = (a >> (BITS - 1)) ^ ((1 << (BITS - 1)) - 1); \
+    (s_ & o_) | (r_ & ~o_); })
+#define SIMD_SEL(M, A, B) (((A) & (M)) | ((B) & ~(M)))
+
+SIMD_OP(paddb, v16u8, a + b)
+SIMD_OP(paddw, v8u16, a + b)
+SIMD_OP(paddd, v4u32, a + b)
+SIMD_OP(paddq, v2u64, a + b)
+SIMD_OP(psubb, v16u8, a - b)
+SIMD_OP(psubw, v8u16, a - b)
+SIMD_OP(psubd, v4u32, a - b)
+SIMD_OP(psubq, v2u64, a - b)
+SIMD_OP(paddusb, v16u8, (a + b) | (v16u8)((v16u8)(a + b) < a))
+SIMD_OP(paddusw, v8u16, (a + b) | (v8u16)((v8u16)(a + b) < a))
+SIMD_OP(psubusb, v16u8, (a - b) & (v16u8)(a >= b))
+SIMD_OP(psubusw, v8u16, (a - b) & (v8u16)(a >= b))
+SIMD_OP(paddsb, v16s8, SIMD_ADDS(v16s8, v16u8, 8))
+SIMD_OP(paddsw, v8s16, SIMD_ADDS(v8s16, v8u16, 16))
+SIMD_OP(psubsb, v16s8, SIMD_SUBS(v16s8, v16u8, 8))
+SIMD_OP(psubsw, v8s16, SIMD_SUBS(v8s16, v8u16, 16))
+SIMD_OP(pcmpeqb, v16u8, a == b)
+SIMD_OP(pcmpeqw, v8u16, a == b)
+SIMD_OP(pcmpeqd, v4u32, a == b)
+SIMD_OP(pcmpgtb, v16s8, a > b)
+SIMD_OP(pcmpgtw, v8s16, a > b)
+SIMD_OP(pcmpgtd, v4s32, a > b)
+SIMD_OP(pminub, v16u8, SIMD_SEL((v16u8)(a < b), a, b))
+SIMD_OP(pmaxub, v16u8, SIMD_SEL((v16u8)(a > b), a, b))
+SIMD_OP(pminsw, v8s16, SIMD_SEL(a < b, a, b))
+SIMD_OP(pmaxsw, v8s16, SIMD_SEL(a > b, a, b))
+SIMD_OP(pavgb, v16u8, (a | b) - ((a ^ b) >> 1))
+SIMD_OP(pavgw, v8u16, (a | b) - ((a ^ b) >> 1))
+SIMD_OP(pmullw, v8u16, a * b)
+// high part of 16bits multiplies, done as even and odd lanes of 32bits multiplies
+SIMD_OP(pmulhuw, v4u32, (((a & 0xffff) * (b & 0xffff)) >> 16) | (((a >> 16) * (b >> 16)) & 0xffff0000))
+#define SIMD_LOW16S(A)  ((v4s32)((v4u32)(A) << 16) >> 16)
+static inline void simd_pmulhw(sse_regs_t* d, const sse_regs_t* pa, const sse_regs_t* pb)
+{
+    v4s32 a = SIMD_LD(v4s32, pa);
+    v4s32 b = SIMD_LD(v4s32, pb);
+    v4s32 lo = SIMD_LOW16S(a) * SIMD_LOW16S(b);
+    v4s32 hi = (a >> 16) * (b >> 16);
+    SIMD_ST(d, ((v4u32)lo >> 16) | ((v4u32)hi & 0xffff0000));
+}
+static inline void simd_pmaddwd(sse_regs_t* d, const sse_regs_t* pa, const sse_regs_t* pb)
+{
+    v4s32 a = SIMD_LD(v4s32, pa);
+    v4s32 b = SIMD_LD(v4s32, pb);
+    v4s32 lo = SIMD_LOW16S(a) * SIMD_LOW16S(b);
+    v4s32 hi = (a >> 16) * (b >> 16);
+    SIMD_ST(d, (v4u32)lo + (v4u32)hi); // wraps on 0x8000*0x8000*2, like x86
+}
+SIMD_OP(pmuludq, v2u64, (a & 0xffffffff) * (b & 0xffffffff))
+
+#define SIMD_SHIFT(NAME, T, OP, MAX)                                                  \
+    static inline void simd_##NAME(sse_regs_t* d, const sse_regs_t* pa, uint64_t cnt) \
+    {                                                                                 \
+        if (cnt > MAX) {                                                              \
+            d->q[0] = d->q[1] = 0;                                                    \
+            return;                                                                   \
+        }                                                                             \
+        SIMD_ST(d, SIMD_LD(T, pa) OP (int)cnt);                                       \
+    }
+// arithmetic shifts saturate the count instead of zeroing
+#define SIMD_SHIFTA(NAME, T, MAX)                                                     \
+    static inline void simd_##NAME(sse_regs_t* d, const sse_regs_t* pa, uint64_t cnt) \
+    {                                                                                 \
+        SIMD_ST(d, SIMD_LD(T, pa) >> (int)((cnt > MAX) ? MAX : cnt));                 \
+    }
+
+SIMD_SHIFT(psrlw, v8u16, >>, 15)
+SIMD_SHIFT(psrld, v4u32, >>, 31)
+SIMD_SHIFT(psrlq, v2u64, >>, 63)
+SIMD_SHIFT(psllw, v8u16, <<, 15)
+SIMD_SHIFT(pslld, v4u32, <<, 31)
+SIMD_SHIFT(psllq, v2u64, <<, 63)
+SIMD_SHIFTA(psraw, v8s16, 15)
+SIMD_SHIFTA(psrad, v4s32, 31)
+
+// packed float, with x86 NaN rules whatever the host does: a NaN input gives the 1st NaN operand (quieted),
+// and a NaN generated from non-NaN inputs is the x86 default NaN (negative)
+#define SIMD_FOP(NAME, T, U, OP, SIGN, QUIET)                                                 \
+    static inline void simd_##NAME(sse_regs_t* d, const sse_regs_t* pa, const sse_regs_t* pb) \
+    {                                                                                         \
+        T a = SIMD_LD(T, pa);                                                                 \
+        T b = SIMD_LD(T, pb);                                                                 \
+        U na = (U)(a != a);                                                                   \
+        U nb = (U)(b != b) & ~na;                                                             \
+        T r = a OP b;                                                                         \
+        U nr = (U)(r != r) & ~(na | nb);                                                      \
+        U ret = ((U)r & ~(na | nb)) | (nr & SIGN);                                            \
+        ret |= (((U)a | QUIET) & na) | (((U)b | QUIET) & nb);                                 \
+        SIMD_ST(d, ret);                                                                      \
+    }
+
+SIMD_FOP(addps, v4f32, v4u32, +, 0x80000000, 0x00400000)
+SIMD_FOP(subps, v4f32, v4u32, -, 0x80000000, 0x00400000)
+SIMD_FOP(mulps, v4f32, v4u32, *, 0x80000000, 0x00400000)
+SIMD_FOP(divps, v4f32, v4u32, /, 0x80000000, 0x00400000)
+SIMD_FOP(addpd, v2f64, v2u64, +, 0x8000000000000000ULL, 0x0008000000000000ULL)
+SIMD_FOP(subpd, v2f64, v2u64, -, 0x8000000000000000ULL, 0x0008000000000000ULL)
+SIMD_FOP(mulpd, v2f64, v2u64, *, 0x8000000000000000ULL, 0x0008000000000000ULL)
+SIMD_FOP(divpd, v2f64, v2u64, /, 0x8000000000000000ULL, 0x0008000000000000ULL)
+
+#endif //__X64SIMD_H__
@@ -24,6 +24,8 @@
 
 #include "os.h"
 #include "debug.h"
+#include "stats.h"
+#include "rollinglog.h"
 #include "box64stack.h"
 #include "x64emu.h"
 #include "box64cpu.h"
@@ -38,6 +40,9 @@
 #include "emit_signals.h"
 #include "x64tls.h"
 #include "elfloader.h"
+#ifdef DYNAREC
+#include "dynablock.h"
+#endif
 
 typedef struct x64_sigaction_s x64_sigaction_t;
 typedef struct x64_stack_s x64_stack_t;
@@ -439,10 +444,47 @@ static int clone_fn(void* arg)
     _exit(ret);
 }
 
+// pass-through syscalls that are frequent and have no side effect on the emulator state,
+// so they can be done by the dynarec with the host syscall instruction directly
+static const uint16_t syscalldirect[] = {
+    8,      // lseek
+    17,     // pread64
+    18,     // pwrite64
+    24,     // sched_yield
+    35,     // nanosleep
+    39,     // getpid
+    44,     // sendto
+    45,     // recvfrom
+    46,     // sendmsg
+    47,     // recvmsg
+    186,    // gettid
+    202,    // futex
+    230,    // clock_nanosleep
+    232,    // epoll_wait (only if the struct doesn't need alignment)
+    233,    // epoll_ctl (same)
+    281,    // epoll_pwait (same)
+};
+
+int x64SyscallDirect(uint32_t s, int* nbpars)
+{
+    // wine filters syscalls, and logs / stats need to see each syscall
+    if(box64_wine || BOX64ENV(log)>=LOG_DEBUG || BOX64ENV(rolling_log) || BOX64ENV(stats))
+        return 0;
+    if(s>=sizeof(syscallwrap)/sizeof(scwrap_t) || !syscallwrap[s].nats)
+        return 0;
+    for(int i=0; i<(int)(sizeof(syscalldirect)/sizeof(syscalldirect[0])); ++i)
+        if(syscalldirect[i]==s) {
+            *nbpars = syscallwrap[s].nbpars;
+            return syscallwrap[s].nats;
+        }
+    return 0;
+}
+
 void EXPORT x64Syscall(x64emu_t *emu)
 {
     RESET_FLAGS(emu);
     uint32_t s = R_EAX; // EAX? (syscalls only go up to 547 anyways)
+    StatsSyscall(s, 0);
     // check if it's a wine process, then filter the syscall (simulate SECCMP)
     if(box64_wine && !box64_is32bits) {
         //64bits only here...
@@ -454,20 +496,16 @@ void EXPORT x64Syscall(x64emu_t *emu)
         }
     }
     int log = 0;
-    char t_buff[256] = "\0";
-    char t_buffret[128] = "\0";
+    uint64_t rlog_id = 0;
+    char buff[256] = "\0";
+    char buffret[128] = "\0";
     char buff2[128] = "\0";
-    char* buff = NULL;
-    char* buffret = NULL;
-    if(BOX64ENV(log) >= LOG_DEBUG || BOX64ENV(rolling_log)) {
+    if(BOX64ENV(rolling_log))
+        rlog_id = RollingLogCall(RLOG_SYSCALL, R_RIP, s, NULL, R_RDI, R_RSI, R_RDX, R_R10, R_R8, R_R9);
+    else if(BOX64ENV(log) >= LOG_DEBUG) {
         log = 1;
-        buff = BOX64ENV(rolling_log)?(my_context->log_call+256*my_context->current_line):t_buff;
-        buffret = BOX64ENV(rolling_log)?(my_context->log_ret+128*my_context->current_line):t_buffret;
-        if(BOX64ENV(rolling_log))
-            my_context->current_line = (my_context->current_line+1)%BOX64ENV(rolling_log);
         snprintf(buff, 255, "%04d|%p: Calling syscall 0x%02X (%d) %p %p %p %p %p %p", GetTID(), (void*)R_RIP, s, s, (void*)R_RDI, (void*)R_RSI, (void*)R_RDX, (void*)R_R10, (void*)R_R8, (void*)R_R9);
-        if(!BOX64ENV(rolling_log))
-            printf_log(LOG_NONE, "%s", buff);
+        printf_log(LOG_NONE, "%s", buff);
     }
     // check wrapper first
     uint32_t cnt = sizeof(syscallwrap) / sizeof(scwrap_t);
@@ -488,8 +526,11 @@ void EXPORT x64Syscall(x64emu_t *emu)
         }
         if(S_RAX==-1 && errno>0)
             S_RAX = -errno;
-        if(log) snprintf(buffret, 127, "0x%x%s", R_EAX, buff2);
-        if(log && !BOX64ENV(rolling_log)) printf_log(LOG_NONE, "=> %s\n", buffret);
+        if(rlog_id) RollingLogRet(rlog_id, R_RAX);
+        if(log) {
+            snprintf(buffret, 127, "0x%x%s", R_EAX, buff2);
+            printf_log(LOG_NONE, "=> %s\n", buffret);
+        }
         return;
     }
     switch (s) {
@@ -625,6 +666,10 @@ void EXPORT x64Syscall(x64emu_t *emu)
                     x64emu_t * newemu = NewX64Emu(emu->context, R_RIP, (uintptr_t)stack_base, stack_size, (R_RSI)?0:1);
                     SetupX64Emu(newemu, emu);
                     CloneEmu(newemu, emu);
+                    #ifdef DYNAREC
+                    if(R_EDI&CLONE_VM)
+                        DynablockGoMultithread();
+                    #endif
                     clone_t* args = box_calloc(1, sizeof(clone_t));
                     newemu->regs[_SP].q[0] = sp;  // setup new stack pointer
                     args->emu = newemu;
@@ -881,12 +926,10 @@ void EXPORT x64Syscall(x64emu_t *emu)
             S_RAX = -ENOSYS;
             break;
     }
-    if(log) {
-        if(BOX64ENV(rolling_log))
-            snprintf(buffret, 127, "0x%lx%s", R_RAX, buff2);
-        else
-            printf_log_prefix(0, LOG_NONE, "=> 0x%lx%s\n", R_RAX, buff2);
-    }
+    if(rlog_id)
+        RollingLogRet(rlog_id, R_RAX);
+    if(log)
+        printf_log_prefix(0, LOG_NONE, "=> 0x%lx%s\n", R_RAX, buff2);
 }
 
 #define stack(n) (R_RSP+8+n)
@@ -1012,6 +1055,10 @@ long EXPORT my_syscall(x64emu_t *emu)
                 x64emu_t * newemu = NewX64Emu(emu->context, R_RIP, (uintptr_t)stack_base, stack_size, (R_RDX)?0:1);
                 SetupX64Emu(newemu, emu);
                 CloneEmu(newemu, emu);
+                #ifdef DYNAREC
+                if(R_ESI&CLONE_VM)
+                    DynablockGoMultithread();
+                #endif
                 newemu->regs[_SP].q[0] = sp;  // setup new stack pointer
                 void* mystack = NULL;
                 if(my_context->stack_clone_used) {
@@ -14,6 +14,8 @@
 
 #include "os.h"
 #include "debug.h"
+#include "stats.h"
+#include "rollinglog.h"
 #include "box64stack.h"
 #include "x64emu.h"
 #include "x64emu_private.h"
@@ -60,22 +62,30 @@ void x86Int3(x64emu_t* emu, uintptr_t* addr)
             wrapper_t w = bridge->w;
             a = F64(addr);
             R_RIP = *addr;
+            StatsWrapper(a);
             /* This party can be used to trace only 1 specific lib (but it is quite slow)
             elfheader_t *h = FindElfAddress(my_context, *(uintptr_t*)(R_ESP));
             int have_trace = 0;
             if(h && strstr(ElfName(h), "libMiles")) have_trace = 1;*/
-            if(BOX64ENV(log)>=LOG_DEBUG || BOX64ENV(rolling_log)) {
+            if(BOX64ENV(rolling_log)) {
+                // binary event only, formatted when the log is dumped
+                uint64_t id;
+                if(a==(uintptr_t)PltResolver32) {
+                    ptr_t addr = *((uint32_t*)from_ptrv(R_ESP));
+                    int slot = *((uint32_t*)from_ptrv(R_ESP+4));
+                    elfheader_t *h = (elfheader_t*)from_ptrv(addr);
+                    Elf32_Rel * rel = (Elf32_Rel *)from_ptrv(h->jmprel + h->delta + slot);
+                    Elf32_Sym *sym = &h->DynSym._32[ELF32_R_SYM(rel->r_info)];
+                    id = RollingLogCall(RLOG_PLT32, from_ptri(uint32_t, R_ESP+8), a, SymName32(h, sym), 0, 0, 0, 0, 0, 0);
+                } else
+                    id = RollingLogCall(RLOG_CALL32, from_ptri(uint32_t, R_ESP), a, bridge->name, from_ptri(uint32_t, R_ESP+4), from_ptri(uint32_t, R_ESP+8), from_ptri(uint32_t, R_ESP+12), 0, 0, 0);
+                w(emu, a);
+                RollingLogRet(id, R_EAX);
+            } else if(BOX64ENV(log)>=LOG_DEBUG) {
                 int tid = GetTID();
-                char t_buff[256] = "\0";
+                char buff[256] = "\0";
                 char buff2[64] = "\0";
                 char buff3[64] = "\0";
-                int cycle_line = my_context->current_line;
-                if(BOX64ENV(rolling_log)) {
-                    my_context->current_line = (my_context->current_line+1)%BOX64ENV(rolling_log);
-                }
-                char* buff = BOX64ENV(rolling_log)?(my_context->log_call+256*cycle_line):t_buff;
-                char* buffret = BOX64ENV(rolling_log)?(my_context->log_ret+128*cycle_line):NULL;
-                if(buffret) buffret[0] = '\0';
                 char *tmp;
                 int post = 0;
                 int perr = 0;
@@ -87,17 +97,7 @@ void x86Int3(x64emu_t* emu, uintptr_t* addr)
                 if(!s)
                     s = GetNativeName((void*)a);
                 if(a==(uintptr_t)PltResolver32) {
-                    if(BOX64ENV(rolling_log)) {
-                        ptr_t addr = *((uint32_t*)from_ptrv(R_ESP));
-                        int slot = *((uint32_t*)from_ptrv(R_ESP+4));
-                        elfheader_t *h = (elfheader_t*)from_ptrv(addr);
-                        Elf32_Rel * rel = (Elf32_Rel *)from_ptrv(h->jmprel + h->delta + slot);
-                        Elf32_Sym *sym = &h->DynSym._32[ELF32_R_SYM(rel->r_info)];
-                        const char* symname = SymName32(h, sym);
-                        snprintf(buff, 256, "%04d|PltResolver \"%s\"", tid, symname?symname:"???");
-                    } else {
-                        snprintf(buff, 256, "%s", " ... ");
-                    }
+                    snprintf(buff, 256, "%s", " ... ");
                 } else
                 if(strstr(s, "SDL_PollEvent")==s) {
                     snprintf(buff, 255, "%04d|%p: Calling %s(%p)", tid, from_ptriv(R_ESP), (char *)s, from_ptriv(R_ESP+4));
@@ -403,11 +403,9 @@ void x86Int3(x64emu_t* emu, uintptr_t* addr)
                 } else {
                     snprintf(buff, 255, "%04d|%p: Calling %s (%08X, %08X, %08X...)", tid, from_ptriv(R_ESP), (char *)s, from_ptri(uint32_t, R_ESP+4), from_ptri(uint32_t, R_ESP+8), from_ptri(uint32_t, R_ESP+12));
                 }
-                if(!BOX64ENV(rolling_log)) {
-                    mutex_lock(&emu->context->mutex_trace);
-                    printf_log(LOG_NONE, "%s =>", buff);
-                    mutex_unlock(&emu->context->mutex_trace);
-                }
+                mutex_lock(&emu->context->mutex_trace);
+                printf_log(LOG_NONE, "%s =>", buff);
+                mutex_unlock(&emu->context->mutex_trace);
                 w(emu, a);   // some function never come back, so unlock the mutex first!
                 if(post)
                     switch(post) {
@@ -466,19 +464,12 @@ void x86Int3(x64emu_t* emu, uintptr_t* addr)
                     snprintf(buff3, 63, " (errno=%d:\"%s\")", errno, strerror(errno));
                 else if(perr==3 && (S_EAX)==-1)
                     snprintf(buff3, 63, " (errno=%d:\"%s\")", errno, strerror(errno));
-                if(BOX64ENV(rolling_log)) {
-                    if(ret_fmt==1)
-                        snprintf(buffret, 127, "%d%s%s", S_EAX, buff2, buff3);
-                    else
-                        snprintf(buffret, 127, "0x%X%s%s", R_EAX, buff2, buff3);
-                } else {
-                    mutex_lock(&emu->context->mutex_trace);
-                    if(ret_fmt==1)
-                        printf_log_prefix(0, LOG_NONE, " return %d%s%s\n", S_EAX, buff2, buff3);
-                    else
-                        printf_log_prefix(0, LOG_NONE, " return 0x%X%s%s\n", R_EAX, buff2, buff3);
-                    mutex_unlock(&emu->context->mutex_trace);
-                }
+                mutex_lock(&emu->context->mutex_trace);
+                if(ret_fmt==1)
+                    printf_log_prefix(0, LOG_NONE, " return %d%s%s\n", S_EAX, buff2, buff3);
+                else
+                    printf_log_prefix(0, LOG_NONE, " return 0x%X%s%s\n", R_EAX, buff2, buff3);
+                mutex_unlock(&emu->context->mutex_trace);
             } else
                 w(emu, a);
         }
@@ -26,6 +26,7 @@
 
 #include "os.h"
 #include "debug.h"
+#include "stats.h"
 #include "box64stack.h"
 #include "x64emu.h"
 #include "box64cpu.h"
@@ -296,6 +297,7 @@ static int clone32_fn(void* arg)
 void EXPORT x86Syscall(x64emu_t *emu)
 {
     uint32_t s = R_EAX;
+    StatsSyscall(s, 1);
     printf_log(LOG_DEBUG, "%04d|%p: Calling 32bits syscall 0x%02X (%d) %p %p %p %p %p", GetTID(), (void*)R_RIP, s, s, (void*)(uintptr_t)R_EBX, (void*)(uintptr_t)R_ECX, (void*)(uintptr_t)R_EDX, (void*)(uintptr_t)R_ESI, (void*)(uintptr_t)R_EDI); 
     // check wrapper first
     int cnt = sizeof(syscallwrap) / sizeof(scwrap_t);
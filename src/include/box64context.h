@@ -149,6 +149,7 @@ typedef struct box64context_s {
     uintptr_t           exit_bridge;    // exit bridge value
     uintptr_t           vsyscall;       // vsyscall bridge value
     uintptr_t           vsyscalls[3];   // the 3 x86 VSyscall pseudo bridges (mapped at 0xffffffffff600000+)
+    uintptr_t           vdso;           // emulated vDSO image
     dlprivate_t         *dlprivate;     // dlopen library map
     kh_symbolmap_t      *alwrappers;    // the map of wrapper for alGetProcAddress
     kh_symbolmap_t      *almymap;       // link to the mysymbolmap if libOpenAL
@@ -234,11 +235,6 @@ typedef struct box64context_s {
     void*               stack_clone;
     int                 stack_clone_used;
 
-    // rolling logs
-    char*               log_call;   // is a large string composed of slices of 256 chars
-    char*               log_ret;    // is a large string composed of sloces of 128 chars
-    int                 current_line;
-
 } box64context_t;
 
 #ifndef USE_CUSTOM_MUTEX
@@ -261,9 +257,7 @@ extern box64context_t *my_context; // global context
 box64context_t *NewBox64Context(int argc);
 void FreeBox64Context(box64context_t** context);
 
-// Cycle log handling
-void freeCycleLog(box64context_t* ctx);
-void initCycleLog(box64context_t* context);
+// dump the rolling log (BOX64_ROLLING_LOG), see rollinglog.c
 void print_rolling_log(int loglevel);
 
 // return the index of the added header
@@ -8,5 +8,7 @@ typedef struct x64emu_s x64emu_t;
 
 int CalcStackSize(box64context_t *context);
 void SetupInitialStack(x64emu_t *emu);
+// build the emulated vDSO if needed, return its address (or 0)
+uintptr_t CreateVDSO(box64context_t *context);
 
 #endif //__BOX64_STACK_H_
@@ -34,7 +34,7 @@ typedef struct dynablock_s dynablock_t;
 typedef struct mmaplist_s mmaplist_t;
 typedef struct DynaCacheBlock_s DynaCacheBlock_t;
 // custom protection flag to mark Page that are Write protected for Dynarec purpose
-uintptr_t AllocDynarecMap(uintptr_t x64_addr, size_t size, int is_new);
+uintptr_t AllocDynarecMap(uintptr_t x64_addr, size_t size, int is_new, int hot);
 void FreeDynarecMap(uintptr_t addr);
 mmaplist_t* NewMmaplist();
 void DelMmaplist(mmaplist_t* list);
@@ -47,6 +47,8 @@ int MmaplistAddBlock(mmaplist_t* list, int fd, off_t offset, void* orig, size_t
 void addDBFromAddressRange(uintptr_t addr, size_t size);
 // Will return 1 if at least 1 db in the address range
 int cleanDBFromAddressRange(uintptr_t addr, size_t size, int destroy);
+// mark all blocks built without strongmem barriers as dirty
+void markWeakmemDB(void);
 
 dynablock_t* getDB(uintptr_t idx);
 int getNeedTest(uintptr_t idx);
@@ -95,12 +97,13 @@ uintptr_t getJumpAddress64(uintptr_t addr);
 #endif //SAVE_MEM
 #endif
 
+#define PROT_UFFD       0x200   // PROT_DYNAREC write protection done with userfaultfd
 #define PROT_NEVERCLEAN 0x100
 #define PROT_DYNAREC    0x80
 #define PROT_DYNAREC_R  0x40
 #define PROT_NOPROT     0x20
-#define PROT_DYN        (PROT_DYNAREC | PROT_DYNAREC_R | PROT_NOPROT | PROT_NEVERCLEAN)
-#define PROT_CUSTOM     (PROT_DYNAREC | PROT_DYNAREC_R | PROT_NOPROT | PROT_NEVERCLEAN)
+#define PROT_DYN        (PROT_DYNAREC | PROT_DYNAREC_R | PROT_NOPROT | PROT_NEVERCLEAN | PROT_UFFD)
+#define PROT_CUSTOM     (PROT_DYNAREC | PROT_DYNAREC_R | PROT_NOPROT | PROT_NEVERCLEAN | PROT_UFFD)
 #define PROT_NEVERPROT  (PROT_NOPROT | PROT_NEVERCLEAN)
 #define PROT_WAIT       0xFF
 
@@ -122,6 +125,10 @@ void unprotectDB(uintptr_t addr, size_t size, int mark);    // if mark==0, the b
 void neverprotectDB(uintptr_t addr, size_t size, int mark);
 void unneverprotectDB(uintptr_t addr, size_t size);
 int isprotectedDB(uintptr_t addr, size_t size);
+#define CODECHUNK_SHIFT 6   // code inside a page is tracked by chunks of 64 bytes
+void markCodeChunks(uintptr_t addr, size_t size);   // mark the chunks in the range as holding some code
+int hasCodeChunks(uintptr_t addr, size_t size);     // return 1 if any chunk in the range has code
+int storeProtectedDB(uintptr_t addr, int(*store)(void*), void* data); // do a store on a protected page under the prot lock, cleaning the modified code chunks
 #endif
 void* find32bitBlock(size_t size);
 void* find31bitBlockNearHint(void* hint, size_t size, uintptr_t mask);
@@ -145,6 +152,7 @@ int nLockAddressRange(uintptr_t start, size_t size);    // gives the number of l
 void getLockAddressRange(uintptr_t start, size_t size, uintptr_t addrs[]);   // fill in the array with the lock addresses in the range (array must be of the correct size)
 
 void CheckHotPage(uintptr_t addr, uint32_t prot);
+void NoteHotPageWrite(uintptr_t addr);
 int isInHotPage(uintptr_t addr);
 int checkInHotPage(uintptr_t addr);
 #endif
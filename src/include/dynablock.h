@@ -18,6 +18,12 @@ dynablock_t* FindDynablockFromNativeAddress(void* addr);    // defined in box64c
 dynablock_t* DBGetBlock(x64emu_t* emu, uintptr_t addr, int create, int is32bits);   // return NULL if block is not found / cannot be created. Don't create if create==0
 dynablock_t* DBAlternateBlock(x64emu_t* emu, uintptr_t addr, uintptr_t filladdr, int is32bits);
 
+// BOX64_DYNAREC_STRONGMEM_MT: strongmem barriers are only emitted once the process is multithreaded
+void DynablockSetWeakmem(void);   // a block without the strongmem barriers is in use (loaded from the DynaCache...)
+int DynablockWeakmem(void);     // 1 while the process is single threaded: new blocks can be built without the strongmem barriers
+void DynablockGoMultithread(void);  // to call when a new thread is created
+int DynablockIsStale(dynablock_t* db);  // 1 if block was built without the strongmem barriers, but the process is now multithreaded
+
 // for use in signal handler
 void cancelFillBlock(void);
 
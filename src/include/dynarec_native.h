@@ -4,6 +4,7 @@
 typedef struct dynablock_s dynablock_t;
 typedef struct x64emu_s x64emu_t;
 typedef struct instsize_s instsize_t;
+typedef struct instcheck_s instcheck_t;
 
 
 //#define USE_CUSTOM_MEM
@@ -22,6 +23,7 @@ typedef struct instsize_s instsize_t;
 #define MAX_INSTS   32760
 
 void addInst(instsize_t* insts, size_t* size, int x64_size, int native_size);
+int fillInstCheck(instsize_t* insts, instcheck_t* check, int max);
 
 void CancelBlock64(int need_lock);
 dynablock_t* FillBlock64(uintptr_t addr, int alternate, int is32bits, int inst_max, int is_new);
@@ -45,6 +45,7 @@ extern char* ftrace_name;
     INTEGER(BOX64_DYNAREC_BIGBLOCK, dynarec_bigblock, 2, 0, 3, 1)             \
     BOOLEAN(BOX64_DYNAREC_BLEEDING_EDGE, dynarec_bleeding_edge, 1, 0)         \
     INTEGER(BOX64_DYNAREC_CALLRET, dynarec_callret, 0, 0, 2, 1)               \
+    BOOLEAN(BOX64_DYNAREC_CONSTPROP, dynarec_constprop, 1, 1)                 \
     BOOLEAN(BOX64_DYNAREC_DF, dynarec_df, 1, 1)                               \
     INTEGER(BOX64_DYNAREC_DIRTY, dynarec_dirty, 0, 0, 2, 0)                   \
     BOOLEAN(BOX64_DYNAREC_DIV0, dynarec_div0, 0, 1)                           \
@@ -61,12 +62,15 @@ extern char* ftrace_name;
     BOOLEAN(BOX64_DYNAREC_PERFMAP, dynarec_perf_map, 0, 0)                    \
     INTEGER(BOX64_DYNAREC_SAFEFLAGS, dynarec_safeflags, 1, 0, 2, 1)           \
     INTEGER(BOX64_DYNAREC_STRONGMEM, dynarec_strongmem, 0, 0, 3, 1)           \
+    BOOLEAN(BOX64_DYNAREC_STRONGMEM_MT, dynarec_strongmem_mt, 0, 1)           \
+    BOOLEAN(BOX64_DYNAREC_SVE, dynarec_sve, 0, 1)                             \
     BOOLEAN(BOX64_DYNAREC_TBB, dynarec_tbb, 1, 0)                             \
     STRING(BOX64_DYNAREC_TEST, dynarec_test_str, 1)                           \
     BOOLEAN(BOX64_DYNAREC_TRACE, dynarec_trace, 0, 0)                         \
     BOOLEAN(BOX64_DYNAREC_VOLATILE_METADATA, dynarec_volatile_metadata, 1, 0) \
     BOOLEAN(BOX64_DYNAREC_WAIT, dynarec_wait, 1, 1)                           \
     INTEGER(BOX64_DYNAREC_WEAKBARRIER, dynarec_weakbarrier, 1, 0, 2, 1)       \
+    INTEGER(BOX64_DYNAREC_WRITETRACK, dynarec_writetrack, 0, 0, 1, 0)         \
     INTEGER(BOX64_DYNAREC_X87DOUBLE, dynarec_x87double, 0, 0, 2, 1)           \
     STRING(BOX64_EMULATED_LIBS, emulated_libs, 0)                             \
     STRING(BOX64_ENV, env, 0)                                                 \
@@ -85,6 +89,7 @@ extern char* ftrace_name;
     STRING(BOX64_LD_LIBRARY_PATH, ld_library_path, 0)                         \
     BOOLEAN(BOX64_LIBCEF, libcef, 1, 0)                                       \
     STRING(BOX64_LIBGL, libgl, 0)                                             \
+    INTEGER(BOX64_LIBPATH_INDEX, libpath_index, 1, 0, 2, 0)                   \
     ADDRESS(BOX64_LOAD_ADDR, load_addr, 0)                                    \
     INTEGER(BOX64_LOG, log, DEFAULT_LOG_LEVEL, 0, 3, 1)                       \
     INTEGER(BOX64_MALLOC_HACK, malloc_hack, 0, 0, 2, 0)                       \
@@ -112,6 +117,8 @@ extern char* ftrace_name;
     BOOLEAN(BOX64_SHOWSEGV, showsegv, 0, 0)                                   \
     BOOLEAN(BOX64_SSE_FLUSHTO0, sse_flushto0, 0, 1)                           \
     BOOLEAN(BOX64_SSE42, sse42, 1, 1)                                         \
+    INTEGER(BOX64_STATS, stats, 0, 0, 2, 0)                                   \
+    STRING(BOX64_STATS_FILE, stats_file, 0)                                   \
     BOOLEAN(BOX64_SYNC_ROUNDING, sync_rounding, 0, 0)                         \
     BOOLEAN(BOX64_TRACE_COLOR, trace_regsdiff, 0, 0)                          \
     BOOLEAN(BOX64_TRACE_EMM, trace_emm, 0, 0)                                 \
@@ -121,11 +128,13 @@ extern char* ftrace_name;
     BOOLEAN(BOX64_TRACE_XMM, trace_xmm, 0, 0)                                 \
     STRING(BOX64_TRACE, trace, 0)                                             \
     BOOLEAN(BOX64_UNITYPLAYER, unityplayer, 1, 0)                             \
+    BOOLEAN(BOX64_VDSO, vdso, 1, 0)                                           \
     BOOLEAN(BOX64_WRAP_EGL, wrap_egl, 0, 0)                                   \
     BOOLEAN(BOX64_X11GLX, x11glx, 1, 0)                                       \
     BOOLEAN(BOX64_X11SYNC, x11sync, 0, 0)                                     \
     BOOLEAN(BOX64_X11THREADS, x11threads, 0, 0)                               \
     BOOLEAN(BOX64_X87_NO80BITS, x87_no80bits, 0, 1)                           \
+    INTEGER(BOX64_BINDCACHE, bindcache, 2, 0, 2, 0)                           \
     INTEGER(BOX64_DYNACACHE, dynacache, 2, 0, 2, 0)                           \
     STRING(BOX64_DYNACACHE_FOLDER, dynacache_folder, 0)                       \
     INTEGER(BOX64_DYNACACHE_MIN, dynacache_min, 350, 0, 10240, 0)             \
@@ -197,6 +206,7 @@ typedef struct box64env_s {
 } box64env_t;
 
 typedef struct mmaplist_s mmaplist_t;
+struct mapping_s;
 #ifdef DYNAREC
 typedef struct blocklist_s blocklist_t;
 
@@ -224,6 +234,7 @@ int IsAddrNeedReloc(uintptr_t addr);
 void SerializeAllMapping();
 void DynaCacheList(const char* name);
 void DynaCacheClean();
+const char* GetDynacacheFolder(struct mapping_s* mapping);   // NULL for the global folder
 int IsAddrMappingLoadAndClean(uintptr_t addr);
 
 #endif // __ENV_H
@@ -13,12 +13,17 @@ typedef union cpu_ext_s {
         uint64_t crc32 : 1;
         uint64_t sha1 : 1;
         uint64_t sha2 : 1;
-        uint64_t uscat : 1;
+        uint64_t uscat : 1; // LSE2
         uint64_t flagm : 1;
         uint64_t flagm2 : 1;
         uint64_t frintts : 1;
         uint64_t afp : 1;
         uint64_t rndr : 1;
+        uint64_t lrcpc : 1;
+        uint64_t lrcpc2 : 1;
+        uint64_t sve : 1;
+        uint64_t sve2 : 1;
+        uint64_t svevl : 8; // SVE vector length, in 64bits unit
 #elif defined(RV64)
         uint64_t vlen : 8; // Not *8, 8bits should be enugh? that's 2048 vector
         uint64_t zba : 1;
@@ -32,6 +32,24 @@ uintptr_t FindGlobalSymbol(lib_t *maplib, const char* name, int version, const c
 int GetNoSelfSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, size_t size, int version, const char* vername, int veropt, void** elfsym);
 int GetNextSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, size_t size, int version, const char* vername, int veropt, void** elfsym);
 int GetGlobalSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int version, const char* vername, int veropt, void** elfsym);
+// where a global symbol has been found, so the lookup can be replayed later on that lib only (BOX64_BINDCACHE)
+typedef struct symbind_s {
+    uint8_t     src;    // SYMBIND_xxx
+    uint8_t     weak;   // found in the weak pass
+    uint8_t     local;  // found in the local maplib (set by the caller)
+    uint8_t     unused;
+    int32_t     idx;    // index in preload or in maplib
+} symbind_t;
+#define SYMBIND_NONE        0   // cannot be replayed
+#define SYMBIND_NOTFOUND    1
+#define SYMBIND_PRELOAD     2
+#define SYMBIND_MAIN        3
+#define SYMBIND_MAPLIB      4
+int GetGlobalSymbolStartEndBind(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int version, const char* vername, int veropt, void** elfsym, symbind_t* bind);
+// return 0 if the lookup couldn't be replayed and needs to be done again
+int ReplayGlobalSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int version, const char* vername, int veropt, void** elfsym, symbind_t* bind);
+// hash of the libs in the maplib, in order, to check that a recorded bind is still valid
+uint64_t MapLibHash(lib_t* maplib, uint64_t hash);
 int GetGlobalWeakSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t *self, int version, const char* vername, int veropt, void** elfsym);
 int GetGlobalNoWeakSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, int version, const char* vername, int veropt, void** elfsym);
 int GetLocalSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t *self, int version, const char* vername, int veropt, void** elfsym);
@@ -33,6 +33,7 @@ int GetDeepBind(library_t* lib);
 int GetElfIndex(library_t* lib);    // -1 if no elf (i.e. wrapped)
 elfheader_t* GetElf(library_t* lib);    // NULL if no elf (i.e. wrapped)
 void* GetHandle(library_t* lib);    // NULL if not wrapped
+uint64_t GetNativeLibId(library_t* lib);    // identity (path, size, mtime) of the host library behind a wrapped lib, 0 if none
 void IncRefCount(library_t* lib, x64emu_t* emu);
 int DecRefCount(library_t** lib, x64emu_t* emu);   // might unload the lib!
 int GetRefCount(library_t* lib);
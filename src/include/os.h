@@ -58,6 +58,11 @@ void PersonalityAddrLimit32Bit(void);
 int IsAddrElfOrFileMapped(uintptr_t addr);
 const char* GetNativeName(void* p);
 const char* GetBridgeName(void* p);
+
+// userfaultfd write-protect tracking, return 0 on success
+int InitUffdWriteTracker(void (*handler)(uintptr_t addr));
+void CloseUffdWriteTracker(void);
+int UffdWriteProtect(uintptr_t addr, size_t size, int protect);
 // ----------------------------------------------------------------
 
 #ifndef _WIN32
@@ -20,4 +20,11 @@ void AppendList(path_collection_t* collection, const char* List, int folder);
 void PrependList(path_collection_t* collection, const char* List, int folder);
 int FindInCollection(const char* path, path_collection_t* collection);
 
+// Lazy index of folders content (BOX64_LIBPATH_INDEX), to skip folders that don't have a file.
+// FolderMayHave return 0 if name is not in folder (folders that cannot be listed, or are case-insensitive, always return 1).
+// As the index can be outdated, if a search fails, it can be done again only on the folders for which RefreshFolderIndex
+// return 1 (they changed since indexed)
+int FolderMayHave(const char* folder, const char* name);
+int RefreshFolderIndex(const char* folder);
+
 #endif //__PATHCOLL_H_
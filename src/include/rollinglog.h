@@ -0,0 +1,34 @@
+#ifndef __ROLLINGLOG_H__
+#define __ROLLINGLOG_H__
+
+#include <stdint.h>
+
+// Binary event ring used by BOX64_ROLLING_LOG: each thread writes its own ring without lock,
+// events are only formatted when the log is dumped (print_rolling_log)
+typedef enum rlog_type_e {
+    RLOG_NONE = 0,
+    RLOG_CALL,      // 64bits wrapped function call
+    RLOG_CALL32,    // 32bits wrapped function call
+    RLOG_PLT,       // PltResolver (name is the symbol)
+    RLOG_PLT32,
+    RLOG_SYSCALL,   // fnc is the syscall number
+} rlog_type_t;
+
+typedef struct rlog_entry_s {
+    uint64_t    seq;        // 0 while being written
+    uint64_t    ts;         // ReadTSC ticks
+    uintptr_t   rip;        // return address for calls, RIP for syscalls
+    uintptr_t   fnc;        // wrapped function, or syscall number
+    const char* name;       // static name if known (bridge or symbol name), resolved at dump time otherwise
+    uint64_t    args[6];
+    uint64_t    ret;
+    uint8_t     type;
+    uint8_t     has_ret;
+} rlog_entry_t;
+
+// record an event for the current thread, return an id to use with RollingLogRet
+uint64_t RollingLogCall(rlog_type_t type, uintptr_t rip, uintptr_t fnc, const char* name, uint64_t a0, uint64_t a1, uint64_t a2, uint64_t a3, uint64_t a4, uint64_t a5);
+// set the return value of an event, if it's still in the ring
+void RollingLogRet(uint64_t id, uint64_t ret);
+
+#endif //__ROLLINGLOG_H__
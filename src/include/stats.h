@@ -0,0 +1,45 @@
+#ifndef __STATS_H__
+#define __STATS_H__
+
+#include <stdint.h>
+#include "env.h"
+
+// Runtime statistics, enabled with BOX64_STATS
+typedef enum stat_e {
+    STAT_BLOCK_CREATED,
+    STAT_BLOCK_INVALIDATED,
+    STAT_BLOCK_FREED,
+    STAT_BLOCK_SWITCHED,
+    STAT_LINKNEXT_MISS,
+    STAT_HOTPAGE_HIT,
+    STAT_SMC_SEGV,
+    STAT_SIGBUS_FIX,
+    STAT_FILLBLOCK_TICKS,   // time spent in FillBlock64, in ReadTSC ticks
+    STAT_LAST
+} stat_t;
+
+#define STATS_SYSCALLS  512
+#define STATS_WRAPPERS  512     // per thread, calls to other wrappers are counted as "others"
+
+typedef struct stats_s {
+    uint64_t        counter[STAT_LAST];
+    uint64_t        syscall[2][STATS_SYSCALLS]; // 64bits / 32bits syscalls
+    uint64_t        syscall_other;
+    uintptr_t       wrapper_fnc[STATS_WRAPPERS];
+    uint64_t        wrapper_cnt[STATS_WRAPPERS];
+    uint64_t        wrapper_other;
+    struct stats_s* next;
+} stats_t;
+
+void InitStats(void);
+stats_t* GetThreadStats(void);
+void StatsWrapper(uintptr_t fnc);
+void StatsSyscall(uint32_t n, int is32bits);
+uint64_t StatsTicks(void);
+// aggregate the stats of all threads and dump them to BOX64_STATS_FILE or stderr. from_signal avoid non async-safe functions
+void DumpStats(int from_signal);
+
+#define STAT_ADD(A, N)  do { if(BOX64ENV(stats)) GetThreadStats()->counter[A] += (N); } while(0)
+#define STAT_INC(A)     STAT_ADD(A, 1)
+
+#endif //__STATS_H__
@@ -517,7 +517,8 @@ int GetNextSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, uin
     }
     return 0;
 }
-static int GetGlobalSymbolStartEnd_internal(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int* version, const char** vername, int* veropt, void** elfsym)
+#define SET_BIND(S, I, W) if(bind) { bind->src = S; bind->idx = I; bind->weak = W; }
+static int GetGlobalSymbolStartEnd_internal(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int* version, const char** vername, int* veropt, void** elfsym, symbind_t* bind)
 {
     int weak = 0;
     size_t size = 0;
@@ -526,50 +527,63 @@ static int GetGlobalSymbolStartEnd_internal(lib_t *maplib, const char* name, uin
     if(my_context->preload)
         for(int i=0; i<my_context->preload->size; ++i)
             if(GetLibGlobalSymbolStartEnd(my_context->preload->libs[i], name, start, end, size, &weak, version, vername, isLocal(self, my_context->preload->libs[i]), veropt, elfsym)) {
+                SET_BIND(SYMBIND_PRELOAD, i, 0);
                 return 1;
             }
     if(maplib==my_context->maplib) {
         // search non-weak symbol, from older to newer (first GLOBAL object wins, starting with self)
         if((sym = ElfGetGlobalSymbolStartEnd(my_context->elfs[0], start, end, name, version, vername, (my_context->elfs[0]==self || !self)?1:0, veropt))) {
             if(elfsym) *elfsym = sym;
+            SET_BIND(SYMBIND_MAIN, 0, 0);
             return 1;
         }
     }
     // search in global symbols
     if(maplib) {
         for(int i=0; i<maplib->libsz; ++i) {
-            if(GetLibGlobalSymbolStartEnd(maplib->libraries[i], name, start, end, size, &weak, version, vername, isLocal(self, maplib->libraries[i]), veropt, elfsym))
+            if(GetLibGlobalSymbolStartEnd(maplib->libraries[i], name, start, end, size, &weak, version, vername, isLocal(self, maplib->libraries[i]), veropt, elfsym)) {
+                SET_BIND(SYMBIND_MAPLIB, i, 0);
                 return 1;
+            }
         }
     }
 
+    SET_BIND(SYMBIND_NOTFOUND, 0, 0);
     // GetSymbolStartEnd should not change start/end if symbol is not found
     if((sym = ElfGetWeakSymbolStartEnd(my_context->elfs[0], start, end, name, version, vername, (my_context->elfs[0]==self || !self)?1:0, veropt))) {
         if(elfsym) *elfsym = sym;
         weak = 1;
+        SET_BIND(SYMBIND_MAIN, 0, 1);
     }
     if(maplib)
     for(int i=0; i<maplib->libsz; ++i) {
         if(GetLibWeakSymbolStartEnd(maplib->libraries[i], name, start, end, size, &weak, version, vername, isLocal(self, maplib->libraries[i]), veropt, elfsym)) {
             weak = 1;
+            SET_BIND(SYMBIND_MAPLIB, i, 1);
         }
     }
     // nope, not found
     return weak;
 }
+#undef SET_BIND
 #ifndef STATICBUILD
 void** my_GetGTKDisplay();
 void** my_GetGthreadsGotInitialized();
 #endif
 int GetGlobalSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int version, const char* vername, int veropt, void** elfsym)
 {
-    if(GetGlobalSymbolStartEnd_internal(maplib, name, start, end, self, &version, &vername, &veropt, elfsym)) {
+    return GetGlobalSymbolStartEndBind(maplib, name, start, end, self, version, vername, veropt, elfsym, NULL);
+}
+int GetGlobalSymbolStartEndBind(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int version, const char* vername, int veropt, void** elfsym, symbind_t* bind)
+{
+    if(GetGlobalSymbolStartEnd_internal(maplib, name, start, end, self, &version, &vername, &veropt, elfsym, bind)) {
         if(start && end && *end==*start) {  // object is of 0 sized, try to see an "_END" object of null size
             uintptr_t start2, end2;
             char* buff = (char*)box_malloc(strlen(name) + strlen("_END") + 1);
             strcpy(buff, name);
             strcat(buff, "_END");
-            if(GetGlobalSymbolStartEnd_internal(maplib, buff, &start2, &end2, self, &version, &vername, &veropt, elfsym)) {
+            if(bind) bind->src = SYMBIND_NONE;
+            if(GetGlobalSymbolStartEnd_internal(maplib, buff, &start2, &end2, self, &version, &vername, &veropt, elfsym, NULL)) {
                 if(end2>*end && start2==end2)
                     *end = end2;
             }
@@ -580,12 +594,14 @@ int GetGlobalSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, u
     #ifndef STATICBUILD
     // some special case symbol, defined inside box64 itself
     if(!strcmp(name, "gdk_display") && !BOX64ENV(nogtk)) {
+        if(bind) bind->src = SYMBIND_NONE;
         *start = (uintptr_t)my_GetGTKDisplay();
         *end = *start+sizeof(void*);
         printf_log(LOG_INFO, "Using global gdk_display for gdk-x11 (%p:%p)\n", start, *(void**)start);
         return 1;
     }
     if(!strcmp(name, "g_threads_got_initialized") && !BOX64ENV(nogtk)) {
+        if(bind) bind->src = SYMBIND_NONE;
         *start = (uintptr_t)my_GetGthreadsGotInitialized();
         *end = *start+sizeof(int);
         printf_log(LOG_INFO, "Using global g_threads_got_initialized for gthread2 (%p:%p)\n", start, *(void**)start);
@@ -596,6 +612,63 @@ int GetGlobalSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, u
     return 0;
 }
 
+int ReplayGlobalSymbolStartEnd(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int version, const char* vername, int veropt, void** elfsym, symbind_t* bind)
+{
+    int weak = 0;
+    library_t* lib = NULL;
+    void* sym;
+    switch(bind->src) {
+        case SYMBIND_NOTFOUND:
+            return 1;
+        case SYMBIND_MAIN:
+            if(bind->weak)
+                sym = ElfGetWeakSymbolStartEnd(my_context->elfs[0], start, end, name, &version, &vername, (my_context->elfs[0]==self || !self)?1:0, &veropt);
+            else
+                sym = ElfGetGlobalSymbolStartEnd(my_context->elfs[0], start, end, name, &version, &vername, (my_context->elfs[0]==self || !self)?1:0, &veropt);
+            if(!sym)
+                return 0;
+            if(elfsym) *elfsym = sym;
+            break;
+        case SYMBIND_PRELOAD:
+            if(!my_context->preload || bind->idx>=my_context->preload->size)
+                return 0;
+            lib = my_context->preload->libs[bind->idx];
+            break;
+        case SYMBIND_MAPLIB:
+            if(!maplib || bind->idx>=maplib->libsz)
+                return 0;
+            lib = maplib->libraries[bind->idx];
+            break;
+        default:
+            return 0;
+    }
+    if(lib) {
+        if(bind->weak) {
+            if(!GetLibWeakSymbolStartEnd(lib, name, start, end, 0, &weak, &version, &vername, isLocal(self, lib), &veropt, elfsym))
+                return 0;
+        } else if(!GetLibGlobalSymbolStartEnd(lib, name, start, end, 0, &weak, &version, &vername, isLocal(self, lib), &veropt, elfsym))
+            return 0;
+    }
+    // 0 sized objects need the "_END" lookup
+    return (*end!=*start)?1:0;
+}
+
+uint64_t MapLibHash(lib_t* maplib, uint64_t hash)
+{
+    if(!maplib)
+        return ElfBindHash(hash, "", 1);
+    for(int i=0; i<maplib->libsz; ++i) {
+        library_t* lib = maplib->libraries[i];
+        const char* name = GetNameLib(lib);
+        if(name)
+            hash = ElfBindHash(hash, name, strlen(name)+1);
+        // for a wrapped lib, the symbols it has depend on the host library
+        uint64_t id = GetElf(lib)?ElfBuildId(GetElf(lib)):GetNativeLibId(lib);
+        hash = ElfBindHash(hash, &id, sizeof(id));
+    }
+    return hash;
+}
+
 static int GetGlobalWeakSymbolStartEnd_internal(lib_t *maplib, const char* name, uintptr_t* start, uintptr_t* end, elfheader_t* self, int* version, const char** vername, int* veropt, void** elfsym)
 {
     int weak = 0;
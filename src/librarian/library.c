@@ -400,22 +400,30 @@ static void initEmulatedLib(const char* path, library_t *lib, box64context_t* co
     if(found)
         if(loadEmulatedLib(libname, lib, context, verneeded))
             return;
-    if(!strchr(path, '/'))
-        for(int i=0; i<context->box64_ld_lib.size; ++i)
-        {
-            strcpy(libname, context->box64_ld_lib.paths[i]);
-            strcat(libname, path);
-            if(box64_is32bits?FileIsX86ELF(libname):FileIsX64ELF(libname))
-                if(loadEmulatedLib(libname, lib, context, verneeded))
-                    return;
-            // also try x86_64 variant
-            strcpy(libname, context->box64_ld_lib.paths[i]);
-            strcat(libname, box64_is32bits?"i386/":"x86_64/");
-            strcat(libname, path);
-            if(box64_is32bits?FileIsX86ELF(libname):FileIsX64ELF(libname))
-                if(loadEmulatedLib(libname, lib, context, verneeded))
-                    return;            
-        }
+    if(!strchr(path, '/')) {
+        // 2nd pass only on the folders that changed since they were indexed
+        for(int pass=0; pass<2; ++pass)
+            for(int i=0; i<context->box64_ld_lib.size; ++i)
+            {
+                const char* folder = context->box64_ld_lib.paths[i];
+                if((!pass || RefreshFolderIndex(folder)) && FolderMayHave(folder, path)) {
+                    strcpy(libname, folder);
+                    strcat(libname, path);
+                    if(box64_is32bits?FileIsX86ELF(libname):FileIsX64ELF(libname))
+                        if(loadEmulatedLib(libname, lib, context, verneeded))
+                            return;
+                }
+                // also try x86_64 variant
+                strcpy(libname, folder);
+                strcat(libname, box64_is32bits?"i386/":"x86_64/");
+                if((!pass || RefreshFolderIndex(libname)) && FolderMayHave(libname, path)) {
+                    strcat(libname, path);
+                    if(box64_is32bits?FileIsX86ELF(libname):FileIsX64ELF(libname))
+                        if(loadEmulatedLib(libname, lib, context, verneeded))
+                            return;
+                }
+            }
+    }
 }
 
 static void initDummyLib(library_t *lib)
@@ -1105,6 +1113,26 @@ void* GetHandle(library_t* lib)
     return lib->w.lib;
 }
 
+uint64_t GetNativeLibId(library_t* lib)
+{
+    void* h = GetHandle(lib);
+    if(!h)
+        return 0;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    #ifdef RTLD_DI_LINKMAP
+    struct link_map* lm = NULL;
+    if(!dlinfo(h, RTLD_DI_LINKMAP, &lm) && lm && lm->l_name && lm->l_name[0]) {
+        struct stat st;
+        hash = ElfBindHash(hash, lm->l_name, strlen(lm->l_name));
+        if(!stat(lm->l_name, &st)) {
+            hash = ElfBindHash(hash, &st.st_size, sizeof(st.st_size));
+            hash = ElfBindHash(hash, &st.st_mtime, sizeof(st.st_mtime));
+        }
+    }
+    #endif
+    return hash;
+}
+
 lib_t* GetMaplib(library_t* lib)
 {
     if(!lib)
@@ -466,6 +466,7 @@ void relockMutex(int locks);
 int unlockMutex();
 
 int write_opcode(uintptr_t rip, uintptr_t native_ip, int is32bits);
+void restoreSigMask(void* ucntx);
 #define is_memprot_locked (1<<1)
 #define is_dyndump_locked (1<<8)
 void my_sigactionhandler_oldcode_32(x64emu_t* emu, int32_t sig, int simple, siginfo_t* info, void * ucntx, int* old_code, void* cur_db)
@@ -759,6 +760,7 @@ void my_sigactionhandler_oldcode_32(x64emu_t* emu, int32_t sig, int simple, sigi
             #ifdef RV64
             emu->xSPSave = emu->old_savedsp;
             #endif
+            restoreSigMask(ucntx);
             #ifdef ANDROID
             siglongjmp(*emu->jmpbuf, 1);
             #else
@@ -35,6 +35,7 @@
 #include "bridge.h"
 #include "khash.h"
 #include "x64trace.h"
+#include "stats.h"
 #ifdef DYNAREC
 #include "dynablock.h"
 #include "../dynarec/dynablock_private.h"
@@ -267,8 +268,14 @@ EXPORT int my_sigaltstack(x64emu_t* emu, const x64_stack_t* ss, x64_stack_t* oss
 x64emu_t* getEmuSignal(x64emu_t* emu, ucontext_t* p, dynablock_t* db)
 {
 #if defined(ARM64)
-        if(db && p->uc_mcontext.regs[0]>0x10000) {
-            emu = (x64emu_t*)p->uc_mcontext.regs[0];
+        if(db) {
+            // inside a direct syscall, xEmu is saved in x6 while x0 is the 1st arg or the return value:
+            // from the SVC 0 (pc[0], x0 might be the 1st arg), to the MOV xEmu, x6 that follows MOV xRAX, x0
+            uint32_t* pc = (uint32_t*)p->uc_mcontext.pc;
+            if(pc[0]==0xD4000001 || pc[-1]==0xD4000001 || (pc[-2]==0xD4000001 && pc[-1]==0xAA0003EA))
+                emu = (x64emu_t*)p->uc_mcontext.regs[6];
+            else if(p->uc_mcontext.regs[0]>0x10000)
+                emu = (x64emu_t*)p->uc_mcontext.regs[0];
         }
 #elif defined(LA64)
         if(db && p->uc_mcontext.__gregs[4]>0x10000) {
@@ -284,6 +291,13 @@ x64emu_t* getEmuSignal(x64emu_t* emu, ucontext_t* p, dynablock_t* db)
     return emu;
 }
 #endif
+// The emu jmpbuf doesn't save the signal mask (it would be a syscall on each DynaRun entry),
+// so restore the mask of the interrupted context just before leaving the handler with siglongjmp
+void restoreSigMask(void* ucntx)
+{
+    if(ucntx)
+        sigprocmask(SIG_SETMASK, &((ucontext_t*)ucntx)->uc_sigmask, NULL);
+}
 int write_opcode(uintptr_t rip, uintptr_t native_ip, int is32bits);
 void adjustregs(x64emu_t* emu) {
 // tests some special cases
@@ -462,14 +476,65 @@ if(BOX64ENV(showsegv)) printf_log(LOG_INFO, "Marked db %p as dirty, and address
 }
 #endif
 
-int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd, dynablock_t* db, uintptr_t x64pc, int is32bits)
+#ifdef ARM64
+// LDAR/LDAPR/STLR and LDAPUR/STLUR (zero extended), as emitted by the strongmem RCpc MOV path
+static int sigbus_is_acqrel(uint32_t opcode)
 {
-    if((uintptr_t)pc<0x10000)
-        return 0;
-#ifdef DYNAREC
-    if(ARCH_UNALIGNED(db, x64pc))
-        /*return*/ mark_db_unaligned(db, x64pc);    // don't force an exit for now
+    if((opcode&0x3FFFFC00)==0x089FFC00 || (opcode&0x3FFFFC00)==0x08DFFC00 || (opcode&0x3FFFFC00)==0x38BFC000)
+        return 1;
+    if((opcode&0x3FA00C00)==0x19000000)
+        return 1;
+    return 0;
+}
 #endif
+
+typedef uint16_t __attribute__((aligned(1))) u16_unaligned_t;
+typedef uint32_t __attribute__((aligned(1))) u32_unaligned_t;
+typedef uint64_t __attribute__((aligned(1))) u64_unaligned_t;
+// store size bytes (up to 16) of value at addr
+// exact: one access of that size (two for 16 bytes) and ordering, as the original opcode (for a store on a protected page)
+// else: splitted in 32bits or 8bits accesses (for a SIGBUS on unaligned device memory)
+static void sigbus_store(volatile uint8_t* addr, __uint128_t value, int size, int exact, int release)
+{
+    int aligned = !(((uintptr_t)addr)&(size-1));
+    if(exact) {
+        if(release && aligned && size<=8) {
+            switch(size) {
+                case 1: __atomic_store_n((uint8_t*)addr, (uint8_t)value, __ATOMIC_RELEASE); break;
+                case 2: __atomic_store_n((uint16_t*)addr, (uint16_t)value, __ATOMIC_RELEASE); break;
+                case 4: __atomic_store_n((uint32_t*)addr, (uint32_t)value, __ATOMIC_RELEASE); break;
+                case 8: __atomic_store_n((uint64_t*)addr, (uint64_t)value, __ATOMIC_RELEASE); break;
+            }
+            return;
+        }
+        if(release)
+            __atomic_thread_fence(__ATOMIC_RELEASE);
+        switch(size) {
+            case 1: *addr = value; break;
+            case 2: *(volatile u16_unaligned_t*)addr = value; break;
+            case 4: *(volatile u32_unaligned_t*)addr = value; break;
+            case 8: *(volatile u64_unaligned_t*)addr = value; break;
+            case 16:
+                ((volatile u64_unaligned_t*)addr)[0] = value;
+                ((volatile u64_unaligned_t*)addr)[1] = value>>64;
+                break;
+        }
+        return;
+    }
+    if(release)
+        __sync_synchronize();
+    if(size>=4 && !(((uintptr_t)addr)&3)) {
+        for(int i=0; i<size/4; ++i)
+            ((volatile uint32_t*)addr)[i] = (value>>(i*32))&0xffffffff;
+    } else
+        for(int i=0; i<size; ++i)
+            addr[i] = (value>>(i*8))&0xff;
+}
+
+// emulate the load or store at pc, and advance pc. Return 0 if the opcode is not handled
+// exact is for stores on a valid (but protected) page, that need to be done as the original opcode
+static int sigbus_emulate_access(void * ucntx, void* pc, void* _fpsimd, int is32bits, int exact)
+{
 #ifdef ARM64
     ucontext_t *p = (ucontext_t *)ucntx;
     uint32_t opcode = *(uint32_t*)pc;
@@ -485,12 +550,7 @@ int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd,
         volatile uint8_t* addr = (void*)(p->uc_mcontext.regs[dest] + offset);
         if(is32bits) addr = (uint8_t*)(((uintptr_t)addr)&0xffffffff);
         uint64_t value = p->uc_mcontext.regs[val];
-        if(scale==3 && (((uintptr_t)addr)&3)==0) {
-            for(int i=0; i<2; ++i)
-                ((volatile uint32_t*)addr)[i] = (value>>(i*32))&0xffffffff;
-        } else
-            for(int i=0; i<(1<<scale); ++i)
-                addr[i] = (value>>(i*8))&0xff;
+        sigbus_store(addr, value, 1<<scale, exact, 0);
         p->uc_mcontext.pc+=4;   // go to next opcode
         return 1;
     }
@@ -505,12 +565,7 @@ int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd,
         volatile uint8_t* addr = (void*)(p->uc_mcontext.regs[dest] + offset);
         if(is32bits) addr = (uint8_t*)(((uintptr_t)addr)&0xffffffff);
         uint64_t value = p->uc_mcontext.regs[val];
-        if(size==8 && (((uintptr_t)addr)&3)==0) {
-            for(int i=0; i<2; ++i)
-                ((volatile uint32_t*)addr)[i] = (value>>(i*32))&0xffffffff;
-        } else
-            for(int i=0; i<size; ++i)
-                addr[i] = (value>>(i*8))&0xff;
+        sigbus_store(addr, value, size, exact, 0);
         p->uc_mcontext.pc+=4;   // go to next opcode
         return 1;
     }
@@ -530,12 +585,7 @@ int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd,
         volatile uint8_t* addr = (void*)(p->uc_mcontext.regs[dest] + offset);
         if(is32bits) addr = (uint8_t*)(((uintptr_t)addr)&0xffffffff);
         __uint128_t value = fpsimd->vregs[val];
-        if(scale>2 && (((uintptr_t)addr)&3)==0) {
-            for(int i=0; i<(1<<(scale-2)); ++i)
-                ((volatile uint32_t*)addr)[i] = (value>>(i*32))&0xffffffff;
-        } else
-            for(int i=0; i<(1<<scale); ++i)
-                addr[i] = (value>>(i*8))&0xff;
+        sigbus_store(addr, value, 1<<scale, exact, 0);
         p->uc_mcontext.pc+=4;   // go to next opcode
         return 1;
     }
@@ -556,12 +606,7 @@ int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd,
         volatile uint8_t* addr = (void*)(p->uc_mcontext.regs[dest] + offset);
         if(is32bits) addr = (uint8_t*)(((uintptr_t)addr)&0xffffffff);
         __uint128_t value = fpsimd->vregs[val];
-        if(scale>2 && (((uintptr_t)addr)&3)==0) {
-            for(int i=0; i<(1<<(scale-2)); ++i)
-                ((volatile uint32_t*)addr)[i] = (value>>(i*32))&0xffffffff;
-        } else
-            for(int i=0; i<(1<<scale); ++i)
-                addr[i] = (value>>(i*8))&0xff;
+        sigbus_store(addr, value, 1<<scale, exact, 0);
         p->uc_mcontext.pc+=4;   // go to next opcode
         return 1;
     }
@@ -669,8 +714,7 @@ int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd,
         volatile uint8_t* addr = (void*)(p->uc_mcontext.regs[dest] + offset);
         if(is32bits) addr = (uint8_t*)(((uintptr_t)addr)&0xffffffff);
         uint64_t value = p->uc_mcontext.regs[val];
-        for(int i=0; i<(1<<scale); ++i)
-            addr[i] = (value>>(i*8))&0xff;
+        sigbus_store(addr, value, 1<<scale, exact, 0);
         p->uc_mcontext.pc+=4;   // go to next opcode
         return 1;
     }
@@ -684,8 +728,7 @@ int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd,
         volatile uint8_t* addr = (void*)(p->uc_mcontext.regs[dest] + offset);
         if(is32bits) addr = (uint8_t*)(((uintptr_t)addr)&0xffffffff);
         uint64_t value = p->uc_mcontext.regs[val];
-        for(int i=0; i<2; ++i)
-            addr[i] = (value>>(i*8))&0xff;
+        sigbus_store(addr, value, 2, exact, 0);
         p->uc_mcontext.pc+=4;   // go to next opcode
         return 1;
     }
@@ -703,8 +746,7 @@ int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd,
         volatile uint8_t* addr = (void*)(p->uc_mcontext.regs[dest] + offset);
         if(is32bits) addr = (uint8_t*)(((uintptr_t)addr)&0xffffffff);
         uint64_t value = p->uc_mcontext.regs[val];
-        for(int i=0; i<(1<<scale); ++i)
-            addr[i] = (value>>(i*8))&0xff;
+        sigbus_store(addr, value, 1<<scale, exact, 0);
         p->uc_mcontext.pc+=4;   // go to next opcode
         return 1;
     }
@@ -720,14 +762,8 @@ int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd,
         offset <<= scale;
         uintptr_t addr= p->uc_mcontext.regs[dest] + offset;
         if(is32bits) addr = addr&0xffffffff;
-        if((((uintptr_t)addr)&3)==0) {
-            ((volatile uint32_t*)addr)[0] = p->uc_mcontext.regs[val1];
-            ((volatile uint32_t*)addr)[1] = p->uc_mcontext.regs[val2];
-        } else {
-            __uint128_t value = ((__uint128_t)p->uc_mcontext.regs[val2])<<64 | p->uc_mcontext.regs[val1];
-            for(int i=0; i<(1<<scale); ++i)
-                ((volatile uint8_t*)addr)[i] = (value>>(i*8))&0xff;
-        }
+        sigbus_store((volatile uint8_t*)addr, p->uc_mcontext.regs[val1], 1<<scale, exact, 0);
+        sigbus_store((volatile uint8_t*)addr+(1<<scale), p->uc_mcontext.regs[val2], 1<<scale, exact, 0);
         p->uc_mcontext.pc+=4;   // go to next opcode
         return 1;
     }
@@ -743,17 +779,8 @@ int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd,
         offset <<= scale;
         uintptr_t addr= p->uc_mcontext.regs[dest] + offset;
         if(is32bits) addr = addr&0xffffffff;
-        if((((uintptr_t)addr)&3)==0) {
-            for(int i=0; i<4; ++i)
-                ((volatile uint32_t*)addr)[0+i] = (fpsimd->vregs[val1]>>(i*32))&0xffffffff;
-            for(int i=0; i<4; ++i)
-                ((volatile uint32_t*)addr)[4+i] = (fpsimd->vregs[val2]>>(i*32))&0xffffffff;
-        } else {
-            for(int i=0; i<16; ++i)
-                ((volatile uint8_t*)addr)[i] = (fpsimd->vregs[val1]>>(i*8))&0xff;
-            for(int i=0; i<16; ++i)
-                ((volatile uint8_t*)addr)[16+i] = (fpsimd->vregs[val2]>>(i*8))&0xff;
-        }
+        sigbus_store((volatile uint8_t*)addr, fpsimd->vregs[val1], 1<<scale, exact, 0);
+        sigbus_store((volatile uint8_t*)addr+(1<<scale), fpsimd->vregs[val2], 1<<scale, exact, 0);
         p->uc_mcontext.pc+=4;   // go to next opcode
         return 1;
     }
@@ -765,12 +792,7 @@ int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd,
         volatile uint8_t* addr = (void*)(p->uc_mcontext.regs[dest]);
         if(is32bits) addr = (uint8_t*)(((uintptr_t)addr)&0xffffffff);
         uint64_t value = fpsimd->vregs[val]>>(idx*64);
-        if((((uintptr_t)addr)&3)==0) {
-            for(int i=0; i<2; ++i)
-                ((volatile uint32_t*)addr)[i] = (value>>(i*32))&0xffffffff;
-        } else
-            for(int i=0; i<8; ++i)
-                addr[i] = (value>>(i*8))&0xff;
+        sigbus_store(addr, value, 8, exact, 0);
         p->uc_mcontext.pc+=4;   // go to next opcode
         return 1;
     }
@@ -807,16 +829,39 @@ int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd,
         volatile uint8_t* addr = (void*)(p->uc_mcontext.regs[src]);
         if(is32bits) addr = (uint8_t*)(((uintptr_t)addr)&0xffffffff);
         uint64_t value = p->uc_mcontext.regs[val];
-        if(size==8 && (((uintptr_t)addr)&3)==0) {
-            for(int i=0; i<2; ++i)
-                ((volatile uint32_t*)addr)[i] = (value>>(i*32))&0xffffffff;
-        } else
-            for(int i=0; i<size; ++i)
-                addr[i] = (value>>(i*8))&0xff;
+        sigbus_store(addr, value, size, exact, 0);
         p->uc_mcontext.regs[src] += offset;
         p->uc_mcontext.pc+=4;   // go to next opcode
         return 1;
     }
+    if(sigbus_is_acqrel(opcode)) {
+        // this is a LDAR/LDAPR/STLR or LDAPUR/STLUR, used by strongmem
+        int size = 1<<((opcode>>30)&3);
+        int val = opcode&31;
+        int dest = (opcode>>5)&31;
+        int load = ((opcode&0x3F000000)==0x19000000)?((opcode>>22)&1):(((opcode&0x3FFFFC00)==0x089FFC00)?0:1);
+        int64_t offset = 0;
+        if((opcode&0x3F000000)==0x19000000) {
+            offset = (opcode>>12)&0b111111111;
+            if((offset>>(9-1))&1)
+                offset |= (0xffffffffffffffffll<<9);
+        }
+        volatile uint8_t* addr = (void*)(p->uc_mcontext.regs[dest] + offset);
+        if(is32bits) addr = (uint8_t*)(((uintptr_t)addr)&0xffffffff);
+        if(load) {
+            uint64_t value = 0;
+            for(int i=0; i<size; ++i)
+                value |= ((uint64_t)addr[i]) << (i*8);
+            __sync_synchronize();
+            if(val!=31)
+                p->uc_mcontext.regs[val] = value;
+        } else {
+            uint64_t value = (val==31)?0:p->uc_mcontext.regs[val];
+            sigbus_store(addr, value, size, exact, 1);
+        }
+        p->uc_mcontext.pc+=4;   // go to next opcode
+        return 1;
+    }
 #elif RV64
 #define GET_FIELD(v, high, low) (((v) >> low) & ((1ULL << (high - low + 1)) - 1))
 #define SIGN_EXT(val, val_sz) (((int32_t)(val) << (32 - (val_sz))) >> (32 - (val_sz)))
@@ -834,13 +879,9 @@ int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd,
         volatile uint8_t *addr = (void *)(p->uc_mcontext.__gregs[dest] + imm);
         if(is32bits) addr = (uint8_t*)(((uintptr_t)addr)&0xffffffff);
         uint64_t value = opcode == 0b0100011 ? p->uc_mcontext.__gregs[val] : p->uc_mcontext.__fpregs.__d.__f[val<<1];
-        for(int i = 0; i < (funct3 == 0b010 ? 4 : funct3 == 0b011 ? 8 : 2); ++i) {
-            addr[i] = (value >> (i * 8)) & 0xff;
-        }
+        sigbus_store(addr, value, funct3 == 0b010 ? 4 : funct3 == 0b011 ? 8 : 2, exact, 0);
         p->uc_mcontext.__gregs[0] += 4; // pc += 4
         return 1;
-    } else {
-        printf_log(LOG_NONE, "Unsupported SIGBUS special cases with pc=%p, opcode=%x\n", pc, inst);
     }
 
 #undef GET_FIELD
@@ -850,6 +891,65 @@ int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd,
 #undef CHECK
 }
 
+int sigbus_specialcases(siginfo_t* info, void * ucntx, void* pc, void* _fpsimd, dynablock_t* db, uintptr_t x64pc, int is32bits)
+{
+    if((uintptr_t)pc<0x10000)
+        return 0;
+#ifdef DYNAREC
+    if(ARCH_UNALIGNED(db, x64pc))
+        /*return*/ mark_db_unaligned(db, x64pc);    // don't force an exit for now
+#ifdef ARM64
+    else if(db && sigbus_is_acqrel(*(uint32_t*)pc))
+        mark_db_unaligned(db, x64pc);   // rebuild without the acquire/release opcode
+#endif
+#endif
+    int ret = sigbus_emulate_access(ucntx, pc, _fpsimd, is32bits, 0);
+    if(ret)
+        STAT_INC(STAT_SIGBUS_FIX);
+#ifdef RV64
+    if(!ret)
+        printf_log(LOG_NONE, "Unsupported SIGBUS special cases with pc=%p, opcode=%x\n", pc, *(uint32_t*)pc);
+#endif
+    return ret;
+}
+
+#ifdef DYNAREC
+#define SMC_STORE_MAX   32  // biggest store that can be emulated (a pair of Q registers)
+extern void* current_helper;
+typedef struct smc_store_s {
+    void*   ucntx;
+    void*   pc;
+    void*   fpsimd;
+    int     is32bits;
+} smc_store_t;
+static int smc_do_store(void* data)
+{
+    smc_store_t* st = (smc_store_t*)data;
+    return sigbus_emulate_access(st->ucntx, st->pc, st->fpsimd, st->is32bits, 1);
+}
+// A write from a dynablock to a protected page: emulate the store with the page temporarily writable (under the prot lock),
+// and only mark the dynablocks that have code in the written chunks. The page stays protected.
+// Return 1 if the store has been emulated
+static int smc_emulate_store(void* ucntx, void* pc, void* fpsimd, dynablock_t* db, uintptr_t addr, int is32bits)
+{
+    if(!db || current_helper)
+        return 0;   // not from a dynablock, or a block is being built: use the slow path
+    uintptr_t page = addr&~(box64_pagesize-1);
+    if(((addr+SMC_STORE_MAX-1)&~(box64_pagesize-1))!=page)
+        return 0;   // the store might cross a page
+    uintptr_t start = addr&~((1<<CODECHUNK_SHIFT)-1);
+    uintptr_t end = (addr+SMC_STORE_MAX+(1<<CODECHUNK_SHIFT)-1)&~((1<<CODECHUNK_SHIFT)-1);
+    // writing on the code of the current block needs to exit the block
+    if(((uintptr_t)db->x64_addr<end) && ((uintptr_t)db->x64_addr+db->hash_size>start))
+        return 0;
+    smc_store_t st = {ucntx, pc, fpsimd, is32bits};
+    int ret = storeProtectedDB(addr, smc_do_store, &st);
+    if(ret)
+        dynarec_log(LOG_DEBUG, "Emulated write on protected page at %p from db %p\n", (void*)addr, db);
+    return ret;
+}
+#endif
+
 #ifdef USE_CUSTOM_MUTEX
 extern uint32_t mutex_prot;
 extern uint32_t mutex_blocks;
@@ -1229,6 +1329,7 @@ void my_sigactionhandler_oldcode_64(x64emu_t* emu, int32_t sig, int simple, sigi
             #ifdef RV64
             emu->xSPSave = emu->old_savedsp;
             #endif
+            restoreSigMask(ucntx);
             #ifdef ANDROID
             siglongjmp(*emu->jmpbuf, 1);
             #else
@@ -1494,8 +1595,9 @@ void my_box64signalhandler(int32_t sig, siginfo_t* info, void * ucntx)
                 }
                 // check if block is still valid
                 int is_hotpage = checkInHotPage(x64pc);
-                uint32_t hash = (db->gone || is_hotpage)?0:X31_hash_code(db->x64_addr, db->x64_size);
-                if(!db->gone && !is_hotpage && hash==db->hash) {
+                int is_stale = !db->gone && DynablockIsStale(db);
+                uint32_t hash = (db->gone || is_hotpage || is_stale)?0:X31_hash_code(db->x64_addr, db->hash_size);
+                if(!db->gone && !is_hotpage && !is_stale && hash==db->hash) {
                     dynarec_log(LOG_INFO, "Dynablock (%p, x64addr=%p, always_test=%d) is clean, %s continuing at %p (%p)!\n", db, db->x64_addr, db->always_test, type_callret?"self-loop":"ret from callret", (void*)x64pc, (void*)addr);
                     // it's good! go next opcode
                     #ifdef __aarch64__
@@ -1514,7 +1616,7 @@ void my_box64signalhandler(int32_t sig, siginfo_t* info, void * ucntx)
                                 *(uint32_t*)(db->block+db->callrets[i].offs) = ARCH_NOP;
                             ClearCache(db->block, db->size);
                         }
-                        protectDBJumpTable((uintptr_t)db->x64_addr, db->x64_size, db->block, db->jmpnext);
+                        protectDBJumpTable((uintptr_t)db->x64_addr, db->hash_size, db->block, db->jmpnext);
                     }
                     return;
                 } else {
@@ -1527,9 +1629,10 @@ void my_box64signalhandler(int32_t sig, siginfo_t* info, void * ucntx)
                             if(db && db->arch_size)
                                 ARCH_ADJUST(db, emu, p, x64pc);
                         }
-                        dynarec_log(LOG_INFO, "Dynablock (%p, x64addr=%p) %s, getting out at %s %p (%p)!\n", db, db->x64_addr, is_hotpage?"in HotPage":"dirty", getAddrFunctionName(R_RIP), (void*)R_RIP, type_callret?"self-loop":"ret from callret", (void*)addr);
+                        dynarec_log(LOG_INFO, "Dynablock (%p, x64addr=%p) %s, getting out at %s %p (%p)!\n", db, db->x64_addr, is_hotpage?"in HotPage":(is_stale?"stale":"dirty"), getAddrFunctionName(R_RIP), (void*)R_RIP, type_callret?"self-loop":"ret from callret", (void*)addr);
                         emu->test.clean = 0;
                         // use "3" to regen a dynablock at current pc (else it will first do an interp run)
+                        restoreSigMask(ucntx);
                         #ifdef ANDROID
                         siglongjmp(*(JUMPBUFF*)emu->jmpbuf, 3);
                         #else
@@ -1588,6 +1691,7 @@ void my_box64signalhandler(int32_t sig, siginfo_t* info, void * ucntx)
     }
     if ((sig==SIGSEGV) && (addr) && (info->si_code == SEGV_ACCERR) && (prot&PROT_DYNAREC)) {
         lock_signal();
+        STAT_INC(STAT_SMC_SEGV);
         // check if SMC inside block
         if(!db_searched) {
             db = FindDynablockFromNativeAddress(pc);
@@ -1595,11 +1699,18 @@ void my_box64signalhandler(int32_t sig, siginfo_t* info, void * ucntx)
                 x64pc = getX64Address(db, (uintptr_t)pc);
             db_searched = 1;
         }
+        // if only data or other blocks are written, emulate the store and keep the page protected
+        if(smc_emulate_store(ucntx, pc, fpsimd, db, (uintptr_t)addr, emu->segs[_CS]==0x23)) {
+            CheckHotPage((uintptr_t)addr, prot);
+            unlock_signal();
+            relockMutex(Locks);
+            return;
+        }
         // access error, unprotect the block (and mark them dirty)
         unprotectDB((uintptr_t)addr, 1, 1);    // unprotect 1 byte... But then, the whole page will be unprotected
         CheckHotPage((uintptr_t)addr, prot);
         int db_need_test = (db && !BOX64ENV(dynarec_dirty))?getNeedTest((uintptr_t)db->x64_addr):0;
-        if(db && ((addr>=db->x64_addr && addr<(db->x64_addr+db->x64_size)) || db_need_test)) {
+        if(db && ((addr>=db->x64_addr && addr<(db->x64_addr+db->hash_size)) || db_need_test)) {
             emu = getEmuSignal(emu, p, db);
             // dynablock got auto-dirty! need to get out of it!!!
             if(emu->jmpbuf) {
@@ -1608,12 +1719,13 @@ void my_box64signalhandler(int32_t sig, siginfo_t* info, void * ucntx)
                 adjustregs(emu);
                 if(db && db->arch_size)
                     ARCH_ADJUST(db, emu, p, x64pc);
-                dynarec_log(LOG_INFO, "Dynablock (%p, x64addr=%p, need_test=%d/%d/%d) %s, getting out at %p (%p)!\n", db, db->x64_addr, db_need_test, db->dirty, db->always_test, (addr>=db->x64_addr && addr<(db->x64_addr+db->x64_size))?"Auto-SMC":"unprotected", (void*)R_RIP, (void*)addr);
+                dynarec_log(LOG_INFO, "Dynablock (%p, x64addr=%p, need_test=%d/%d/%d) %s, getting out at %p (%p)!\n", db, db->x64_addr, db_need_test, db->dirty, db->always_test, (addr>=db->x64_addr && addr<(db->x64_addr+db->hash_size))?"Auto-SMC":"unprotected", (void*)R_RIP, (void*)addr);
                 //relockMutex(Locks);
                 unlock_signal();
                 if(Locks & is_dyndump_locked)
                     CancelBlock64(1);
                 emu->test.clean = 0;
+                restoreSigMask(ucntx);
                 #ifdef ANDROID
                 siglongjmp(*(JUMPBUFF*)emu->jmpbuf, 2);
                 #else
@@ -1895,7 +2007,7 @@ dynarec_log(/*LOG_DEBUG*/LOG_INFO, "%04d|Repeated SIGSEGV with Access error on %
             #endif
             uint32_t hash = 0;
             if(db)
-                hash = X31_hash_code(db->x64_addr, db->x64_size);
+                hash = X31_hash_code(db->x64_addr, db->hash_size);
             printf_log(log_minimum, "%04d|%s @%p (%s) (x64pc=%p/\"%s\", rsp=%p, stack=%p:%p own=%p fp=%p), for accessing %p (code=%d/prot=%x), db=%p(%p:%p/%p:%p/%s:%s, hash:%x/%x) handler=%p",
                 GetTID(), signame, pc, name, (void*)x64pc, x64name?:"???", rsp,
                 emu->init_stack, emu->init_stack+emu->size_stack, emu->stack2free, (void*)R_RBP,
@@ -2100,7 +2212,7 @@ int EXPORT my_sigaction(x64emu_t* emu, int signum, const x64_sigaction_t *act, x
         my_context->onstack[signum] = (act->sa_flags&SA_ONSTACK)?1:0;
     }
     int ret = 0;
-    if(signum!=SIGSEGV && signum!=SIGBUS && signum!=SIGILL && signum!=SIGABRT)
+    if(signum!=SIGSEGV && signum!=SIGBUS && signum!=SIGILL && signum!=SIGABRT && !(signum==SIGUSR2 && BOX64ENV(stats)==2))
         ret = sigaction(signum, act?&newact:NULL, oldact?&old:NULL);
     if(oldact) {
         oldact->sa_flags = old.sa_flags;
@@ -2207,7 +2319,7 @@ int EXPORT my_syscall_rt_sigaction(x64emu_t* emu, int signum, const x64_sigactio
         }
         int ret = 0;
 
-        if(signum!=SIGSEGV && signum!=SIGBUS && signum!=SIGILL && signum!=SIGABRT)
+        if(signum!=SIGSEGV && signum!=SIGBUS && signum!=SIGILL && signum!=SIGABRT && !(signum==SIGUSR2 && BOX64ENV(stats)==2))
             ret = sigaction(signum, act?&newact:NULL, oldact?&old:NULL);
         if(oldact && ret==0) {
             oldact->sa_flags = old.sa_flags;
@@ -206,6 +206,9 @@ x64emu_t* thread_get_emu()
 		x64emu_t *emu = NewX64Emu(my_context, 0, (uintptr_t)stack, stacksize, 1);
 		SetupX64Emu(emu, NULL);
 		thread_set_emu(emu);
+		#ifdef DYNAREC
+		DynablockGoMultithread();	// a native thread is running x64 code
+		#endif
 		return emu;
 	}
 	return et->emu;
@@ -538,6 +541,7 @@ EXPORT int my_pthread_create(x64emu_t *emu, void* t, void* attr, void* start_rou
 	et->arg = arg;
 	#ifdef DYNAREC
 	if(BOX64ENV(dynarec)) {
+		DynablockGoMultithread();
 		// pre-creation of the JIT code for the entry point of the thread
 		DBGetBlock(emu, (uintptr_t)start_routine, 1, 0);	// function wrapping are 64bits only on box64
 	}
@@ -564,6 +568,7 @@ void* my_prepare_thread(x64emu_t *emu, void* f, void* arg, int ssize, void** pet
 	et->arg = arg;
 	#ifdef DYNAREC
 	if(BOX64ENV(dynarec)) {
+		DynablockGoMultithread();
 		// pre-creation of the JIT code for the entry point of the thread
 		DBGetBlock(emu, (uintptr_t)f, 1, 0);	// function wrapping are 64bits only on box64
 	}
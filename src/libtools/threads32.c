@@ -233,6 +233,7 @@ EXPORT int my32_pthread_create(x64emu_t *emu, void* t, void* attr, void* start_r
 	}
 	#ifdef DYNAREC
 	if(BOX64ENV(dynarec)) {
+		DynablockGoMultithread();
 		// pre-creation of the JIT code for the entry point of the thread
 		DBGetBlock(emu, (uintptr_t)start_routine, 1, 1);
 	}
@@ -265,6 +266,7 @@ void* my32_prepare_thread(x64emu_t *emu, void* f, void* arg, int ssize, void** p
 	et->arg = arg;
 	#ifdef DYNAREC
 	if(BOX64ENV(dynarec)) {
+		DynablockGoMultithread();
 		// pre-creation of the JIT code for the entry point of the thread
 		dynablock_t *current = NULL;
 		DBGetBlock(emu, (uintptr_t)f, 1, 1);
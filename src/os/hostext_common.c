@@ -28,6 +28,12 @@ void PrintHostCpuFeatures(void)
         printf_log_prefix(0, LOG_INFO, " AFP");
     if(cpuext.rndr)
         printf_log_prefix(0, LOG_INFO, " RNDR");
+    if(cpuext.lrcpc)
+        printf_log_prefix(0, LOG_INFO, " LRCPC");
+    if(cpuext.lrcpc2)
+        printf_log_prefix(0, LOG_INFO, " LRCPC2");
+    if(cpuext.sve)
+        printf_log_prefix(0, LOG_INFO, " SVE%s(VL=%d)", cpuext.sve2?"2":"", cpuext.svevl*64);
     printf_log_prefix(0, LOG_INFO, "\n");
 #elif defined(LA64)
     printf_log(LOG_INFO, "Dynarec for LoongArch with extension LSX LASX");
@@ -7,6 +7,13 @@
 #ifdef ARM64
 #include <linux/auxvec.h>
 #include <asm/hwcap.h>
+#include <sys/prctl.h>
+#ifndef PR_SVE_GET_VL
+#define PR_SVE_GET_VL 51
+#endif
+#ifndef PR_SVE_VL_LEN_MASK
+#define PR_SVE_VL_LEN_MASK 0xffff
+#endif
 #endif
 
 #ifdef RV64
@@ -166,11 +173,33 @@ int DetectHostCpuFeatures(void)
     if(hwcap&HWCAP_FLAGM)
         cpuext.flagm = 1;
     #endif
+    #ifdef HWCAP_LRCPC
+    if(hwcap&HWCAP_LRCPC)
+        cpuext.lrcpc = 1;
+    #endif
+    #ifdef HWCAP_ILRCPC
+    if(hwcap&HWCAP_ILRCPC)
+        cpuext.lrcpc2 = 1;
+    #endif
+    #ifdef HWCAP_SVE
+    if(hwcap&HWCAP_SVE) {
+        // vector length in bytes, for the current thread (inherited by the new ones)
+        int vl = prctl(PR_SVE_GET_VL);
+        if(vl>0) {
+            cpuext.sve = 1;
+            cpuext.svevl = (vl&PR_SVE_VL_LEN_MASK)/8;
+        }
+    }
+    #endif
     unsigned long hwcap2 = real_getauxval(AT_HWCAP2);
     #ifdef HWCAP2_FLAGM2
     if(hwcap2&HWCAP2_FLAGM2)
         cpuext.flagm2 = 1;
     #endif
+    #ifdef HWCAP2_SVE2
+    if(cpuext.sve && (hwcap2&HWCAP2_SVE2))
+        cpuext.sve2 = 1;
+    #endif
     #ifdef HWCAP2_FRINT
     if(hwcap2&HWCAP2_FRINT)
         cpuext.frintts = 1;
@@ -184,12 +213,12 @@ int DetectHostCpuFeatures(void)
         cpuext.rndr = 1;
     #endif
 #elif defined(LA64)
+    uint32_t cpucfg2 = 0, idx = 2;
+    asm volatile("cpucfg %0, %1" : "=r"(cpucfg2) : "r"(idx));
+    if (((cpucfg2 >> 6) & 0b11) != 3) return 0; // LSX/LASX must present, xmm/ymm are always mapped to them
+
     char* p = GetEnv("BOX64_DYNAREC_LA64NOEXT");
     if(p == NULL || p[0] == '0') {
-        uint32_t cpucfg2 = 0, idx = 2;
-        asm volatile("cpucfg %0, %1" : "=r"(cpucfg2) : "r"(idx));
-        if (((cpucfg2 >> 6) & 0b11) != 3) return 0; // LSX/LASX must present
-
         cpuext.lbt = (cpucfg2 >> 18) & 0b1;
         cpuext.lam_bh = (cpucfg2 >> 27) & 0b1;
         cpuext.lamcas = (cpucfg2 >> 28) & 0b1;
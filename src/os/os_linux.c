@@ -10,6 +10,11 @@
 #include <stdarg.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <linux/userfaultfd.h>
 
 #include "os.h"
 #include "signals.h"
@@ -140,6 +145,103 @@ int IsAddrElfOrFileMapped(uintptr_t addr)
     return FindElfAddress(my_context, addr) || IsAddrFileMapped(addr, NULL, NULL);
 }
 
+#if defined(SYS_userfaultfd) && defined(UFFDIO_WRITEPROTECT) && defined(UFFD_FEATURE_EXACT_ADDRESS)
+static int uffd = -1;
+static void (*uffd_handler)(uintptr_t addr) = NULL;
+
+static void* UffdThread(void* arg)
+{
+    (void)arg;
+    struct uffd_msg msg;
+    while(1) {
+        ssize_t ret = read(uffd, &msg, sizeof(msg));
+        if(ret<0 && errno==EINTR)
+            continue;
+        if(ret!=sizeof(msg))
+            break;
+        if(msg.event!=UFFD_EVENT_PAGEFAULT)
+            continue;
+        uintptr_t addr = (uintptr_t)msg.arg.pagefault.address;
+        // the handler lifts the write-protection if needed, the writer will just fault again if not
+        uffd_handler(addr);
+        struct uffdio_range range = { .start = addr&~(box64_pagesize-1), .len = box64_pagesize };
+        ioctl(uffd, UFFDIO_WAKE, &range);
+    }
+    printf_log(LOG_INFO, "userfaultfd write tracker thread stopped (%s)\n", strerror(errno));
+    return NULL;
+}
+
+int InitUffdWriteTracker(void (*handler)(uintptr_t addr))
+{
+    // without privilege, only faults from user mode can be tracked (kernel writes will fail with EFAULT, like with mprotect)
+    int fd = syscall(SYS_userfaultfd, O_CLOEXEC);
+    #ifdef UFFD_USER_MODE_ONLY
+    if(fd<0)
+        fd = syscall(SYS_userfaultfd, O_CLOEXEC | UFFD_USER_MODE_ONLY);
+    #endif
+    if(fd<0) {
+        printf_log(LOG_INFO, "userfaultfd not available (%s)\n", strerror(errno));
+        return -1;
+    }
+    struct uffdio_api api = { .api = UFFD_API, .features = UFFD_FEATURE_PAGEFAULT_FLAG_WP | UFFD_FEATURE_EXACT_ADDRESS };
+    if(ioctl(fd, UFFDIO_API, &api)) {
+        printf_log(LOG_INFO, "userfaultfd write-protect not supported (%s)\n", strerror(errno));
+        close(fd);
+        return -1;
+    }
+    uffd = fd;
+    uffd_handler = handler;
+    // the tracker thread must never get signals from the guest
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    pthread_t thread;
+    int ret = pthread_create(&thread, NULL, UffdThread, NULL);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if(ret) {
+        CloseUffdWriteTracker();
+        return -1;
+    }
+    pthread_detach(thread);
+    return 0;
+}
+
+void CloseUffdWriteTracker(void)
+{
+    if(uffd>=0)
+        close(uffd);
+    uffd = -1;
+}
+
+int UffdWriteProtect(uintptr_t addr, size_t size, int protect)
+{
+    if(uffd<0)
+        return -1;
+    if(protect) {
+        // (re)registering a range already registered is cheap, and needed after a remap
+        struct uffdio_register reg = { .range = { .start = addr, .len = size }, .mode = UFFDIO_REGISTER_MODE_WP };
+        if(ioctl(uffd, UFFDIO_REGISTER, &reg) || !(reg.ioctls&(1ULL<<_UFFDIO_WRITEPROTECT)))
+            return -1;
+    }
+    struct uffdio_writeprotect wp = { .range = { .start = addr, .len = size }, .mode = protect?UFFDIO_WRITEPROTECT_MODE_WP:0 };
+    return ioctl(uffd, UFFDIO_WRITEPROTECT, &wp)?-1:0;
+}
+#else
+int InitUffdWriteTracker(void (*handler)(uintptr_t addr))
+{
+    return -1;
+}
+
+void CloseUffdWriteTracker(void)
+{
+}
+
+int UffdWriteProtect(uintptr_t addr, size_t size, int protect)
+{
+    return -1;
+}
+#endif
+
 void* InternalMmap(void* addr, unsigned long length, int prot, int flags, int fd, ssize_t offset)
 {
 #if 1 // def STATICBUILD
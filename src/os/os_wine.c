@@ -78,6 +78,20 @@ int IsAddrElfOrFileMapped(uintptr_t addr)
     return 0;
 }
 
+int InitUffdWriteTracker(void (*handler)(uintptr_t addr))
+{
+    return -1;
+}
+
+void CloseUffdWriteTracker(void)
+{
+}
+
+int UffdWriteProtect(uintptr_t addr, size_t size, int protect)
+{
+    return -1;
+}
+
 
 int IsNativeCall(uintptr_t addr, int is32bits, uintptr_t* calladdress, uint16_t* retn)
 {
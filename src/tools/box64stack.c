@@ -151,7 +151,9 @@ void SetupInitialStack(x64emu_t *emu)
     Push64(emu, 0); Push64(emu, 26);                        //AT_HWCAP2(26)=0
     Push64(emu, p_arg0); Push64(emu, 31);                   //AT_EXECFN(31)=p_arg0
     Push64(emu, emu->context->vsyscall); Push64(emu, 32);                         //AT_SYSINFO(32)=vsyscall
-    //Push64(emu, 0); Push64(emu, 33);                         //AT_SYSINFO_EHDR(33)=address of vDSO
+    if(CreateVDSO(emu->context)) {
+        Push64(emu, emu->context->vdso); Push64(emu, 33);   //AT_SYSINFO_EHDR(33)=address of vDSO
+    }
     if(!emu->context->auxval_start)       // store auxval start if needed
         emu->context->auxval_start = (uintptr_t*)R_RSP;
 
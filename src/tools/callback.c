@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdarg.h>
+#include <alloca.h>
 
 #include "debug.h"
 #include "x64emu.h"
@@ -85,10 +86,25 @@ uint64_t RunFunction(uintptr_t fnc, int nargs, ...)
     return ret;
 }
 
-EXPORTDYN
-uint64_t RunFunctionFmt(uintptr_t fnc, const char* fmt, ...)
+// Formats are parsed once into a callfmt_t, cached on the format pointer (all callers use string literals)
+typedef struct callfmt_s {
+    const char* fmt;
+    int         nargs;      // number of args on the stack (in slots), without alignment
+    uint8_t     slot[];     // 64bits only: where each arg goes, <CALLFMT_XMM: gpr, <CALLFMT_STACK: xmm, else stack
+} callfmt_t;
+#define CALLFMT_XMM     6
+#define CALLFMT_STACK   (CALLFMT_XMM+8)
+#define CALLFMT_CACHE   4096    // must be a power of 2
+
+static callfmt_t* callfmt_cache[CALLFMT_CACHE] = {0};
+
+static size_t CallFmtSize(const char* fmt)
+{
+    return sizeof(callfmt_t) + strlen(fmt);
+}
+
+static callfmt_t* ParseCallFmt(const char* fmt, callfmt_t* cf)
 {
-    x64emu_t *emu = thread_get_emu();
     int nargs = 0;
     int ni = 0;
     int ndf = 0;
@@ -99,16 +115,6 @@ uint64_t RunFunctionFmt(uintptr_t fnc, const char* fmt, ...)
                 case 'd': 
                 case 'I': 
                 case 'U': nargs+=2; break;
-                case 'p': 
-                case 'L': 
-                case 'l': 
-                case 'f': 
-                case 'i': 
-                case 'u': 
-                case 'w': 
-                case 'W': 
-                case 'c': 
-                case 'C': ++nargs; break;
                 default:
                     ++nargs; break;
             }
@@ -116,24 +122,42 @@ uint64_t RunFunctionFmt(uintptr_t fnc, const char* fmt, ...)
         #endif
         switch(fmt[i]) {
             case 'f': 
-            case 'd': if(ndf<8) ++ndf; else ++nargs; break;
-            case 'p': 
-            case 'i': 
-            case 'u': 
-            case 'I': 
-            case 'U': 
-            case 'L': 
-            case 'l': 
-            case 'w': 
-            case 'W': 
-            case 'c': 
-            case 'C': if(ni<6) ++ni; else ++nargs; break;
+            case 'd': if(ndf<8) cf->slot[i] = CALLFMT_XMM + ndf++; else cf->slot[i] = CALLFMT_STACK + nargs++; break;
             default:
-                if(ni<6) ++ni; else ++nargs; break;
+                if(ni<6) cf->slot[i] = ni++; else cf->slot[i] = CALLFMT_STACK + nargs++; break;
         }
     }
-    ni = 0;
-    ndf = 0;
+    cf->fmt = fmt;
+    cf->nargs = nargs;
+    return cf;
+}
+
+static const callfmt_t* GetCallFmt(const char* fmt)
+{
+    uint32_t idx = (uint32_t)(((uintptr_t)fmt*0x9E3779B97F4A7C15ULL)>>32)&(CALLFMT_CACHE-1);
+    callfmt_t* cf = NULL;
+    for(int i=0; i<CALLFMT_CACHE; ++i, idx=(idx+1)&(CALLFMT_CACHE-1)) {
+        callfmt_t* c = __atomic_load_n(&callfmt_cache[idx], __ATOMIC_ACQUIRE);
+        if(!c) {
+            if(!cf)
+                cf = ParseCallFmt(fmt, box_malloc(CallFmtSize(fmt)));
+            if(__atomic_compare_exchange_n(&callfmt_cache[idx], &c, cf, 0, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE))
+                return cf;
+        }
+        if(c->fmt==fmt) {
+            if(cf) box_free(cf);    // another thread was faster
+            return c;
+        }
+    }
+    if(cf) box_free(cf);
+    return NULL;    // cache full
+}
+
+// setup the stack frame and args for a call to a guest function, following a parsed format
+static void PrepareFmtCall(x64emu_t* emu, const callfmt_t* cf, va_list va)
+{
+    const char* fmt = cf->fmt;
+    int nargs = cf->nargs;
     int align = nargs&1;
     int stackn = align + nargs;
     int sizeof_ptr = sizeof(void*);
@@ -142,7 +166,6 @@ uint64_t RunFunctionFmt(uintptr_t fnc, const char* fmt, ...)
         Push_32(emu, R_EBP); // push ebp
         R_RBP = R_ESP;       // mov ebp, esp
         sizeof_ptr = sizeof(ptr_t);
-        align = (4-(nargs&3))&3;
     } else
     #endif
     {
@@ -157,8 +180,6 @@ uint64_t RunFunctionFmt(uintptr_t fnc, const char* fmt, ...)
         ptr_t *p = (ptr_t*)from_ptrv(R_ESP);
 
         #define GO(c, B, B2, N) case c: *((B*)p) = va_arg(va, B2); p+=N; break
-        va_list va;
-        va_start (va, fmt);
         for (int i=0; fmt[i]; ++i) {
             switch(fmt[i]) {
                 GO('f', float, double, 1);
@@ -182,57 +203,55 @@ uint64_t RunFunctionFmt(uintptr_t fnc, const char* fmt, ...)
             }
         }
         #undef GO
-        va_end (va);
     } else
     #endif
     {
         uint64_t *p = (uint64_t*)R_RSP;
 
         static const int nn[] = {_DI, _SI, _DX, _CX, _R8, _R9};
-        #define GO(c, A, B, B2, C) case c: if(ni<6) emu->regs[nn[ni++]].A[0] = C va_arg(va, B2); else {*p = 0; *((B*)p) = va_arg(va, B2); ++p;}; break;
-        va_list va;
-        va_start (va, fmt);
         for (int i=0; fmt[i]; ++i) {
+            uint64_t v;
             switch(fmt[i]) {
-                case 'f':   if(ndf<8)
-                                emu->xmm[ndf++].f[0] = va_arg(va, double);  // float are promoted to double in ...
-                            else {
-                                *p = 0;
-                                *((float*)p) = va_arg(va, double);
-                                ++p;
-                            }
-                            break;
-                case 'd':   if(ndf<8)
-                                emu->xmm[ndf++].d[0] = va_arg(va, double);
-                            else {
-                                *((double*)p) = va_arg(va, double);
-                                ++p;
-                            }
-                            break;
-                GO('p', q, void*, void*, (uintptr_t))
-                GO('i', sdword, int, int, )
-                GO('u', dword, uint32_t, uint32_t, )
-                GO('I', sq, int64_t, int64_t, )
-                GO('U', q, uint64_t, uint64_t, )
-                GO('L', q, uint64_t, uint64_t, )
-                GO('l', sq, int64_t, int64_t, )
-                GO('w', sword, int16_t, int, )
-                GO('W', word, uint16_t, int, )
-                GO('c', sbyte, int8_t, int, )
-                GO('C', byte, uint8_t, int, )
+                case 'f': { float f = va_arg(va, double); v = 0; memcpy(&v, &f, sizeof(f)); } break;   // float are promoted to double in ...
+                case 'd': { double d = va_arg(va, double); memcpy(&v, &d, sizeof(d)); } break;
+                case 'p': v = (uintptr_t)va_arg(va, void*); break;
+                case 'i': v = (uint32_t)va_arg(va, int); break;
+                case 'u': v = va_arg(va, uint32_t); break;
+                case 'I': v = va_arg(va, int64_t); break;
+                case 'U':
+                case 'L': v = va_arg(va, uint64_t); break;
+                case 'l': v = va_arg(va, int64_t); break;
+                case 'w': v = (uint16_t)va_arg(va, int); break;
+                case 'W': v = (uint16_t)va_arg(va, int); break;
+                case 'c': v = (uint8_t)va_arg(va, int); break;
+                case 'C': v = (uint8_t)va_arg(va, int); break;
                 default:
                     printf_log(LOG_NONE, "Error, unhandled arg %d: '%c' in RunFunctionFmt\n", i, fmt[i]);
-                    if(ni<6) emu->regs[nn[ni++]].q[0] = va_arg(va, uint64_t); else {*p = va_arg(va, uint64_t); ++p;}; 
+                    v = va_arg(va, uint64_t);
                     break;
             }
+            int slot = cf->slot[i];
+            if(slot<CALLFMT_XMM) {
+                // only the low part of the register is written, as before
+                switch(fmt[i]) {
+                    case 'i': case 'u': emu->regs[nn[slot]].dword[0] = v; break;
+                    case 'w': case 'W': emu->regs[nn[slot]].word[0] = v; break;
+                    case 'c': case 'C': emu->regs[nn[slot]].byte[0] = v; break;
+                    default: emu->regs[nn[slot]].q[0] = v; break;
+                }
+            } else if(slot<CALLFMT_STACK) {
+                if(fmt[i]=='f')
+                    emu->xmm[slot-CALLFMT_XMM].ud[0] = v;
+                else
+                    emu->xmm[slot-CALLFMT_XMM].q[0] = v;
+            } else
+                p[slot-CALLFMT_STACK] = v;
         }
-        #undef GO
-        va_end (va);
     }
+}
 
-    uintptr_t oldip = R_RIP;
-    DynaCall(emu, fnc);
-
+static void FinishFmtCall(x64emu_t* emu, uintptr_t oldip)
+{
     if(oldip==R_RIP) {
         #ifdef BOX32
         if(box64_is32bits) {
@@ -245,6 +264,25 @@ uint64_t RunFunctionFmt(uintptr_t fnc, const char* fmt, ...)
             R_RBP = Pop64(emu);     // pop rbp
         }
     }
+}
+
+#define RUN_FMT_CALL()                                                          \
+    const callfmt_t* cf = GetCallFmt(fmt);                                      \
+    if(!cf)                                                                     \
+        cf = ParseCallFmt(fmt, (callfmt_t*)alloca(CallFmtSize(fmt)));           \
+    va_list va;                                                                 \
+    va_start(va, fmt);                                                          \
+    PrepareFmtCall(emu, cf, va);                                                \
+    va_end(va);                                                                 \
+    uintptr_t oldip = R_RIP;                                                    \
+    DynaCall(emu, fnc);                                                         \
+    FinishFmtCall(emu, oldip)
+
+EXPORTDYN
+uint64_t RunFunctionFmt(uintptr_t fnc, const char* fmt, ...)
+{
+    x64emu_t *emu = thread_get_emu();
+    RUN_FMT_CALL();
 
     uint64_t ret = box64_is32bits?((uint64_t)R_EAX | ((uint64_t)R_EDX)<<32):R_RAX;
 
@@ -255,162 +293,8 @@ EXPORTDYN
 double RunFunctionFmtD(uintptr_t fnc, const char* fmt, ...)
 {
     x64emu_t *emu = thread_get_emu();
-    int nargs = 0;
-    int ni = 0;
-    int ndf = 0;
-    for (int i=0; fmt[i]; ++i) {
-        #ifdef BOX32
-        if(box64_is32bits)
-            switch(fmt[i]) {
-                case 'd': 
-                case 'I': 
-                case 'U': nargs+=2; break;
-                case 'p': 
-                case 'L': 
-                case 'l': 
-                case 'f': 
-                case 'i': 
-                case 'u': 
-                case 'w': 
-                case 'W': 
-                case 'c': 
-                case 'C': ++nargs; break;
-                default:
-                    ++nargs; break;
-            }
-        else
-        #endif
-        switch(fmt[i]) {
-            case 'f': 
-            case 'd': if(ndf<8) ++ndf; else ++nargs; break;
-            case 'p': 
-            case 'i': 
-            case 'u': 
-            case 'I': 
-            case 'U': 
-            case 'L': 
-            case 'l': 
-            case 'w': 
-            case 'W': 
-            case 'c': 
-            case 'C': if(ni<6) ++ni; else ++nargs; break;
-            default:
-                if(ni<6) ++ni; else ++nargs; break;
-        }
-    }
-    ni = 0;
-    ndf = 0;
-    int align = nargs&1;
-    int stackn = align + nargs;
-    int sizeof_ptr = sizeof(void*);
-    #ifdef BOX32
-    if(box64_is32bits) {
-        Push_32(emu, R_EBP); // push ebp
-        R_RBP = R_ESP;       // mov ebp, esp
-        sizeof_ptr = sizeof(ptr_t);
-        align = (4-(nargs&3))&3;
-    } else
-    #endif
-    {
-        Push64(emu, R_RBP); // push rbp
-        R_RBP = R_RSP;      // mov rbp, rsp
-    }
-
-    R_RSP -= stackn*sizeof_ptr;   // need to push in reverse order
-
-    #ifdef BOX32
-    if(box64_is32bits) {
-        ptr_t *p = (ptr_t*)from_ptrv(R_ESP);
-
-        #define GO(c, B, B2, N) case c: *((B*)p) = va_arg(va, B2); p+=N; break
-        va_list va;
-        va_start (va, fmt);
-        for (int i=0; fmt[i]; ++i) {
-            switch(fmt[i]) {
-                GO('f', float, double, 1);
-                GO('d', double, double, 2);
-                case 'p': *((ptr_t*)p) = to_ptrv(va_arg(va, void*)); p+=1; break;
-                GO('i', int, int, 1);
-                GO('u', uint32_t, uint32_t, 1);
-                GO('I', int64_t, int64_t, 2);
-                GO('U', uint64_t, uint64_t, 2);
-                GO('L', uint32_t, uint64_t, 1);     // long are 64bits on 64bits system
-                GO('l', int32_t, int64_t, 1);       // but 32bits on 32bits system
-                GO('w', int16_t, int, 1);
-                GO('W', uint16_t, int, 1);
-                GO('c', int8_t, int, 1);
-                GO('C', uint8_t, int, 1);
-                default:
-                    printf_log(LOG_NONE, "Error, unhandled arg %d: '%c' in RunFunctionFmt\n", i, fmt[i]);
-                    *p = va_arg(va, uint32_t);
-                    ++p; 
-                    break;
-            }
-        }
-        #undef GO
-        va_end (va);
-    } else
-    #endif
-    {
-        uint64_t *p = (uint64_t*)R_RSP;
+    RUN_FMT_CALL();
 
-        static const int nn[] = {_DI, _SI, _DX, _CX, _R8, _R9};
-        #define GO(c, A, B, B2, C) case c: if(ni<6) emu->regs[nn[ni++]].A[0] = C va_arg(va, B2); else {*p = 0; *((B*)p) = va_arg(va, B2); ++p;}; break;
-        va_list va;
-        va_start (va, fmt);
-        for (int i=0; fmt[i]; ++i) {
-            switch(fmt[i]) {
-                case 'f':   if(ndf<8)
-                                emu->xmm[ndf++].f[0] = va_arg(va, double);  // float are promoted to double in ...
-                            else {
-                                *p = 0;
-                                *((float*)p) = va_arg(va, double);
-                                ++p;
-                            }
-                            break;
-                case 'd':   if(ndf<8)
-                                emu->xmm[ndf++].d[0] = va_arg(va, double);
-                            else {
-                                *((double*)p) = va_arg(va, double);
-                                ++p;
-                            }
-                            break;
-                GO('p', q, void*, void*, (uintptr_t))
-                GO('i', sdword, int, int, )
-                GO('u', dword, uint32_t, uint32_t, )
-                GO('I', sq, int64_t, int64_t, )
-                GO('U', q, uint64_t, uint64_t, )
-                GO('L', q, uint64_t, uint64_t, )
-                GO('l', sq, int64_t, int64_t, )
-                GO('w', sword, int16_t, int, )
-                GO('W', word, uint16_t, int, )
-                GO('c', sbyte, int8_t, int, )
-                GO('C', byte, uint8_t, int, )
-                default:
-                    printf_log(LOG_NONE, "Error, unhandled arg %d: '%c' in RunFunctionFmt\n", i, fmt[i]);
-                    if(ni<6) emu->regs[nn[ni++]].q[0] = va_arg(va, uint64_t); else {*p = va_arg(va, uint64_t); ++p;}; 
-                    break;
-            }
-        }
-        #undef GO
-        va_end (va);
-    }
-
-    uintptr_t oldip = R_RIP;
-    DynaCall(emu, fnc);
-
-    if(oldip==R_RIP) {
-        #ifdef BOX32
-        if(box64_is32bits) {
-            R_RSP = R_EBP;          // mov esp, ebp
-            R_RBP = Pop_32(emu);    // pop ebp
-        } else
-        #endif
-        {
-            R_RSP = R_RBP;          // mov rsp, rbp
-            R_RBP = Pop64(emu);     // pop rbp
-        }
-    }
     double ret;
     #ifdef BOX32
     if(box64_is32bits) {
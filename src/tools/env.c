@@ -154,7 +154,6 @@ static void applyCustomRules()
 
 #ifndef _WIN32
     if(box64env.is_cycle_log_overridden) {
-        freeCycleLog(my_context);
         box64env.rolling_log = BOX64ENV(cycle_log);
 
         if (BOX64ENV(rolling_log) == 1) {
@@ -163,7 +162,6 @@ static void applyCustomRules()
         if (BOX64ENV(rolling_log) && BOX64ENV(log) > LOG_INFO) {
             box64env.rolling_log = 0;
         }
-        initCycleLog(my_context);
     }
 
     if (box64env.is_dynarec_gdbjit_str_overridden) {
@@ -753,7 +751,6 @@ void RecordEnvMappings(uintptr_t addr, size_t length, int fd)
 #endif
 }
 
-#ifdef DYNAREC
 const char* GetDynacacheFolder(mapping_t* mapping)
 {
     static char folder[4096] = { 0 };
@@ -792,6 +789,7 @@ done:
     return folder;
 }
 
+#ifdef DYNAREC
 /*
     There is 3 version to change when evoling things, depending on what is changed:
     1. FILE_VERSION for the DynaCache infrastructure
@@ -803,7 +801,7 @@ done:
     `box64 --dynacache-clean` can be used from command line to purge obsolete DyaCache files
 */
 
-#define FILE_VERSION               2
+#define FILE_VERSION               3
 #define HEADER_SIGN "DynaCache"
 #define SET_VERSION(MAJ, MIN, REV) (((MAJ)<<24)|((MIN)<<16)|(REV))
 #ifdef ARM64
@@ -815,7 +813,7 @@ done:
 #else
 #error meh!
 #endif
-#define DYNAREC_VERSION SET_VERSION(0, 0, 3)
+#define DYNAREC_VERSION SET_VERSION(0, 0, 6)
 
 typedef struct DynaCacheHeader_s {
     char sign[10];  //"DynaCache\0"
@@ -849,6 +847,8 @@ typedef struct DynaCacheHeader_s {
     DS_GO(BOX64_DYNAREC_NATIVEFLAGS, dynarec_nativeflags, 1)            \
     DS_GO(BOX64_DYNAREC_SAFEFLAGS, dynarec_safeflags, 2)                \
     DS_GO(BOX64_DYNAREC_STRONGMEM, dynarec_strongmem, 2)                \
+    DS_GO(BOX64_DYNAREC_STRONGMEM_MT, dynarec_strongmem_mt, 1)          \
+    DS_GO(BOX64_DYNAREC_SVE, dynarec_sve, 1)                            \
     DS_GO(BOX64_DYNAREC_VOLATILE_METADATA, dynarec_volatile_metadata, 1)\
     DS_GO(BOX64_DYNAREC_WEAKBARRIER, dynarec_weakbarrier, 2)            \
     DS_GO(BOX64_DYNAREC_X87DOUBLE, dynarec_x87double, 2)                \
@@ -34,18 +34,27 @@ static char* ResolveFileInner(const char* filename, path_collection_t* paths, in
     if(filename[0]=='/') {
         return ResolvePathInner(filename, resolve_symlink);
     }
-    for (int i=0; i<paths->size; ++i) {
-        if(paths->paths[i][0]!='/') {
-            // not an absolute path...
-            if(!getcwd(p, sizeof(p))) return NULL;
-            if(p[strlen(p)-1]!='/')
-                strcat(p, "/");
-            strcat(p, paths->paths[i]);
-        } else
-            strcpy(p, paths->paths[i]);
-        strcat(p, filename);
-        if(FileExist(p, IS_FILE)) {
-            return ResolvePathInner(p, resolve_symlink);
+    // 2nd pass only on the folders that changed since they were indexed
+    for (int pass=0; pass<2; ++pass) {
+        for (int i=0; i<paths->size; ++i) {
+            if(paths->paths[i][0]!='/') {
+                if(pass) continue;
+                // not an absolute path...
+                if(!getcwd(p, sizeof(p))) return NULL;
+                if(p[strlen(p)-1]!='/')
+                    strcat(p, "/");
+                strcat(p, paths->paths[i]);
+            } else {
+                if(pass && !RefreshFolderIndex(paths->paths[i]))
+                    continue;
+                if(!FolderMayHave(paths->paths[i], filename))
+                    continue;
+                strcpy(p, paths->paths[i]);
+            }
+            strcat(p, filename);
+            if(FileExist(p, IS_FILE)) {
+                return ResolvePathInner(p, resolve_symlink);
+            }
         }
     }
 
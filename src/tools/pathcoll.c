@@ -3,6 +3,12 @@
 #include <string.h>
 #include <limits.h>
 #include <stdint.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
 
 #ifndef MAX_PATH
 #define MAX_PATH 4096
@@ -10,6 +16,8 @@
 
 #include "debug.h"
 #include "pathcoll.h"
+#include "env.h"
+#include "khash.h"
 
 void FreeCollection(path_collection_t* collection)
 {
@@ -180,3 +188,128 @@ int FindInCollection(const char* path, path_collection_t* collection)
             return 1;
     return 0;
 }
+
+// Folder index: the content of each folder is read once (like ld.so.cache), so searching a collection
+// for a library doesn't need to stat/open a candidate in every folder
+KHASH_SET_INIT_STR(foldernames)
+typedef struct folder_index_s {
+    int                 exist;
+    int                 noindex;    // folder cannot be listed, or is case-insensitive: names need to be checked directly
+    struct timespec     mtime;
+    kh_foldernames_t*   names;
+} folder_index_t;
+KHASH_MAP_INIT_STR(folderindex, folder_index_t*)
+
+static kh_folderindex_t* folder_index = NULL;
+static pthread_mutex_t folder_index_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void clearFolderIndex(folder_index_t* idx)
+{
+    const char* name;
+    kh_foreach_key(idx->names, name, box_free((char*)name));
+    kh_clear(foldernames, idx->names);
+}
+
+#ifndef FS_CASEFOLD_FL
+#define FS_CASEFOLD_FL  0x40000000
+#endif
+// a listing from a case-insensitive folder cannot be used to tell a name is absent
+static int folderCaseInsensitive(DIR* dir)
+{
+    int fd = dirfd(dir);
+    int flags = 0;
+    if(!ioctl(fd, FS_IOC_GETFLAGS, &flags) && (flags&FS_CASEFOLD_FL))
+        return 1;   // ext4 / f2fs casefold folder
+    struct statfs sfs;
+    if(fstatfs(fd, &sfs))
+        return 1;
+    switch((uint32_t)sfs.f_type) {
+        case 0x4d44:        // vfat / msdos
+        case 0x2011BAB0:    // exfat
+        case 0x5346544e:    // ntfs
+        case 0x7366746e:    // ntfs3
+        case 0x65735546:    // fuse (Android sdcard, ciopfs...)
+        case 0x5DCA2DF5:    // sdcardfs
+        case 0x482b:        // hfs+
+        case 0xFF534D42:    // cifs
+        case 0xFE534D42:    // smb2
+        case 0x517B:        // smb
+            return 1;
+    }
+    return 0;
+}
+
+static void readFolderIndex(folder_index_t* idx, const char* folder, struct stat* st)
+{
+    clearFolderIndex(idx);
+    idx->exist = st?1:0;
+    idx->noindex = 0;
+    if(!st)
+        return;
+    idx->mtime = st->st_mtim;
+    DIR* dir = opendir(folder);
+    if(!dir) {
+        // a search only (--x) folder can still have the file
+        idx->noindex = 1;
+        return;
+    }
+    if(folderCaseInsensitive(dir)) {
+        idx->noindex = 1;
+        closedir(dir);
+        return;
+    }
+    struct dirent* d;
+    int ret;
+    while((d = readdir(dir))) {
+        khint_t k = kh_put(foldernames, idx->names, d->d_name, &ret);
+        if(ret)
+            kh_key(idx->names, k) = box_strdup(d->d_name);
+    }
+    closedir(dir);
+}
+
+static folder_index_t* getFolderIndex(const char* folder)
+{
+    if(!folder_index)
+        folder_index = kh_init(folderindex);
+    khint_t k = kh_get(folderindex, folder_index, folder);
+    if(k!=kh_end(folder_index))
+        return kh_value(folder_index, k);
+    folder_index_t* idx = box_calloc(1, sizeof(folder_index_t));
+    idx->names = kh_init(foldernames);
+    struct stat st;
+    readFolderIndex(idx, folder, stat(folder, &st)?NULL:&st);
+    int ret;
+    k = kh_put(folderindex, folder_index, box_strdup(folder), &ret);
+    kh_value(folder_index, k) = idx;
+    return idx;
+}
+
+int FolderMayHave(const char* folder, const char* name)
+{
+    // relative folders depend on cwd, and names with a '/' are not in the listing
+    if(!BOX64ENV(libpath_index) || folder[0]!='/' || strchr(name, '/'))
+        return 1;
+    pthread_mutex_lock(&folder_index_mutex);
+    folder_index_t* idx = getFolderIndex(folder);
+    int ret = idx->exist && (idx->noindex || kh_get(foldernames, idx->names, name)!=kh_end(idx->names));
+    pthread_mutex_unlock(&folder_index_mutex);
+    return ret;
+}
+
+int RefreshFolderIndex(const char* folder)
+{
+    if(BOX64ENV(libpath_index)!=1 || folder[0]!='/')
+        return 0;
+    struct stat st;
+    int exist = !stat(folder, &st);
+    int changed = 0;
+    pthread_mutex_lock(&folder_index_mutex);
+    folder_index_t* idx = getFolderIndex(folder);
+    if(exist!=idx->exist || (exist && (st.st_mtim.tv_sec!=idx->mtime.tv_sec || st.st_mtim.tv_nsec!=idx->mtime.tv_nsec))) {
+        readFolderIndex(idx, folder, exist?&st:NULL);
+        changed = 1;
+    }
+    pthread_mutex_unlock(&folder_index_mutex);
+    return changed;
+}
@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "os.h"
+#include "debug.h"
+#include "freq.h"
+#include "box64context.h"
+#include "rollinglog.h"
+
+// Each thread gets its own ring, written without lock nor text formatting. An entry has its seq set to 0 while
+// being written, so a dump running at the same time (from a signal handler or another thread) skips it.
+// Rings are never freed (so the last calls of exited threads stay), and are merged by timestamp when dumped.
+
+typedef struct rlog_ring_s {
+    struct rlog_ring_s* next;
+    uint64_t            head;   // seq of the last written entry
+    uint64_t            dump;   // cursors used by print_rolling_log
+    uint64_t            dump_end;
+    int                 size;
+    int                 tid;
+    rlog_entry_t        entries[];
+} rlog_ring_t;
+
+static rlog_ring_t* rlog_list = NULL;
+static __thread rlog_ring_t* thread_ring = NULL;
+static int rlog_dumping = 0;
+
+static rlog_ring_t* GetThreadRing(void)
+{
+    int size = BOX64ENV(rolling_log);
+    // a new ring is needed if BOX64_ROLLING_LOG changed (per-program rcfile settings)
+    if(thread_ring && thread_ring->size==size)
+        return thread_ring;
+    if(!size)
+        return NULL;
+    // might be called from a signal handler, so no malloc here
+    rlog_ring_t* r = InternalMmap(NULL, sizeof(rlog_ring_t)+size*sizeof(rlog_entry_t), PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if(r==MAP_FAILED || !r)
+        return NULL;
+    r->size = size;
+    r->tid = GetTID();
+    rlog_ring_t* head = __atomic_load_n(&rlog_list, __ATOMIC_ACQUIRE);
+    do {
+        r->next = head;
+    } while(!__atomic_compare_exchange_n(&rlog_list, &head, r, 0, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+    thread_ring = r;
+    return r;
+}
+
+uint64_t RollingLogCall(rlog_type_t type, uintptr_t rip, uintptr_t fnc, const char* name, uint64_t a0, uint64_t a1, uint64_t a2, uint64_t a3, uint64_t a4, uint64_t a5)
+{
+    rlog_ring_t* r = GetThreadRing();
+    if(!r)
+        return 0;
+    uint64_t seq = r->head+1;
+    rlog_entry_t* e = &r->entries[(seq-1)%r->size];
+    __atomic_store_n(&e->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    e->ts = ReadTSC(NULL);
+    e->rip = rip;
+    e->fnc = fnc;
+    e->name = name;
+    e->args[0] = a0;
+    e->args[1] = a1;
+    e->args[2] = a2;
+    e->args[3] = a3;
+    e->args[4] = a4;
+    e->args[5] = a5;
+    e->ret = 0;
+    e->type = type;
+    e->has_ret = 0;
+    __atomic_store_n(&e->seq, seq, __ATOMIC_RELEASE);
+    __atomic_store_n(&r->head, seq, __ATOMIC_RELEASE);
+    return seq;
+}
+
+void RollingLogRet(uint64_t id, uint64_t ret)
+{
+    rlog_ring_t* r = thread_ring;
+    if(!id || !r)
+        return;
+    rlog_entry_t* e = &r->entries[(id-1)%r->size];
+    if(__atomic_load_n(&e->seq, __ATOMIC_RELAXED)!=id)
+        return; // already overwritten (the call did a lot of callbacks)
+    e->ret = ret;
+    __atomic_store_n(&e->has_ret, 1, __ATOMIC_RELEASE);
+}
+
+// copy entry seq of a ring, return 0 if it's being (or has been) overwritten
+static int GetEntry(rlog_ring_t* r, uint64_t seq, rlog_entry_t* out)
+{
+    rlog_entry_t* e = &r->entries[(seq-1)%r->size];
+    if(__atomic_load_n(&e->seq, __ATOMIC_ACQUIRE)!=seq)
+        return 0;
+    memcpy(out, e, sizeof(*out));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&e->seq, __ATOMIC_RELAXED)==seq;
+}
+
+static void PrintEntry(int loglevel, int tid, rlog_entry_t* e, uint64_t last, uint64_t freq)
+{
+    char ret[64];
+    if(e->has_ret)
+        snprintf(ret, sizeof(ret), "return 0x%lX", (unsigned long)e->ret);
+    else
+        snprintf(ret, sizeof(ret), "(no return)");
+    double ms = (freq && last>e->ts)?((double)(last-e->ts)*1000./(double)freq):0.;
+    const char* name = e->name;
+    if(!name && (e->type==RLOG_CALL || e->type==RLOG_CALL32))
+        name = GetNativeName((void*)e->fnc);
+    switch(e->type) {
+        case RLOG_CALL:
+            printf_log(loglevel, "[-%9.3fms] %04d|%p: Calling %s(0x%lX, 0x%lX, 0x%lX, 0x%lX, 0x%lX, 0x%lX) => %s\n", ms, tid, (void*)e->rip, name,
+                e->args[0], e->args[1], e->args[2], e->args[3], e->args[4], e->args[5], ret);
+            break;
+        case RLOG_CALL32:
+            printf_log(loglevel, "[-%9.3fms] %04d|%p: Calling %s (%08X, %08X, %08X...) => %s\n", ms, tid, (void*)e->rip, name,
+                (uint32_t)e->args[0], (uint32_t)e->args[1], (uint32_t)e->args[2], ret);
+            break;
+        case RLOG_PLT:
+        case RLOG_PLT32:
+            printf_log(loglevel, "[-%9.3fms] %04d|%p: PltResolver \"%s\" => %s\n", ms, tid, (void*)e->rip, name?name:"???", ret);
+            break;
+        case RLOG_SYSCALL:
+            printf_log(loglevel, "[-%9.3fms] %04d|%p: Calling syscall 0x%02X (%d) %p %p %p %p %p %p => %s\n", ms, tid, (void*)e->rip, (int)e->fnc, (int)e->fnc,
+                (void*)e->args[0], (void*)e->args[1], (void*)e->args[2], (void*)e->args[3], (void*)e->args[4], (void*)e->args[5], ret);
+            break;
+        default:
+            break;
+    }
+}
+
+void print_rolling_log(int loglevel)
+{
+    if(!BOX64ENV(rolling_log) || loglevel>BOX64ENV(log))
+        return;
+    if(__atomic_exchange_n(&rlog_dumping, 1, __ATOMIC_ACQUIRE))
+        return; // already dumping
+    printf_log(loglevel, "Last calls\n");
+    // set the cursors on the oldest entry of each ring (entries written during the dump are ignored),
+    // and find the most recent timestamp
+    // rings created during the dump are added in front of the list and are ignored too
+    rlog_ring_t* list = __atomic_load_n(&rlog_list, __ATOMIC_ACQUIRE);
+    uint64_t last = 0;
+    rlog_entry_t e;
+    for(rlog_ring_t* r = list; r; r = r->next) {
+        uint64_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+        r->dump = (head>(uint64_t)r->size)?(head-r->size+1):1;
+        r->dump_end = head;
+        if(head && GetEntry(r, head, &e) && e.ts>last)
+            last = e.ts;
+    }
+    uint64_t freq = ReadTSCFrequency(NULL);
+    // merge the rings by timestamp
+    while(1) {
+        rlog_ring_t* best = NULL;
+        rlog_entry_t best_e;
+        for(rlog_ring_t* r = list; r; r = r->next) {
+            // skip the entries overwritten since the dump started
+            while(r->dump<=r->dump_end && !GetEntry(r, r->dump, &e))
+                ++r->dump;
+            if(r->dump>r->dump_end)
+                continue;
+            if(!best || e.ts<best_e.ts) {
+                best = r;
+                best_e = e;
+            }
+        }
+        if(!best)
+            break;
+        ++best->dump;
+        PrintEntry(loglevel, best->tid, &best_e, last, freq);
+    }
+    __atomic_store_n(&rlog_dumping, 0, __ATOMIC_RELEASE);
+}
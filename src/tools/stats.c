@@ -0,0 +1,266 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#endif
+
+#include "os.h"
+#include "debug.h"
+#include "freq.h"
+#include "stats.h"
+#include "box64context.h"
+
+// Each thread gets its own slot, so counting is just an increment without any atomic.
+// Slots are never freed (so counts of exited threads stay) and are only aggregated on demand by DumpStats
+// On wow64, there is no TLS, so all threads share the same slot and counts are only approximate
+
+static stats_t* stats_list = NULL;
+static stats_t stats_fallback = {0};   // if a slot cannot be allocated
+static uint64_t stats_freq = 0;
+#ifndef _WIN32
+static __thread stats_t* thread_stats = NULL;
+#else
+static stats_t* thread_stats = NULL;
+#endif
+
+stats_t* GetThreadStats(void)
+{
+    if(thread_stats)
+        return thread_stats;
+    // might be called from a signal handler, so no malloc here
+    stats_t* s = InternalMmap(NULL, sizeof(stats_t), PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if(s==MAP_FAILED || !s)
+        return &stats_fallback;
+    stats_t* head = __atomic_load_n(&stats_list, __ATOMIC_ACQUIRE);
+    do {
+        s->next = head;
+    } while(!__atomic_compare_exchange_n(&stats_list, &head, s, 0, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+    thread_stats = s;
+    return s;
+}
+
+uint64_t StatsTicks(void)
+{
+    return ReadTSC(NULL);
+}
+
+void StatsWrapper(uintptr_t fnc)
+{
+    if(!BOX64ENV(stats))
+        return;
+    stats_t* s = GetThreadStats();
+    uint32_t idx = (uint32_t)(((fnc>>2)*0x9E3779B97F4A7C15ULL)>>32)%STATS_WRAPPERS;
+    for(int i=0; i<STATS_WRAPPERS; ++i, idx=(idx+1)%STATS_WRAPPERS) {
+        if(s->wrapper_fnc[idx]==fnc) {
+            ++s->wrapper_cnt[idx];
+            return;
+        }
+        if(!s->wrapper_fnc[idx]) {
+            s->wrapper_cnt[idx] = 1;
+            s->wrapper_fnc[idx] = fnc;
+            return;
+        }
+    }
+    ++s->wrapper_other;
+}
+
+void StatsSyscall(uint32_t n, int is32bits)
+{
+    if(!BOX64ENV(stats))
+        return;
+    stats_t* s = GetThreadStats();
+    if(n<STATS_SYSCALLS)
+        ++s->syscall[is32bits?1:0][n];
+    else
+        ++s->syscall_other;
+}
+
+#ifndef _WIN32
+// the dump is not async-signal-safe (stdio, locks...): the signal handler only wakes a dumper thread through a pipe
+static int stats_pipe[2] = {-1, -1};
+static void stats_sighandler(int sig)
+{
+    (void)sig;
+    int olderr = errno;
+    char c = 0;
+    (void)!write(stats_pipe[1], &c, 1);
+    errno = olderr;
+}
+static void* stats_dumper(void* arg)
+{
+    (void)arg;
+    char c;
+    while(1) {
+        ssize_t r = read(stats_pipe[0], &c, 1);
+        if(r<0 && errno==EINTR)
+            continue;
+        if(r<=0)
+            break;
+        DumpStats(1);
+        print_rolling_log(LOG_NONE);
+    }
+    return NULL;
+}
+#endif
+
+void InitStats(void)
+{
+    if(!BOX64ENV(stats))
+        return;
+    stats_freq = ReadTSCFrequency(NULL);
+    #ifndef _WIN32
+    if(BOX64ENV(stats)==2) {
+        pthread_t thread;
+        if(pipe(stats_pipe) || pthread_create(&thread, NULL, stats_dumper, NULL)) {
+            printf_log(LOG_INFO, "Cannot create the statistics dump thread, SIGUSR2 dump disabled\n");
+            return;
+        }
+        pthread_detach(thread);
+        fcntl(stats_pipe[0], F_SETFD, FD_CLOEXEC);
+        fcntl(stats_pipe[1], F_SETFD, FD_CLOEXEC);
+        struct sigaction action = {0};
+        action.sa_flags = SA_RESTART;
+        action.sa_handler = stats_sighandler;
+        sigaction(SIGUSR2, &action, NULL);
+        printf_log(LOG_INFO, "Send SIGUSR2 to pid %d to dump runtime statistics\n", getpid());
+    }
+    #endif
+}
+
+// aggregated values, static so a dump from a signal handler doesn't need to allocate anything
+#define STATS_MERGED    4096
+static stats_t stats_total;
+static uintptr_t merged_fnc[STATS_MERGED];
+static uint64_t merged_cnt[STATS_MERGED];
+static int stats_dumping = 0;
+
+static const char* stats_names[STAT_LAST] = {
+    "Dynablocks created",
+    "Dynablocks invalidated",
+    "Dynablocks freed",
+    "Dynablocks switched",
+    "LinkNext misses",
+    "Hotpage hits",
+    "SMC SIGSEGV",
+    "SIGBUS fixed",
+    "FillBlock64 ticks",
+};
+
+static void stats_print(int fd, const char* fmt, ...)
+{
+    char buff[256];
+    va_list va;
+    va_start(va, fmt);
+    int n = vsnprintf(buff, sizeof(buff), fmt, va);
+    va_end(va);
+    if(n<=0)
+        return;
+    if(n>(int)sizeof(buff)-1)
+        n = sizeof(buff)-1;
+    #ifndef _WIN32
+    (void)!write(fd, buff, n);
+    #else
+    printf_log(LOG_NONE, "%s", buff);
+    #endif
+}
+
+void DumpStats(int from_signal)
+{
+    if(__atomic_exchange_n(&stats_dumping, 1, __ATOMIC_ACQUIRE))
+        return; // already dumping
+    memset(&stats_total, 0, sizeof(stats_total));
+    memset(merged_fnc, 0, sizeof(merged_fnc));
+    memset(merged_cnt, 0, sizeof(merged_cnt));
+    int nthreads = 0;
+    int nmerged = 0;
+    for(stats_t* s = __atomic_load_n(&stats_list, __ATOMIC_ACQUIRE); s; s = s->next) {
+        ++nthreads;
+        for(int i=0; i<STAT_LAST; ++i)
+            stats_total.counter[i] += s->counter[i];
+        for(int i=0; i<STATS_SYSCALLS; ++i) {
+            stats_total.syscall[0][i] += s->syscall[0][i];
+            stats_total.syscall[1][i] += s->syscall[1][i];
+        }
+        stats_total.syscall_other += s->syscall_other;
+        stats_total.wrapper_other += s->wrapper_other;
+        for(int i=0; i<STATS_WRAPPERS; ++i) {
+            uintptr_t fnc = s->wrapper_fnc[i];
+            if(!fnc)
+                continue;
+            uint32_t idx = (uint32_t)(((fnc>>2)*0x9E3779B97F4A7C15ULL)>>32)%STATS_MERGED;
+            int j;
+            for(j=0; j<STATS_MERGED && merged_fnc[idx] && merged_fnc[idx]!=fnc; ++j)
+                idx = (idx+1)%STATS_MERGED;
+            if(j==STATS_MERGED) {
+                stats_total.wrapper_other += s->wrapper_cnt[i];
+                continue;
+            }
+            if(!merged_fnc[idx])
+                ++nmerged;
+            merged_fnc[idx] = fnc;
+            merged_cnt[idx] += s->wrapper_cnt[i];
+        }
+    }
+    // compact and sort the wrappers by count
+    int n = 0;
+    for(int i=0; i<STATS_MERGED; ++i)
+        if(merged_fnc[i]) {
+            merged_fnc[n] = merged_fnc[i];
+            merged_cnt[n] = merged_cnt[i];
+            ++n;
+        }
+    for(int i=1; i<n; ++i) {
+        uintptr_t f = merged_fnc[i];
+        uint64_t c = merged_cnt[i];
+        int j = i;
+        for(; j && merged_cnt[j-1]<c; --j) {
+            merged_fnc[j] = merged_fnc[j-1];
+            merged_cnt[j] = merged_cnt[j-1];
+        }
+        merged_fnc[j] = f;
+        merged_cnt[j] = c;
+    }
+
+    int fd = 2;
+    int pid = 0;
+    #ifndef _WIN32
+    pid = getpid();
+    if(BOX64ENV(stats_file)) {
+        fd = open(BOX64ENV(stats_file), O_WRONLY|O_CREAT|O_APPEND|O_CLOEXEC, 0644);
+        if(fd<0)
+            fd = 2;
+    }
+    #endif
+    stats_print(fd, "BOX64 Statistics for pid %d (%d threads)%s\n", pid, nthreads, from_signal?" on signal":"");
+    for(int i=0; i<STAT_LAST; ++i)
+        stats_print(fd, "  %-24s %llu\n", stats_names[i], (unsigned long long)stats_total.counter[i]);
+    if(stats_freq)
+        stats_print(fd, "  %-24s %.3f ms\n", "FillBlock64 time", (double)stats_total.counter[STAT_FILLBLOCK_TICKS]*1000./(double)stats_freq);
+    stats_print(fd, "Syscalls:\n");
+    for(int b=0; b<2; ++b)
+        for(int i=0; i<STATS_SYSCALLS; ++i)
+            if(stats_total.syscall[b][i])
+                stats_print(fd, "  %s%-6d %llu\n", b?"32bits ":"", i, (unsigned long long)stats_total.syscall[b][i]);
+    if(stats_total.syscall_other)
+        stats_print(fd, "  others %llu\n", (unsigned long long)stats_total.syscall_other);
+    stats_print(fd, "Native calls (%d wrapped functions):\n", nmerged);
+    for(int i=0; i<n; ++i)
+        if(from_signal)
+            stats_print(fd, "  %p %llu\n", (void*)merged_fnc[i], (unsigned long long)merged_cnt[i]);
+        else
+            stats_print(fd, "  %-40s %llu\n", GetNativeName((void*)merged_fnc[i]), (unsigned long long)merged_cnt[i]);
+    if(stats_total.wrapper_other)
+        stats_print(fd, "  others %llu\n", (unsigned long long)stats_total.wrapper_other);
+    #ifndef _WIN32
+    if(fd!=2)
+        close(fd);
+    #endif
+    __atomic_store_n(&stats_dumping, 0, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,225 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stddef.h>
+#include <time.h>
+#include <sched.h>
+#include <elf.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "os.h"
+#include "debug.h"
+#include "env.h"
+#include "box64context.h"
+#include "box64stack.h"
+#include "custommem.h"
+#include "x64emu.h"
+#include "wrapper.h"
+#include "bridge_private.h"
+
+/*
+    Emulated vDSO: a small x86_64 ELF image, advertised with AT_SYSINFO_EHDR, that exports the usual __vdso_* symbols.
+    Each entry is a bridge to the native function (that will use the host vDSO), so an emulated libc (static binaries,
+    Go programs...) calls them like a native function instead of doing a real SYSCALL.
+    The image mimics the kernel one: linked at 0, with DT_HASH, and versions (LINUX_2.6) in DT_VERSYM/DT_VERDEF.
+*/
+
+// the vDSO functions return -errno on failure, not -1 with errno set like the libc ones
+static int vdso_clock_gettime(clockid_t clk, struct timespec* ts)
+{
+    int ret = clock_gettime(clk, ts);
+    return (ret<0)?-errno:ret;
+}
+static int vdso_gettimeofday(struct timeval* tv, void* tz)
+{
+    int ret = gettimeofday(tv, tz);
+    return (ret<0)?-errno:ret;
+}
+static int vdso_clock_getres(clockid_t clk, struct timespec* res)
+{
+    int ret = clock_getres(clk, res);
+    return (ret<0)?-errno:ret;
+}
+static int vdso_getcpu(unsigned* cpu, unsigned* node, void* unused)
+{
+    (void)unused;
+    if(node) {
+        int ret = syscall(__NR_getcpu, cpu, node, NULL);
+        return (ret<0)?-errno:ret;
+    }
+    int ret = sched_getcpu();
+    if(ret<0)
+        return -errno;
+    if(cpu)
+        *cpu = ret;
+    return 0;
+}
+
+typedef struct vdso_fnc_s {
+    const char* name;
+    wrapper_t   w;
+    void*       f;
+} vdso_fnc_t;
+
+static const vdso_fnc_t vdso_fncs[] = {
+    {"clock_gettime", iFip, vdso_clock_gettime},
+    {"gettimeofday", iFpp, vdso_gettimeofday},
+    {"time", lFp, time},
+    {"getcpu", iFppp, vdso_getcpu},
+    {"clock_getres", iFip, vdso_clock_getres},
+};
+#define VDSO_NFNC   (sizeof(vdso_fncs)/sizeof(vdso_fncs[0]))
+#define VDSO_NSYM   (1+2*VDSO_NFNC)    // null symbol, then __vdso_XXX and XXX for each function
+#define VDSO_NDYN   11
+#define VDSO_NBUCKET 7
+#define VDSO_SONAME "linux-vdso.so.1"
+#define VDSO_VERSION "LINUX_2.6"
+
+static uint32_t vdso_elfhash(const char* name)
+{
+    uint32_t h = 0;
+    while(*name) {
+        h = (h<<4) + (uint8_t)*name++;
+        uint32_t g = h&0xf0000000;
+        if(g)
+            h ^= g>>24;
+        h &= ~g;
+    }
+    return h;
+}
+
+typedef struct vdso_image_s {
+    Elf64_Ehdr      ehdr;
+    Elf64_Phdr      phdr[2];
+    Elf64_Dyn       dyn[VDSO_NDYN];
+    uint32_t        hash[2+VDSO_NBUCKET+VDSO_NSYM];
+    Elf64_Sym       sym[VDSO_NSYM];
+    Elf64_Half      versym[VDSO_NSYM];
+    struct {
+        Elf64_Verdef    def;
+        Elf64_Verdaux   aux;
+    }               verdef[2];
+    char            str[256];
+    onebridge_t     text[VDSO_NFNC] __attribute__((aligned(32)));
+} vdso_image_t;
+
+#define OFF(A)  offsetof(vdso_image_t, A)
+
+static uint32_t addStr(vdso_image_t* img, uint32_t* pos, const char* s)
+{
+    uint32_t ret = *pos;
+    strcpy(img->str+ret, s);
+    *pos += strlen(s)+1;
+    return ret;
+}
+
+uintptr_t CreateVDSO(box64context_t* context)
+{
+    if(context->vdso)
+        return context->vdso;
+    if(box64_is32bits || !BOX64ENV(vdso))
+        return 0;
+    size_t size = (sizeof(vdso_image_t)+box64_pagesize-1)&~(box64_pagesize-1);
+    vdso_image_t* img = box_mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if(img==MAP_FAILED) {
+        printf_log(LOG_INFO, "Warning, cannot allocate the emulated vDSO\n");
+        return 0;
+    }
+    memset(img, 0, size);
+    // strings
+    uint32_t strpos = 1;
+    uint32_t soname = addStr(img, &strpos, VDSO_SONAME);
+    uint32_t version = addStr(img, &strpos, VDSO_VERSION);
+    // symbols and bridges
+    char name[64];
+    for(int i=0; i<(int)VDSO_NFNC; ++i) {
+        onebridge_t* b = &img->text[i];
+        b->CC = 0xCC;
+        b->S = 'S'; b->C = 'C';
+        b->w = vdso_fncs[i].w;
+        b->f = (uintptr_t)vdso_fncs[i].f;
+        b->C3 = 0xC3;
+        b->name = vdso_fncs[i].name;
+        for(int j=0; j<2; ++j) {
+            Elf64_Sym* sym = &img->sym[1+i*2+j];
+            snprintf(name, sizeof(name), "%s%s", j?"":"__vdso_", vdso_fncs[i].name);
+            sym->st_name = addStr(img, &strpos, name);
+            sym->st_info = ELF64_ST_INFO(j?STB_WEAK:STB_GLOBAL, STT_FUNC);
+            sym->st_shndx = 1;   // anything but SHN_UNDEF
+            sym->st_value = OFF(text[i]);
+            sym->st_size = sizeof(onebridge_t);
+            img->versym[1+i*2+j] = 2;
+        }
+    }
+    // hash
+    uint32_t* bucket = &img->hash[2];
+    uint32_t* chain = &img->hash[2+VDSO_NBUCKET];
+    img->hash[0] = VDSO_NBUCKET;
+    img->hash[1] = VDSO_NSYM;
+    for(int i=VDSO_NSYM-1; i>0; --i) {
+        uint32_t h = vdso_elfhash(img->str+img->sym[i].st_name)%VDSO_NBUCKET;
+        chain[i] = bucket[h];
+        bucket[h] = i;
+    }
+    // versions: the base one, and LINUX_2.6
+    for(int i=0; i<2; ++i) {
+        Elf64_Verdef* def = &img->verdef[i].def;
+        def->vd_version = VER_DEF_CURRENT;
+        def->vd_flags = i?0:VER_FLG_BASE;
+        def->vd_ndx = i+1;
+        def->vd_cnt = 1;
+        def->vd_hash = vdso_elfhash(i?VDSO_VERSION:VDSO_SONAME);
+        def->vd_aux = offsetof(vdso_image_t, verdef[0].aux) - offsetof(vdso_image_t, verdef[0].def);
+        def->vd_next = i?0:sizeof(img->verdef[0]);
+        img->verdef[i].aux.vda_name = i?version:soname;
+    }
+    // dynamic section
+    Elf64_Dyn dyn[VDSO_NDYN] = {
+        {DT_HASH, {OFF(hash)}},
+        {DT_STRTAB, {OFF(str)}},
+        {DT_SYMTAB, {OFF(sym)}},
+        {DT_STRSZ, {strpos}},
+        {DT_SYMENT, {sizeof(Elf64_Sym)}},
+        {DT_SONAME, {soname}},
+        {DT_VERSYM, {OFF(versym)}},
+        {DT_VERDEF, {OFF(verdef)}},
+        {DT_VERDEFNUM, {2}},
+        {DT_NULL, {0}},
+        {DT_NULL, {0}},
+    };
+    memcpy(img->dyn, dyn, sizeof(dyn));
+    // program headers
+    img->phdr[0].p_type = PT_LOAD;
+    img->phdr[0].p_flags = PF_R|PF_X;
+    img->phdr[0].p_filesz = img->phdr[0].p_memsz = sizeof(vdso_image_t);
+    img->phdr[0].p_align = box64_pagesize;
+    img->phdr[1].p_type = PT_DYNAMIC;
+    img->phdr[1].p_flags = PF_R;
+    img->phdr[1].p_offset = img->phdr[1].p_vaddr = img->phdr[1].p_paddr = OFF(dyn);
+    img->phdr[1].p_filesz = img->phdr[1].p_memsz = sizeof(img->dyn);
+    img->phdr[1].p_align = 8;
+    // elf header
+    memcpy(img->ehdr.e_ident, ELFMAG, SELFMAG);
+    img->ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+    img->ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+    img->ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+    img->ehdr.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    img->ehdr.e_type = ET_DYN;
+    img->ehdr.e_machine = EM_X86_64;
+    img->ehdr.e_version = EV_CURRENT;
+    img->ehdr.e_phoff = OFF(phdr);
+    img->ehdr.e_ehsize = sizeof(Elf64_Ehdr);
+    img->ehdr.e_phentsize = sizeof(Elf64_Phdr);
+    img->ehdr.e_phnum = 2;
+
+    mprotect(img, size, PROT_READ);
+    setProtection_mmap((uintptr_t)img, size, PROT_READ|PROT_EXEC);
+    context->vdso = (uintptr_t)img;
+    printf_log(LOG_DEBUG, "Emulated vDSO created at %p\n", img);
+    return context->vdso;
+}
@@ -70,6 +70,9 @@
 #include "wine_tools.h"
 #include "pe_tools.h"
 #include "cleanup.h"
+#ifdef DYNAREC
+#include "dynablock.h"
+#endif
 #ifndef LOG_INFO
 #define LOG_INFO 1
 #endif
@@ -3753,6 +3756,10 @@ EXPORT int my_clone(x64emu_t* emu, void* fn, void* stack, int flags, void* args,
     arg->tls = tls;
     arg->emu = newemu;
     arg->flags = flags;
+    #ifdef DYNAREC
+    if(flags&CLONE_VM)
+        DynablockGoMultithread();
+    #endif
     if((flags|(CLONE_VM|CLONE_VFORK|CLONE_SETTLS))==flags)   // that's difficult to setup, so lets ignore all those flags :S
         flags&=~(CLONE_VM|CLONE_VFORK|CLONE_SETTLS);
     int64_t ret = clone(clone_fn, (void*)((uintptr_t)mystack+1024*1024), flags, arg, parent, NULL, child);
@@ -3,6 +3,7 @@
 #include <string.h>
 #define _GNU_SOURCE         /* See feature_test_macros(7) */
 #include <dlfcn.h>
+#include <pthread.h>
 
 #include "wrappedlibs.h"
 
@@ -39,15 +40,19 @@ typedef void (*vFppi_t)(void*, void*, int);
 typedef void*(*pFp_t)(void*);
 typedef void (*debugProc_t)(int32_t, int32_t, uint32_t, int32_t, int32_t, void*, void*);
 
+KHASH_MAP_INIT_STR(glproccache, void*)
+
 typedef struct gl_wrappers_s {
     glprocaddress_t      procaddress;
     kh_symbolmap_t      *glwrappers;    // the map of wrapper for glProcs (for GLX or SDL1/2)
     kh_symbolmap_t      *glmymap;       // link to the mysymbolmap of libGL
+    kh_glproccache_t    *cache;         // name -> final (bridged) address already returned for this procaddress
 } gl_wrappers_t;
 
 KHASH_MAP_INIT_INT64(gl_wrappers, gl_wrappers_t*)
 
 static kh_gl_wrappers_t *gl_wrappers = NULL;
+static pthread_mutex_t gl_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 #define SUPER() \
 GO(0)   \
@@ -463,15 +468,19 @@ gl_wrappers_t* getGLProcWrapper(box64context_t* context, glprocaddress_t procadd
 {
     int cnt, ret;
     khint_t k;
+    pthread_mutex_lock(&gl_cache_mutex);
     if(!gl_wrappers) {
         gl_wrappers = kh_init(gl_wrappers);
     }
     k = kh_put(gl_wrappers, gl_wrappers, (uintptr_t)procaddress, &ret);
-    if(!ret)
+    if(!ret) {
+        pthread_mutex_unlock(&gl_cache_mutex);
         return kh_value(gl_wrappers, k);
+    }
     gl_wrappers_t* wrappers = kh_value(gl_wrappers, k) = (gl_wrappers_t*)calloc(1, sizeof(gl_wrappers_t));
 
     wrappers->procaddress = procaddress;
+    wrappers->cache = kh_init(glproccache);
     wrappers->glwrappers = kh_init(symbolmap);
     // populates maps...
     cnt = sizeof(libglsymbolmap)/sizeof(map_onesymbol_t);
@@ -495,8 +504,32 @@ gl_wrappers_t* getGLProcWrapper(box64context_t* context, glprocaddress_t procadd
         kh_value(wrappers->glmymap, k).w = libglmysymbolmap[i].w;
         kh_value(wrappers->glmymap, k).resolved = 0;
     }
+    pthread_mutex_unlock(&gl_cache_mutex);
     return wrappers;
 }
+
+static int getGLProcCache(gl_wrappers_t* wrappers, const char* rname, void** ret)
+{
+    pthread_mutex_lock(&gl_cache_mutex);
+    khint_t k = kh_get(glproccache, wrappers->cache, rname);
+    int found = (k!=kh_end(wrappers->cache));
+    if(found)
+        *ret = kh_value(wrappers->cache, k);
+    pthread_mutex_unlock(&gl_cache_mutex);
+    return found;
+}
+
+static void* setGLProcCache(gl_wrappers_t* wrappers, const char* rname, void* addr)
+{
+    int ret;
+    pthread_mutex_lock(&gl_cache_mutex);
+    khint_t k = kh_put(glproccache, wrappers->cache, rname, &ret);
+    if(ret)
+        kh_key(wrappers->cache, k) = box_strdup(rname);
+    kh_value(wrappers->cache, k) = addr;
+    pthread_mutex_unlock(&gl_cache_mutex);
+    return addr;
+}
 void freeGLProcWrapper(box64context_t* context)
 {
     if(!context)
@@ -509,8 +542,14 @@ void freeGLProcWrapper(box64context_t* context)
             kh_destroy(symbolmap, wrappers->glwrappers);
         if(wrappers->glmymap)
             kh_destroy(symbolmap, wrappers->glmymap);
+        if(wrappers->cache) {
+            const char* name;
+            kh_foreach_key(wrappers->cache, name, box_free((void*)name));
+            kh_destroy(glproccache, wrappers->cache);
+        }
         wrappers->glwrappers = NULL;
         wrappers->glmymap = NULL;
+        wrappers->cache = NULL;
     );
     kh_destroy(gl_wrappers, gl_wrappers);
     gl_wrappers = NULL;
@@ -521,6 +560,12 @@ void* getGLProcAddress(x64emu_t* emu, glprocaddress_t procaddr, const char* rnam
     khint_t k;
     printf_dlsym(LOG_DEBUG, "Calling getGLProcAddress[%p](\"%s\") => ", procaddr, rname);
     gl_wrappers_t* wrappers = getGLProcWrapper(emu->context, procaddr);
+    // engines query the same names many times (per context, per thread...): answer from the cache
+    void* cached;
+    if(getGLProcCache(wrappers, rname, &cached)) {
+        printf_dlsym_prefix(0, LOG_DEBUG, "%p (cached)\n", cached);
+        return cached;
+    }
     // check if glxprocaddress is filled, and search for lib and fill it if needed
     // get proc adress using actual glXGetProcAddress
     k = kh_get(symbolmap, wrappers->glmymap, rname);
@@ -552,7 +597,7 @@ void* getGLProcAddress(x64emu_t* emu, glprocaddress_t procaddr, const char* rnam
     uintptr_t ret = CheckBridged(emu->context->system, symbol);
     if(ret) {
         printf_dlsym_prefix(0, LOG_DEBUG, "%p\n", (void*)ret);
-        return (void*)ret; // already bridged
+        return setGLProcCache(wrappers, rname, (void*)ret); // already bridged
     }
     // get wrapper
     k = kh_get(symbolmap, wrappers->glwrappers, rname);
@@ -573,7 +618,7 @@ void* getGLProcAddress(x64emu_t* emu, glprocaddress_t procaddr, const char* rnam
     if(k==kh_end(wrappers->glwrappers)) {
         printf_dlsym_prefix(0, LOG_DEBUG, "%p\n", NULL);
         printf_dlsym_prefix(2, LOG_INFO, "Warning, no wrapper for %s\n", rname);
-        return NULL;
+        return setGLProcCache(wrappers, rname, NULL);   // wrappers are static, this will not change
     }
     symbol1_t* s = &kh_value(wrappers->glwrappers, k);
     if(!s->resolved) {
@@ -584,5 +629,5 @@ void* getGLProcAddress(x64emu_t* emu, glprocaddress_t procaddr, const char* rnam
     }
     ret = s->addr;
     printf_dlsym_prefix(0, LOG_DEBUG, "%p\n", (void*)ret);
-    return (void*)ret;
+    return setGLProcCache(wrappers, rname, (void*)ret);
 }
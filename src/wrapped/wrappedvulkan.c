@@ -3,6 +3,7 @@
 #include <string.h>
 #define _GNU_SOURCE         /* See feature_test_macros(7) */
 #include <dlfcn.h>
+#include <pthread.h>
 
 #include "wrappedlibs.h"
 
@@ -84,6 +85,64 @@ static void* resolveSymbol(x64emu_t* emu, void* symbol, const char* rname)
     return ret;
 }
 
+// Device functions depend on the device, so they are cached per device.
+// All the names asked are also kept, to resolve them in bulk when a new device is created
+KHASH_MAP_INIT_STR(vkproccache, void*)
+KHASH_MAP_INIT_INT64(vkdevcache, kh_vkproccache_t*)
+static kh_vkdevcache_t* vk_devcache = NULL;
+static kh_vkproccache_t* vk_devnames = NULL;
+static pthread_mutex_t vk_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int getDeviceProcCache(void* device, const char* rname, void** ret)
+{
+    int found = 0;
+    pthread_mutex_lock(&vk_cache_mutex);
+    khint_t k = vk_devcache?kh_get(vkdevcache, vk_devcache, (uintptr_t)device):0;
+    if(vk_devcache && k!=kh_end(vk_devcache)) {
+        kh_vkproccache_t* cache = kh_value(vk_devcache, k);
+        k = kh_get(vkproccache, cache, rname);
+        if(k!=kh_end(cache)) {
+            *ret = kh_value(cache, k);
+            found = 1;
+        }
+    }
+    pthread_mutex_unlock(&vk_cache_mutex);
+    return found;
+}
+
+static void* setDeviceProcCache(void* device, const char* rname, void* addr)
+{
+    int ret;
+    pthread_mutex_lock(&vk_cache_mutex);
+    if(!vk_devcache) {
+        vk_devcache = kh_init(vkdevcache);
+        vk_devnames = kh_init(vkproccache);
+    }
+    khint_t k = kh_put(vkproccache, vk_devnames, rname, &ret);
+    if(ret)
+        kh_key(vk_devnames, k) = box_strdup(rname);
+    const char* name = kh_key(vk_devnames, k);
+    k = kh_put(vkdevcache, vk_devcache, (uintptr_t)device, &ret);
+    if(ret)
+        kh_value(vk_devcache, k) = kh_init(vkproccache);
+    kh_vkproccache_t* cache = kh_value(vk_devcache, k);
+    k = kh_put(vkproccache, cache, name, &ret);    // key is owned by vk_devnames
+    kh_value(cache, k) = addr;
+    pthread_mutex_unlock(&vk_cache_mutex);
+    return addr;
+}
+
+static void freeDeviceProcCache(void* device)
+{
+    pthread_mutex_lock(&vk_cache_mutex);
+    khint_t k = vk_devcache?kh_get(vkdevcache, vk_devcache, (uintptr_t)device):0;
+    if(vk_devcache && k!=kh_end(vk_devcache)) {
+        kh_destroy(vkproccache, kh_value(vk_devcache, k));
+        kh_del(vkdevcache, vk_devcache, k);
+    }
+    pthread_mutex_unlock(&vk_cache_mutex);
+}
+
 EXPORT void* my_vkGetDeviceProcAddr(x64emu_t* emu, void* device, void* name)
 {
     khint_t k;
@@ -92,15 +151,11 @@ EXPORT void* my_vkGetDeviceProcAddr(x64emu_t* emu, void* device, void* name)
     printf_dlsym(LOG_DEBUG, "Calling my_vkGetDeviceProcAddr(%p, \"%s\") => ", device, rname);
     if(!emu->context->vkwrappers)
         fillVulkanProcWrapper(emu->context);
-    // not caching Device functions
-    /*
-    symbol1_t* s = getWrappedSymbol(emu, rname, 0);
-    if(s && s->resolved) {
-        void* ret = (void*)s->addr;
-        printf_dlsym_prefix(0, LOG_DEBUG, "%p (cached)\n", ret);
-        return ret;
+    void* cached;
+    if(getDeviceProcCache(device, rname, &cached)) {
+        printf_dlsym_prefix(0, LOG_DEBUG, "%p (cached)\n", cached);
+        return cached;
     }
-    */
     k = kh_get(symbolmap, emu->context->vkmymap, rname);
     int is_my = (k==kh_end(emu->context->vkmymap))?0:1;
     void* symbol = my->vkGetDeviceProcAddr(device, name);
@@ -117,9 +172,28 @@ EXPORT void* my_vkGetDeviceProcAddr(x64emu_t* emu, void* device, void* name)
     }
     if(!symbol) {
         printf_dlsym_prefix(0, LOG_DEBUG, "%p\n", NULL);
-        return NULL;    // easy
+        return setDeviceProcCache(device, rname, NULL);    // easy
     }
-    return resolveSymbol(emu, symbol, rname);
+    return setDeviceProcCache(device, rname, resolveSymbol(emu, symbol, rname));
+}
+
+// engines query the same set of functions for each device: resolve all the names already seen on other devices
+static void preResolveDeviceProcs(x64emu_t* emu, void* device)
+{
+    pthread_mutex_lock(&vk_cache_mutex);
+    int cnt = 0;
+    const char** names = (vk_devnames && kh_size(vk_devnames))?box_malloc(kh_size(vk_devnames)*sizeof(char*)):NULL;
+    if(names) {
+        const char* name;
+        kh_foreach_key(vk_devnames, name, names[cnt++] = name);
+    }
+    pthread_mutex_unlock(&vk_cache_mutex);
+    if(!names)
+        return;
+    printf_dlsym(LOG_DEBUG, "Pre-resolving %d device functions for device %p\n", cnt, device);
+    for(int i=0; i<cnt; ++i)
+        my_vkGetDeviceProcAddr(emu, device, (void*)names[i]);
+    box_free(names);
 }
 
 EXPORT void* my_vkGetInstanceProcAddr(x64emu_t* emu, void* instance, void* name)
@@ -472,6 +546,18 @@ void freeVulkanProcWrapper(box64context_t* context)
         kh_destroy(symbolmap, context->vkmymap);
     context->vkwrappers = NULL;
     context->vkmymap = NULL;
+    pthread_mutex_lock(&vk_cache_mutex);
+    if(vk_devcache) {
+        kh_vkproccache_t* cache;
+        kh_foreach_value(vk_devcache, cache, kh_destroy(vkproccache, cache));
+        kh_destroy(vkdevcache, vk_devcache);
+        const char* name;
+        kh_foreach_key(vk_devnames, name, box_free((void*)name));
+        kh_destroy(vkproccache, vk_devnames);
+        vk_devcache = NULL;
+        vk_devnames = NULL;
+    }
+    pthread_mutex_unlock(&vk_cache_mutex);
 }
 
 my_VkAllocationCallbacks_t* find_VkAllocationCallbacks(my_VkAllocationCallbacks_t* dest, my_VkAllocationCallbacks_t* src)
@@ -521,7 +607,15 @@ CREATE(vkCreateDescriptorPool)
 CREATE(vkCreateDescriptorSetLayout)
 CREATE(vkCreateDescriptorUpdateTemplate)
 CREATE(vkCreateDescriptorUpdateTemplateKHR)
-CREATE(vkCreateDevice)
+
+EXPORT int my_vkCreateDevice(x64emu_t* emu, void* physical, void* pCreateInfo, my_VkAllocationCallbacks_t* pAllocator, void* pDevice)
+{
+    my_VkAllocationCallbacks_t my_alloc;
+    int ret = my->vkCreateDevice(physical, pCreateInfo, find_VkAllocationCallbacks(&my_alloc, pAllocator), pDevice);
+    if(!ret)
+        preResolveDeviceProcs(emu, *(void**)pDevice);
+    return ret;
+}
 
 EXPORT int my_vkCreateDisplayModeKHR(x64emu_t* emu, void* physical, uint64_t display, void* pCreateInfo, my_VkAllocationCallbacks_t* pAllocator, void* pMode)
 {
@@ -661,6 +755,7 @@ EXPORT void my_vkDestroyDevice(x64emu_t* emu, void* pDevice, my_VkAllocationCall
 {
     my_VkAllocationCallbacks_t my_alloc;
     my->vkDestroyDevice(pDevice, find_VkAllocationCallbacks(&my_alloc, pAllocator));
+    freeDeviceProcCache(pDevice);   // the handle can be reused by another device
 }
 
 DESTROY64(vkDestroyEvent)